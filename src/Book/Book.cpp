@@ -24,6 +24,7 @@
 #undef byte
 #include <vector>
 
+#include "../Ratings/Ratings.h"
 #include "../Utils/FormatAux.h"
 
 using json = nlohmann::json;
@@ -35,7 +36,49 @@ using namespace tabulate;
  * @param dataManager Uma referência ao gerenciador de dados.
  */
 Book::Book(const std::string& isbn, DataManager& dataManager)
-    : isbn(isbn), dataManager(dataManager) {}
+    : isbn(isbn),
+      year(0),
+      rating(0.0f),
+      ratingCount(0),
+      dataManager(dataManager) {}
+
+/**
+ * @brief Construtor a partir de uma linha do catálogo binário.
+ * @param view A linha do catálogo.
+ * @param dataManager Uma referência ao gerenciador de dados.
+ */
+Book::Book(const BookView& view, DataManager& dataManager)
+    : isbn(view.isbn()),
+      title(view.title()),
+      author(view.author()),
+      year(view.year()),
+      publisher(view.publisher()),
+      genre(view.genre()),
+      description(view.description()),
+      rating(0.0f),
+      ratingCount(0),
+      dataManager(dataManager),
+      createdDate(view.createdDate()) {
+  for (std::string_view tag : view.tagNames()) tags.emplace_back(tag);
+}
+
+/**
+ * @brief Extrai o ano de uma data em texto a partir do primeiro dígito.
+ * @param date A data em texto.
+ * @return O ano, ou 0 se não houver dígitos.
+ */
+int Book::parseYear(const std::string& date) {
+  for (char c : date) {
+    if (isdigit(static_cast<unsigned char>(c))) {
+      try {
+        return std::stoi(date.substr(date.find(c)));
+      } catch (const std::exception&) {
+        return 0;
+      }
+    }
+  }
+  return 0;
+}
 
 // --- Getters & Setters ---
 
@@ -59,6 +102,17 @@ void Book::setDescription(const std::string& description) {
 }
 float Book::getRating() const { return this->rating; }
 void Book::setRating(float rating) { this->rating = rating; }
+std::uint64_t Book::getRatingCount() const { return this->ratingCount; }
+
+/**
+ * @brief Lê o agregado das notas do livro (O(1), ver Ratings).
+ */
+void Book::loadRating() {
+  Ratings::Summary summary =
+      Ratings::forBooks(dataManager).summary(this->isbn);
+  this->rating = static_cast<float>(summary.average());
+  this->ratingCount = summary.count;
+}
 
 /**
  * @brief Verifica se um livro com o ISBN atual existe no arquivo.
@@ -72,23 +126,24 @@ bool Book::exists() { return dataManager.has(this->isbn); }
  * @note Requer C++20 para std::views::split.
  */
 bool Book::load() {
-  json data = dataManager.load(this->isbn);
+  if (!fromJson(dataManager.load(this->isbn))) return false;
+  loadRating();
+  return true;
+}
+
+/**
+ * @brief Preenche os campos do livro a partir do seu json.
+ * @param data O json do livro.
+ * @return false se o json estiver vazio, true caso contrário.
+ */
+bool Book::fromJson(const json& data) {
   if (data.is_null() || data.empty()) return false;
   this->title = data.value("title", "");
   this->author = data.value("author", "");
   this->publisher = data.value("publisher", "");
   this->description = data.value("description", "");
   this->genre = data.value("genre", "");
-  this->year = 0;
-  std::string date = data.value("date", "");
-  if (!date.empty()) {
-    for (char c : date) {
-      if (isdigit(c)) {
-        this->year = std::stoi(date.substr(date.find(c)));
-        break;
-      }
-    }
-  }
+  this->year = parseYear(data.value("date", ""));
   this->createdDate = data.value("createdDate", "");
   // Carrega as tags
   tags.clear();
@@ -105,22 +160,25 @@ bool Book::load() {
   return true;
 }
 
+json Book::toJson() const {
+  // Salva as tags como array
+  return {{"title", this->title},
+          {"author", this->author},
+          {"date", std::to_string(this->year)},
+          {"createdDate", this->createdDate},
+          {"publisher", this->publisher},
+          {"description", this->description},
+          {"genre", this->genre},
+          {"tags", this->tags}};
+}
+
 /**
  * @brief Salva os dados do livro no arquivo de forma segura.
  * @return true se a operação foi bem-sucedida, false caso contrário.
  */
 bool Book::save() {
-  json allBooks = dataManager.load("");
-  // Salva as tags como array
-  allBooks[this->isbn] = {{"title", this->title},
-                          {"author", this->author},
-                          {"date", std::to_string(this->year)},
-                          {"createdDate", this->createdDate},
-                          {"publisher", this->publisher},
-                          {"description", this->description},
-                          {"genre", this->genre},
-                          {"tags", this->tags}};
-  return dataManager.save(allBooks);
+  // Apenas o registro deste livro vai para o journal
+  return dataManager.put(this->isbn, toJson());
 }
 
 /**
@@ -155,19 +213,54 @@ bool Book::removeTag(string& tag) {
 }
 
 bool Book::display() {
+  json book = toJson();
+  book["isbn"] = this->isbn;
+  book["rating"] = this->rating;
+  book["ratings"] = this->ratingCount;
+  return display(book);
+}
+
+bool Book::display(const json& book) {
   FormatAux formatAux = FormatAux();
+  auto text = [&book](const char* key) {
+    auto it = book.find(key);
+    return it != book.end() && it->is_string() ? it->get<std::string>()
+                                               : std::string();
+  };
+  vector<string> tags;
+  auto tagsIt = book.find("tags");
+  if (tagsIt != book.end() && tagsIt->is_array()) {
+    for (const auto& tag : *tagsIt) {
+      if (tag.is_string()) tags.push_back(tag.get<std::string>());
+    }
+  }
+  auto ratingIt = book.find("rating");
+  double ratingValue =
+      ratingIt != book.end() && ratingIt->is_number() ? ratingIt->get<double>()
+                                                      : 0.0;
+  auto countIt = book.find("ratings");
+  std::uint64_t ratingCount = countIt != book.end() &&
+                                      countIt->is_number_unsigned()
+                                  ? countIt->get<std::uint64_t>()
+                                  : 0;
 
   Table details;
   details.add_row({"Campo", "Valor"});
-  details.add_row({"ISBN", this->getIsbn()});
-  details.add_row({"Título", this->getTitle()});
-  details.add_row({"Autor", this->getAuthor()});
-  details.add_row({"Ano de Publicação", to_string(this->getYear())});
-  details.add_row({"Editora", this->getPublisher()});
-  details.add_row({"Tags", formatAux.join(this->getTags())});
+  details.add_row({"ISBN", text("isbn")});
+  details.add_row({"Título", text("title")});
+  details.add_row({"Autor", text("author")});
+  details.add_row({"Ano de Publicação", to_string(parseYear(text("date")))});
+  details.add_row({"Editora", text("publisher")});
+  details.add_row({"Tags", formatAux.join(tags)});
   stringstream rating;
-  rating << fixed << setprecision(1) << this->getRating() << "/5.0";
+  rating << fixed << setprecision(1) << ratingValue << "/5.0 ("
+         << ratingCount << (ratingCount == 1 ? " avaliação)" : " avaliações)");
   details.add_row({"Avaliação", rating.str()});
+  auto userRatingIt = book.find("userRating");
+  if (userRatingIt != book.end() && userRatingIt->is_number_integer()) {
+    details.add_row({"Sua avaliação",
+                     to_string(userRatingIt->get<int>()) + "/5"});
+  }
 
   // Formatação
   details.column(0)
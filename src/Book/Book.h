@@ -12,9 +12,11 @@
 #ifndef BOOK_H
 #define BOOK_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include "../DataManager/DataManager.h"
+#include "../Catalog/BinaryCatalog.h"
 
 using namespace std;
 
@@ -33,9 +35,22 @@ private:
     std::string description;
     vector<string> tags;
     float rating;
+    std::uint64_t ratingCount;
     DataManager &dataManager;
     std::string createdDate;
 
+    /**
+     * @brief Preenche os campos a partir do json de um livro.
+     * @return false se o json estiver vazio.
+     */
+    bool fromJson(const json& data);
+
+    /**
+     * @brief Preenche a nota média e a quantidade de avaliações a partir do
+     * agregado do livro (ver Ratings), sem percorrer as notas.
+     */
+    void loadRating();
+
 public:
     /**
      * @brief Construtor para um objeto Book.
@@ -44,6 +59,28 @@ public:
      */
     Book(const std::string& isbn, DataManager& dataManager);
 
+    /**
+     * @brief Construtor a partir de uma linha do catálogo binário, sem
+     * precisar consultar o json.
+     * @param view A linha do catálogo.
+     * @param dataManager Uma referência ao gerenciador de dados para persistência.
+     */
+    Book(const BookView& view, DataManager& dataManager);
+
+    /**
+     * @brief Extrai o ano de uma data em texto, a partir do primeiro dígito
+     * encontrado (ex: "2019-05-01" ou "May 2019").
+     * @param date A data em texto.
+     * @return O ano, ou 0 se não houver dígitos.
+     */
+    static int parseYear(const std::string& date);
+
+    /**
+     * @brief Converte o livro para o mesmo formato em que é salvo.
+     * @return O json do livro (sem o ISBN, que é a chave no arquivo).
+     */
+    json toJson() const;
+
     /**
      * @brief Salva os dados do livro no arquivo.
      * @return true se a operação foi bem-sucedida, false caso contrário.
@@ -85,6 +122,7 @@ public:
     void setDescription(const std::string& description);
     float getRating() const;
     void setRating(float rating);
+    std::uint64_t getRatingCount() const;
     bool setTags(vector<string> tags);
     vector<string> getTags();
     bool addTag(string &tag);
@@ -92,6 +130,15 @@ public:
     string getCreatedDate();
     bool setCreatedDate();
     bool display();
+
+    /**
+     * @brief Exibe os detalhes de um livro a partir do seu json (o formato de
+     * toJson() mais os campos "isbn", "rating", "ratings" e, opcionalmente,
+     * "userRating"), ex: recebido do servidor.
+     * @param book O json do livro.
+     * @return true.
+     */
+    static bool display(const json& book);
 };
 
 #endif // BOOK_H
@@ -0,0 +1,647 @@
+/**
+ * @file: BinaryCatalog.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do catálogo binário colunar.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "BinaryCatalog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../Book/Book.h"
+
+namespace {
+
+constexpr char MAGIC[8] = {'B', 'M', 'C', 'A', 'T', 'L', 'G', '1'};
+constexpr std::uint32_t VERSION = 3;
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * @brief Converte uma data ISO 8601 ("YYYY-MM-DD[THH:MM:SS...]") em segundos
+ * desde a época.
+ * @return Os segundos, ou 0 se a data não puder ser interpretada.
+ */
+std::int64_t parseIsoEpoch(std::string_view date) {
+  auto number = [&date](std::size_t pos, std::size_t len, int& out) {
+    if (pos + len > date.size()) return false;
+    out = 0;
+    for (std::size_t i = pos; i < pos + len; ++i) {
+      if (date[i] < '0' || date[i] > '9') return false;
+      out = out * 10 + (date[i] - '0');
+    }
+    return true;
+  };
+  int y, m, d;
+  if (!number(0, 4, y) || !number(5, 2, m) || !number(8, 2, d)) return 0;
+  std::chrono::year_month_day ymd{std::chrono::year{y},
+                                  std::chrono::month{static_cast<unsigned>(m)},
+                                  std::chrono::day{static_cast<unsigned>(d)}};
+  if (!ymd.ok()) return 0;
+  std::int64_t seconds =
+      std::chrono::sys_days{ymd}.time_since_epoch() / std::chrono::seconds(1);
+  int hh, mm, ss;
+  if (date.size() > 10 && number(11, 2, hh) && number(14, 2, mm) &&
+      number(17, 2, ss)) {
+    seconds += hh * 3600 + mm * 60 + ss;
+  }
+  return seconds;
+}
+
+std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t(7); }
+
+/**
+ * @brief Hash FNV-1a de um ISBN, usado na tabela ISBN -> linha.
+ */
+std::uint64_t hashIsbn(std::string_view isbn) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : isbn) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+}  // namespace
+
+/**
+ * @brief Cabeçalho do arquivo. Todos os offsets são relativos ao início do
+ * arquivo e alinhados em 8 bytes.
+ */
+struct BinaryCatalog::Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint64_t fingerprint;
+  std::uint64_t bookCount;
+  std::uint64_t tagCount;
+  std::uint64_t tagRefCount;
+  std::uint64_t tagSetRefCount;
+  std::uint64_t fieldOffsets[FIELD_COUNT];  // uint64[bookCount + 1] cada
+  std::uint64_t yearsOffset;                // int32[bookCount]
+  std::uint64_t createdOffset;              // int64[bookCount]
+  std::uint64_t tagRangesOffset;            // uint32[bookCount + 1]
+  std::uint64_t tagIdsOffset;               // uint32[tagRefCount]
+  std::uint64_t tagNamesOffset;             // uint64[tagCount + 1]
+  std::uint64_t tagSetRangesOffset;         // uint32[bookCount + 1]
+  std::uint64_t tagSetIdsOffset;            // uint32[tagSetRefCount]
+  std::uint64_t postingRangesOffset;        // uint32[tagCount + 1]
+  std::uint64_t postingRowsOffset;          // uint32[tagSetRefCount]
+  std::uint64_t hashSlots;                  // Potência de 2
+  std::uint64_t hashOffset;                 // uint32[hashSlots]
+  std::uint64_t poolOffset;
+  std::uint64_t poolSize;
+};
+
+/**
+ * @brief Serializa o catálogo no formato binário.
+ * @param books Os livros, em ordem de ISBN e sem ISBNs repetidos.
+ * @param fingerprint Impressão digital da origem.
+ * @return Os bytes do arquivo.
+ */
+std::string BinaryCatalog::serialize(const std::vector<CatalogRecord>& books,
+                                     std::uint64_t fingerprint) {
+  const std::size_t n = books.size();
+
+  // Pool de strings: cada campo ocupa um trecho contíguo, de forma que uma
+  // tabela de N+1 offsets basta para delimitar cada valor
+  std::string pool;
+  std::vector<std::uint64_t> columnOffsets[FIELD_COUNT];
+  static std::string CatalogRecord::* const members[FIELD_COUNT] = {
+      &CatalogRecord::isbn,      &CatalogRecord::title,
+      &CatalogRecord::author,    &CatalogRecord::publisher,
+      &CatalogRecord::genre,     &CatalogRecord::description,
+      &CatalogRecord::createdDate};
+  for (std::uint32_t f = 0; f < FIELD_COUNT; ++f) {
+    columnOffsets[f].reserve(n + 1);
+    for (const CatalogRecord& book : books) {
+      columnOffsets[f].push_back(pool.size());
+      pool += book.*members[f];
+    }
+    columnOffsets[f].push_back(pool.size());
+  }
+
+  std::vector<std::int32_t> yearColumn;
+  std::vector<std::int64_t> created;
+  std::vector<std::uint32_t> tagRangeColumn{0};
+  std::vector<std::uint32_t> tagIdColumn;
+  std::unordered_map<std::string, std::uint32_t> tagDictionary;
+  std::vector<std::string> tagNames;
+  yearColumn.reserve(n);
+  created.reserve(n);
+  tagRangeColumn.reserve(n + 1);
+
+  for (const CatalogRecord& book : books) {
+    yearColumn.push_back(Book::parseYear(book.date));
+    created.push_back(parseIsoEpoch(book.createdDate));
+    for (const std::string& tag : book.tags) {
+      auto [it, inserted] = tagDictionary.try_emplace(
+          tag, static_cast<std::uint32_t>(tagNames.size()));
+      if (inserted) tagNames.push_back(tag);
+      tagIdColumn.push_back(it->second);
+    }
+    tagRangeColumn.push_back(static_cast<std::uint32_t>(tagIdColumn.size()));
+  }
+
+  // Conjunto de tags de cada livro (IDs ordenados, sem repetições e sem a
+  // tag vazia) e, a partir dele, a lista de linhas de cada tag. Como as
+  // linhas são percorridas em ordem, as listas já saem ordenadas
+  std::vector<std::uint32_t> tagSetRangeColumn{0};
+  std::vector<std::uint32_t> tagSetColumn;
+  std::vector<std::uint32_t> postingCounts(tagNames.size(), 0);
+  tagSetRangeColumn.reserve(n + 1);
+  tagSetColumn.reserve(tagIdColumn.size());
+  for (std::size_t row = 0; row < n; ++row) {
+    const std::size_t first = tagSetColumn.size();
+    for (std::uint32_t i = tagRangeColumn[row]; i < tagRangeColumn[row + 1];
+         ++i) {
+      if (!tagNames[tagIdColumn[i]].empty()) {
+        tagSetColumn.push_back(tagIdColumn[i]);
+      }
+    }
+    std::sort(tagSetColumn.begin() + first, tagSetColumn.end());
+    tagSetColumn.erase(std::unique(tagSetColumn.begin() + first,
+                                   tagSetColumn.end()),
+                       tagSetColumn.end());
+    for (std::size_t i = first; i < tagSetColumn.size(); ++i) {
+      ++postingCounts[tagSetColumn[i]];
+    }
+    tagSetRangeColumn.push_back(static_cast<std::uint32_t>(tagSetColumn.size()));
+  }
+  std::vector<std::uint32_t> postingRangeColumn(tagNames.size() + 1, 0);
+  for (std::size_t tag = 0; tag < tagNames.size(); ++tag) {
+    postingRangeColumn[tag + 1] = postingRangeColumn[tag] + postingCounts[tag];
+  }
+  std::vector<std::uint32_t> postingRowColumn(tagSetColumn.size());
+  std::vector<std::uint32_t> postingFill(postingRangeColumn.begin(),
+                                         postingRangeColumn.end() - 1);
+  for (std::size_t row = 0; row < n; ++row) {
+    for (std::uint32_t i = tagSetRangeColumn[row];
+         i < tagSetRangeColumn[row + 1]; ++i) {
+      postingRowColumn[postingFill[tagSetColumn[i]]++] =
+          static_cast<std::uint32_t>(row);
+    }
+  }
+
+  // Tabela ISBN -> linha com endereçamento aberto (sondagem linear), com
+  // ocupação de no máximo 50%; cada posição guarda linha + 1 (0 = vazia)
+  std::size_t hashSlots = 8;
+  while (hashSlots < 2 * n) hashSlots *= 2;
+  std::vector<std::uint32_t> hashColumn(hashSlots, 0);
+  for (std::size_t row = 0; row < n; ++row) {
+    std::size_t slot = hashIsbn(books[row].isbn) & (hashSlots - 1);
+    while (hashColumn[slot] != 0) slot = (slot + 1) & (hashSlots - 1);
+    hashColumn[slot] = static_cast<std::uint32_t>(row + 1);
+  }
+
+  std::vector<std::uint64_t> tagNameOffsets;
+  tagNameOffsets.reserve(tagNames.size() + 1);
+  for (const auto& name : tagNames) {
+    tagNameOffsets.push_back(pool.size());
+    pool += name;
+  }
+  tagNameOffsets.push_back(pool.size());
+
+  // Layout das seções
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byteOrder = BYTE_ORDER_MARK;
+  header.fingerprint = fingerprint;
+  header.bookCount = n;
+  header.tagCount = tagNames.size();
+  header.tagRefCount = tagIdColumn.size();
+  header.tagSetRefCount = tagSetColumn.size();
+
+  std::size_t offset = align8(sizeof(header));
+  auto reserveSection = [&offset](std::size_t bytes) {
+    std::size_t start = offset;
+    offset = align8(offset + bytes);
+    return start;
+  };
+  for (std::uint32_t f = 0; f < FIELD_COUNT; ++f) {
+    header.fieldOffsets[f] =
+        reserveSection(columnOffsets[f].size() * sizeof(std::uint64_t));
+  }
+  header.yearsOffset = reserveSection(yearColumn.size() * sizeof(std::int32_t));
+  header.createdOffset = reserveSection(created.size() * sizeof(std::int64_t));
+  header.tagRangesOffset =
+      reserveSection(tagRangeColumn.size() * sizeof(std::uint32_t));
+  header.tagIdsOffset = reserveSection(tagIdColumn.size() * sizeof(std::uint32_t));
+  header.tagNamesOffset =
+      reserveSection(tagNameOffsets.size() * sizeof(std::uint64_t));
+  header.tagSetRangesOffset =
+      reserveSection(tagSetRangeColumn.size() * sizeof(std::uint32_t));
+  header.tagSetIdsOffset =
+      reserveSection(tagSetColumn.size() * sizeof(std::uint32_t));
+  header.postingRangesOffset =
+      reserveSection(postingRangeColumn.size() * sizeof(std::uint32_t));
+  header.postingRowsOffset =
+      reserveSection(postingRowColumn.size() * sizeof(std::uint32_t));
+  header.hashSlots = hashSlots;
+  header.hashOffset = reserveSection(hashSlots * sizeof(std::uint32_t));
+  header.poolOffset = reserveSection(pool.size());
+  header.poolSize = pool.size();
+
+  std::string bytes(offset, '\0');
+  auto put = [&bytes](std::size_t at, const void* data, std::size_t size) {
+    if (size > 0) std::memcpy(bytes.data() + at, data, size);
+  };
+  put(0, &header, sizeof(header));
+  for (std::uint32_t f = 0; f < FIELD_COUNT; ++f) {
+    put(header.fieldOffsets[f], columnOffsets[f].data(),
+        columnOffsets[f].size() * sizeof(std::uint64_t));
+  }
+  put(header.yearsOffset, yearColumn.data(), yearColumn.size() * sizeof(std::int32_t));
+  put(header.createdOffset, created.data(),
+      created.size() * sizeof(std::int64_t));
+  put(header.tagRangesOffset, tagRangeColumn.data(),
+      tagRangeColumn.size() * sizeof(std::uint32_t));
+  put(header.tagIdsOffset, tagIdColumn.data(), tagIdColumn.size() * sizeof(std::uint32_t));
+  put(header.tagNamesOffset, tagNameOffsets.data(),
+      tagNameOffsets.size() * sizeof(std::uint64_t));
+  put(header.tagSetRangesOffset, tagSetRangeColumn.data(),
+      tagSetRangeColumn.size() * sizeof(std::uint32_t));
+  put(header.tagSetIdsOffset, tagSetColumn.data(),
+      tagSetColumn.size() * sizeof(std::uint32_t));
+  put(header.postingRangesOffset, postingRangeColumn.data(),
+      postingRangeColumn.size() * sizeof(std::uint32_t));
+  put(header.postingRowsOffset, postingRowColumn.data(),
+      postingRowColumn.size() * sizeof(std::uint32_t));
+  put(header.hashOffset, hashColumn.data(),
+      hashColumn.size() * sizeof(std::uint32_t));
+  put(header.poolOffset, pool.data(), pool.size());
+  return bytes;
+}
+
+// --- BookView ---
+
+BookView::BookView(const BinaryCatalog& catalog, std::size_t row)
+    : catalog(&catalog), row(row) {}
+
+std::size_t BookView::getRow() const { return row; }
+std::string_view BookView::isbn() const {
+  return catalog->field(BinaryCatalog::ISBN, row);
+}
+std::string_view BookView::title() const {
+  return catalog->field(BinaryCatalog::TITLE, row);
+}
+std::string_view BookView::author() const {
+  return catalog->field(BinaryCatalog::AUTHOR, row);
+}
+std::string_view BookView::publisher() const {
+  return catalog->field(BinaryCatalog::PUBLISHER, row);
+}
+std::string_view BookView::genre() const {
+  return catalog->field(BinaryCatalog::GENRE, row);
+}
+std::string_view BookView::description() const {
+  return catalog->field(BinaryCatalog::DESCRIPTION, row);
+}
+std::string_view BookView::createdDate() const {
+  return catalog->field(BinaryCatalog::CREATED_DATE, row);
+}
+int BookView::year() const { return catalog->year(row); }
+std::int64_t BookView::createdEpoch() const {
+  return catalog->createdEpoch(row);
+}
+std::span<const std::uint32_t> BookView::tagIds() const {
+  return catalog->tagIds(row);
+}
+std::span<const std::uint32_t> BookView::tagSet() const {
+  return catalog->tagSet(row);
+}
+std::vector<std::string_view> BookView::tagNames() const {
+  std::vector<std::string_view> names;
+  for (std::uint32_t id : tagIds()) names.push_back(catalog->tagName(id));
+  return names;
+}
+
+// --- BinaryCatalog ---
+
+BinaryCatalog::~BinaryCatalog() {
+#ifndef _WIN32
+  if (mapped && base) munmap(const_cast<char*>(base), length);
+#endif
+}
+
+/**
+ * @brief Lê o catálogo em streaming: os livros do snapshot em disco, com as
+ * mudanças do journal por cima.
+ */
+bool BinaryCatalog::readRecords(DataManager& booksDataManager,
+                                std::vector<CatalogRecord>& books) {
+  books.clear();
+  bool ok = true;
+  std::map<std::string, std::optional<json>> changes =
+      booksDataManager.readStreaming([&](std::istream& in) {
+        // Um arquivo vazio (ainda sem nenhum livro) não é erro
+        if (in.peek() == std::char_traits<char>::eof()) return;
+        std::string error;
+        auto collect = [&books](CatalogRecord& book) {
+          books.push_back(std::move(book));
+        };
+        ok = CatalogReader::readJson(in, collect, error);
+        if (!ok) std::cerr << "Erro ao ler catálogo: " << error << std::endl;
+      });
+  // Os livros alterados depois do snapshot são trocados pela versão final
+  std::erase_if(books, [&changes](const CatalogRecord& book) {
+    return changes.count(book.isbn) > 0;
+  });
+  for (const auto& [isbn, book] : changes) {
+    if (book) books.push_back(CatalogReader::fromJson(isbn, *book));
+  }
+
+  // Mesma ordem do json (por ISBN); com chaves repetidas vale a última
+  std::stable_sort(books.begin(), books.end(),
+                   [](const CatalogRecord& a, const CatalogRecord& b) {
+                     return a.isbn < b.isbn;
+                   });
+  auto out = books.begin();
+  for (auto it = books.begin(); it != books.end();) {
+    auto next = it + 1;
+    while (next != books.end() && next->isbn == it->isbn) ++next;
+    if (out != next - 1) *out = std::move(*(next - 1));
+    ++out;
+    it = next;
+  }
+  books.erase(out, books.end());
+  return ok;
+}
+
+/**
+ * @brief Converte o catálogo para o formato binário (tmp + rename).
+ */
+bool BinaryCatalog::write(const std::vector<CatalogRecord>& books,
+                          const std::string& path, std::uint64_t fingerprint) {
+  std::string bytes = serialize(books, fingerprint);
+  std::string tempPath = path + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out) return false;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    std::cerr << "Erro ao salvar catálogo binário: " << ec.message()
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Mapeia o arquivo em memória e valida o seu conteúdo.
+ * @return true se o arquivo é um catálogo válido, false caso contrário.
+ */
+bool BinaryCatalog::map(const std::string& path) {
+#ifndef _WIN32
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+    ::close(fd);
+    return false;
+  }
+  length = static_cast<std::size_t>(st.st_size);
+  void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) return false;
+  base = static_cast<const char*>(addr);
+  mapped = true;
+#else
+  // Sem mmap: o arquivo é lido de uma vez para um buffer alinhado
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return false;
+  length = static_cast<std::size_t>(in.tellg());
+  if (length < sizeof(Header)) return false;
+  buffer.resize(length);
+  in.seekg(0);
+  in.read(buffer.data(), static_cast<std::streamsize>(length));
+  if (!in) return false;
+  base = buffer.data();
+#endif
+  return bind();
+}
+
+/**
+ * @brief Valida o cabeçalho e as seções da região [base, base + length) e
+ * aponta as colunas para elas.
+ * @return true se a região contém um catálogo válido, false caso contrário.
+ */
+bool BinaryCatalog::bind() {
+  if (length < sizeof(Header)) return false;
+  Header header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version != VERSION || header.byteOrder != BYTE_ORDER_MARK) {
+    return false;
+  }
+  auto inBounds = [this](std::uint64_t offset, std::uint64_t count,
+                         std::uint64_t size) {
+    return offset % 8 == 0 && offset <= length &&
+           count <= (length - offset) / size;
+  };
+  const std::uint64_t n = header.bookCount;
+  for (std::uint32_t f = 0; f < FIELD_COUNT; ++f) {
+    if (!inBounds(header.fieldOffsets[f], n + 1, sizeof(std::uint64_t))) {
+      return false;
+    }
+  }
+  if (!inBounds(header.yearsOffset, n, sizeof(std::int32_t)) ||
+      !inBounds(header.createdOffset, n, sizeof(std::int64_t)) ||
+      !inBounds(header.tagRangesOffset, n + 1, sizeof(std::uint32_t)) ||
+      !inBounds(header.tagIdsOffset, header.tagRefCount,
+                sizeof(std::uint32_t)) ||
+      !inBounds(header.tagNamesOffset, header.tagCount + 1,
+                sizeof(std::uint64_t)) ||
+      !inBounds(header.tagSetRangesOffset, n + 1, sizeof(std::uint32_t)) ||
+      !inBounds(header.tagSetIdsOffset, header.tagSetRefCount,
+                sizeof(std::uint32_t)) ||
+      !inBounds(header.postingRangesOffset, header.tagCount + 1,
+                sizeof(std::uint32_t)) ||
+      !inBounds(header.postingRowsOffset, header.tagSetRefCount,
+                sizeof(std::uint32_t)) ||
+      header.hashSlots == 0 || (header.hashSlots & (header.hashSlots - 1)) ||
+      header.hashSlots <= n ||
+      !inBounds(header.hashOffset, header.hashSlots, sizeof(std::uint32_t)) ||
+      !inBounds(header.poolOffset, header.poolSize, 1)) {
+    return false;
+  }
+
+  fingerprint = header.fingerprint;
+  bookCount = n;
+  tags = header.tagCount;
+  for (std::uint32_t f = 0; f < FIELD_COUNT; ++f) {
+    fieldOffsets[f] =
+        reinterpret_cast<const std::uint64_t*>(base + header.fieldOffsets[f]);
+  }
+  years = reinterpret_cast<const std::int32_t*>(base + header.yearsOffset);
+  createdEpochs =
+      reinterpret_cast<const std::int64_t*>(base + header.createdOffset);
+  tagRanges =
+      reinterpret_cast<const std::uint32_t*>(base + header.tagRangesOffset);
+  tagIdList = reinterpret_cast<const std::uint32_t*>(base + header.tagIdsOffset);
+  tagNameOffsets =
+      reinterpret_cast<const std::uint64_t*>(base + header.tagNamesOffset);
+  tagSetRanges =
+      reinterpret_cast<const std::uint32_t*>(base + header.tagSetRangesOffset);
+  tagSetIdList =
+      reinterpret_cast<const std::uint32_t*>(base + header.tagSetIdsOffset);
+  postingRanges =
+      reinterpret_cast<const std::uint32_t*>(base + header.postingRangesOffset);
+  postingRowList =
+      reinterpret_cast<const std::uint32_t*>(base + header.postingRowsOffset);
+  hashSlots = header.hashSlots;
+  hashTable = reinterpret_cast<const std::uint32_t*>(base + header.hashOffset);
+  pool = base + header.poolOffset;
+  poolSize = header.poolSize;
+
+  // Os offsets das strings precisam cair dentro do pool
+  for (std::uint32_t f = 0; f < FIELD_COUNT; ++f) {
+    if (fieldOffsets[f][n] > poolSize) return false;
+  }
+  return tagNameOffsets[tags] <= poolSize &&
+         tagRanges[n] <= header.tagRefCount &&
+         tagSetRanges[n] <= header.tagSetRefCount &&
+         postingRanges[tags] <= header.tagSetRefCount;
+}
+
+/**
+ * @brief Mapeia um arquivo binário em memória.
+ */
+std::shared_ptr<const BinaryCatalog> BinaryCatalog::open(
+    const std::string& path) {
+  std::shared_ptr<BinaryCatalog> catalog(new BinaryCatalog());
+  if (!catalog->map(path)) return nullptr;
+  return catalog;
+}
+
+std::string BinaryCatalog::pathFor(const DataManager& booksDataManager) {
+  std::filesystem::path path(booksDataManager.getFullPath());
+  path.replace_extension(".bin");
+  return path.string();
+}
+
+/**
+ * @brief Abre o catálogo binário de um DataManager, reconstruindo-o a partir do
+ * json quando a impressão digital gravada não bate com a atual.
+ */
+std::shared_ptr<const BinaryCatalog> BinaryCatalog::openFor(
+    DataManager& booksDataManager) {
+  static std::mutex cacheMutex;
+  static std::unordered_map<std::string, std::shared_ptr<const BinaryCatalog>>
+      opened;
+
+  const std::string path = pathFor(booksDataManager);
+  // A impressão digital é lida antes do snapshot: se o json mudar no meio,
+  // o arquivo gerado fica marcado como antigo e é refeito na próxima vez
+  const std::uint64_t current = booksDataManager.fingerprint();
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto& cached = opened[path];
+  if (cached && cached->getFingerprint() == current) return cached;
+
+  std::shared_ptr<const BinaryCatalog> catalog = open(path);
+  if (catalog && catalog->getFingerprint() == current) {
+    cached = catalog;
+    return cached;
+  }
+
+  // Lido em streaming, sem montar o json do catálogo em memória
+  std::vector<CatalogRecord> books;
+  readRecords(booksDataManager, books);
+  if (write(books, path, current)) catalog = open(path);
+  if (!catalog) {
+    // Sem permissão de escrita: mantém a versão binária apenas em memória
+    std::shared_ptr<BinaryCatalog> inMemory(new BinaryCatalog());
+    std::string bytes = serialize(books, current);
+    inMemory->buffer.assign(bytes.begin(), bytes.end());
+    inMemory->base = inMemory->buffer.data();
+    inMemory->length = inMemory->buffer.size();
+    if (inMemory->bind()) catalog = inMemory;
+  }
+  if (!catalog) {
+    std::shared_ptr<BinaryCatalog> emptyCatalog(new BinaryCatalog());
+    catalog = emptyCatalog;
+  }
+  cached = catalog;
+  return cached;
+}
+
+std::size_t BinaryCatalog::size() const { return bookCount; }
+bool BinaryCatalog::empty() const { return bookCount == 0; }
+std::uint64_t BinaryCatalog::getFingerprint() const { return fingerprint; }
+
+BookView BinaryCatalog::at(std::size_t row) const { return BookView(*this, row); }
+
+std::optional<std::size_t> BinaryCatalog::find(std::string_view isbn) const {
+  // A tabela tem sempre posições vazias (ocupação <= 50%), então a sondagem
+  // termina; o limite de passos só protege contra um arquivo adulterado
+  const std::size_t mask = hashSlots - 1;
+  std::size_t slot = hashIsbn(isbn) & mask;
+  for (std::size_t probe = 0; probe < hashSlots; ++probe) {
+    std::uint32_t entry = hashTable[slot];
+    if (entry == 0) return std::nullopt;
+    std::size_t row = entry - 1;
+    if (row < bookCount && field(ISBN, row) == isbn) return row;
+    slot = (slot + 1) & mask;
+  }
+  return std::nullopt;
+}
+
+std::string_view BinaryCatalog::field(Field field, std::size_t row) const {
+  const std::uint64_t* offsets = fieldOffsets[field];
+  return std::string_view(pool + offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+int BinaryCatalog::year(std::size_t row) const { return years[row]; }
+
+std::int64_t BinaryCatalog::createdEpoch(std::size_t row) const {
+  return createdEpochs[row];
+}
+
+std::span<const std::uint32_t> BinaryCatalog::tagIds(std::size_t row) const {
+  return std::span<const std::uint32_t>(tagIdList + tagRanges[row],
+                                        tagRanges[row + 1] - tagRanges[row]);
+}
+
+std::span<const std::uint32_t> BinaryCatalog::tagSet(std::size_t row) const {
+  return std::span<const std::uint32_t>(
+      tagSetIdList + tagSetRanges[row], tagSetRanges[row + 1] - tagSetRanges[row]);
+}
+
+std::span<const std::uint32_t> BinaryCatalog::tagPostings(
+    std::uint32_t tagId) const {
+  return std::span<const std::uint32_t>(
+      postingRowList + postingRanges[tagId],
+      postingRanges[tagId + 1] - postingRanges[tagId]);
+}
+
+std::size_t BinaryCatalog::tagCount() const { return tags; }
+
+std::string_view BinaryCatalog::tagName(std::uint32_t tagId) const {
+  return std::string_view(pool + tagNameOffsets[tagId],
+                          tagNameOffsets[tagId + 1] - tagNameOffsets[tagId]);
+}
@@ -0,0 +1,220 @@
+/**
+ * @file: BinaryCatalog.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do catálogo binário colunar (books.bin), lido via
+ * mmap sem cópias.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef BINARY_CATALOG_H
+#define BINARY_CATALOG_H
+
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../DataManager/DataManager.h"
+#include "CatalogReader.h"
+
+using json = nlohmann::json;
+
+class BinaryCatalog;
+
+/**
+ * @class BookView
+ * @brief Visão somente leitura de uma linha do catálogo binário. As strings
+ * apontam diretamente para o arquivo mapeado em memória.
+ * @note Válida enquanto o BinaryCatalog de origem estiver vivo.
+ */
+class BookView {
+ private:
+  const BinaryCatalog* catalog;
+  std::size_t row;
+
+ public:
+  BookView(const BinaryCatalog& catalog, std::size_t row);
+
+  std::size_t getRow() const;
+  std::string_view isbn() const;
+  std::string_view title() const;
+  std::string_view author() const;
+  std::string_view publisher() const;
+  std::string_view genre() const;
+  std::string_view description() const;
+  std::string_view createdDate() const;
+  int year() const;
+
+  /**
+   * @brief Data de cadastro em segundos desde a época (0 se inválida).
+   */
+  std::int64_t createdEpoch() const;
+
+  /**
+   * @brief IDs das tags do livro, na ordem original.
+   */
+  std::span<const std::uint32_t> tagIds() const;
+
+  /**
+   * @brief IDs distintos das tags não vazias do livro, em ordem crescente.
+   */
+  std::span<const std::uint32_t> tagSet() const;
+
+  /**
+   * @brief Nomes das tags do livro, na ordem original.
+   */
+  std::vector<std::string_view> tagNames() const;
+};
+
+/**
+ * @class BinaryCatalog
+ * @brief Catálogo de livros em formato binário colunar: um pool de strings,
+ * tabelas de offsets por campo, IDs de tags e ano/data de cadastro como
+ * inteiros. O arquivo é mapeado em memória (mmap) e lido sem parse.
+ *
+ * As tags são internadas em um dicionário (nome -> ID). Além da lista
+ * original de cada livro, o arquivo guarda o conjunto ordenado de IDs de cada
+ * livro e, para cada tag, a lista ordenada das linhas que a possuem, de forma
+ * que os livros de uma tag são obtidos sem percorrer o catálogo.
+ *
+ * As linhas ficam na mesma ordem do books.json (ordenadas por ISBN). O
+ * arquivo também traz uma tabela hash ISBN -> linha (endereçamento aberto),
+ * de forma que find() custa O(1) e toca poucas páginas do arquivo.
+ */
+class BinaryCatalog {
+ public:
+  /**
+   * @brief Campos de texto armazenados no pool de strings.
+   */
+  enum Field : std::uint32_t {
+    ISBN,
+    TITLE,
+    AUTHOR,
+    PUBLISHER,
+    GENRE,
+    DESCRIPTION,
+    CREATED_DATE,
+    FIELD_COUNT
+  };
+
+  ~BinaryCatalog();
+  BinaryCatalog(const BinaryCatalog&) = delete;
+  BinaryCatalog& operator=(const BinaryCatalog&) = delete;
+
+  /**
+   * @brief Lê os livros de um catálogo json (snapshot + journal) em
+   * streaming, sem montar o json em memória: o pico de memória fica próximo
+   * do tamanho dos próprios livros.
+   * @param booksDataManager Gerenciador de dados dos livros.
+   * @param books Saída, em ordem de ISBN e sem ISBNs repetidos.
+   * @return false se o snapshot não pôde ser lido até o fim (os livros lidos
+   * até o erro são mantidos).
+   */
+  static bool readRecords(DataManager& booksDataManager,
+                          std::vector<CatalogRecord>& books);
+
+  /**
+   * @brief Converte os livros para o formato binário, usando escrita atômica.
+   * @param books Os livros, em ordem de ISBN e sem ISBNs repetidos (ver
+   * readRecords).
+   * @param path O caminho do arquivo binário de saída.
+   * @param fingerprint Impressão digital da origem (ver DataManager::fingerprint).
+   * @return true se o arquivo foi escrito com sucesso, false caso contrário.
+   */
+  static bool write(const std::vector<CatalogRecord>& books,
+                    const std::string& path, std::uint64_t fingerprint);
+
+  /**
+   * @brief Mapeia um arquivo binário em memória.
+   * @param path O caminho do arquivo.
+   * @return O catálogo, ou nullptr se o arquivo não existe ou é inválido.
+   */
+  static std::shared_ptr<const BinaryCatalog> open(const std::string& path);
+
+  /**
+   * @brief Abre o catálogo binário derivado de um DataManager (arquivo com
+   * extensão ".bin" ao lado do json), reconstruindo-o se estiver ausente ou
+   * desatualizado em relação ao json + journal.
+   * @param booksDataManager Gerenciador de dados dos livros.
+   * @return O catálogo (nunca nullptr; vazio se não for possível gerá-lo).
+   */
+  static std::shared_ptr<const BinaryCatalog> openFor(
+      DataManager& booksDataManager);
+
+  /**
+   * @brief Caminho do catálogo binário associado a um DataManager.
+   */
+  static std::string pathFor(const DataManager& booksDataManager);
+
+  std::size_t size() const;
+  bool empty() const;
+  std::uint64_t getFingerprint() const;
+
+  BookView at(std::size_t row) const;
+
+  /**
+   * @brief Procura um livro pelo ISBN (tabela hash).
+   * @return A linha do livro, ou std::nullopt se não existir.
+   */
+  std::optional<std::size_t> find(std::string_view isbn) const;
+
+  std::string_view field(Field field, std::size_t row) const;
+  int year(std::size_t row) const;
+  std::int64_t createdEpoch(std::size_t row) const;
+  std::span<const std::uint32_t> tagIds(std::size_t row) const;
+
+  /**
+   * @brief IDs distintos das tags não vazias de um livro, em ordem crescente.
+   */
+  std::span<const std::uint32_t> tagSet(std::size_t row) const;
+
+  /**
+   * @brief Linhas dos livros que possuem uma tag, em ordem crescente.
+   */
+  std::span<const std::uint32_t> tagPostings(std::uint32_t tagId) const;
+
+  std::size_t tagCount() const;
+  std::string_view tagName(std::uint32_t tagId) const;
+
+ private:
+  struct Header;
+
+  BinaryCatalog() = default;
+  static std::string serialize(const std::vector<CatalogRecord>& books,
+                               std::uint64_t fingerprint);
+  bool map(const std::string& path);
+  bool bind();
+
+  const char* base = nullptr;
+  std::size_t length = 0;
+  std::vector<char> buffer;  // Usado quando mmap não está disponível
+  bool mapped = false;
+
+  std::uint64_t fingerprint = 0;
+  std::size_t bookCount = 0;
+  std::size_t tags = 0;
+  const std::uint64_t* fieldOffsets[FIELD_COUNT] = {};
+  const std::int32_t* years = nullptr;
+  const std::int64_t* createdEpochs = nullptr;
+  const std::uint32_t* tagRanges = nullptr;
+  const std::uint32_t* tagIdList = nullptr;
+  const std::uint64_t* tagNameOffsets = nullptr;
+  const std::uint32_t* tagSetRanges = nullptr;
+  const std::uint32_t* tagSetIdList = nullptr;
+  const std::uint32_t* postingRanges = nullptr;
+  const std::uint32_t* postingRowList = nullptr;
+  std::size_t hashSlots = 0;
+  const std::uint32_t* hashTable = nullptr;
+  const char* pool = nullptr;
+  std::size_t poolSize = 0;
+};
+
+#endif  // BINARY_CATALOG_H
@@ -0,0 +1,214 @@
+/**
+ * @file: CatalogReader.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do leitor de catálogos em streaming.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "CatalogReader.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace {
+
+/**
+ * @class RecordHandler
+ * @brief Handler SAX que monta um CatalogRecord por vez. A profundidade
+ * indica onde o parser está: os campos do livro ficam em recordDepth (2
+ * dentro de um catálogo, 1 em uma linha de JSON Lines), e a lista de tags
+ * logo abaixo. Todo o resto (inclusive objetos e listas desconhecidos) é
+ * ignorado.
+ */
+class RecordHandler : public json::json_sax_t {
+ public:
+  RecordHandler(const CatalogReader::Visitor& visit, bool singleRecord)
+      : visit(visit), recordDepth(singleRecord ? 1 : 2) {}
+
+  std::string error;
+
+  bool null() override { return true; }
+  bool boolean(bool) override { return true; }
+  bool number_integer(number_integer_t value) override {
+    return scalar(std::to_string(value));
+  }
+  bool number_unsigned(number_unsigned_t value) override {
+    return scalar(std::to_string(value));
+  }
+  bool number_float(number_float_t, const string_t& text) override {
+    return scalar(text);
+  }
+  bool binary(binary_t&) override { return true; }
+
+  bool string(string_t& value) override {
+    if (inTags && depth == recordDepth + 1) {
+      record.tags.push_back(std::move(value));
+      return true;
+    }
+    return scalar(std::move(value));
+  }
+
+  bool start_object(std::size_t) override {
+    ++depth;
+    if (depth == recordDepth) {
+      record = CatalogRecord();
+      if (recordDepth == 2) record.isbn = topKey;
+    }
+    return true;
+  }
+
+  bool key(string_t& name) override {
+    if (depth == recordDepth) {
+      field = std::move(name);
+    } else if (depth == 1) {
+      topKey = std::move(name);  // ISBN no formato {isbn: {...}}
+    }
+    return true;
+  }
+
+  bool end_object() override {
+    if (depth == recordDepth) visit(record);
+    --depth;
+    return true;
+  }
+
+  bool start_array(std::size_t) override {
+    ++depth;
+    if (depth == recordDepth + 1 && field == "tags") inTags = true;
+    return true;
+  }
+
+  bool end_array() override {
+    if (depth == recordDepth + 1) inTags = false;
+    --depth;
+    return true;
+  }
+
+  bool parse_error(std::size_t position, const std::string&,
+                   const nlohmann::detail::exception& e) override {
+    error = "posição " + std::to_string(position) + ": " + e.what();
+    return false;
+  }
+
+ private:
+  const CatalogReader::Visitor& visit;
+  const int recordDepth;
+  int depth = 0;
+  bool inTags = false;
+  std::string topKey;
+  std::string field;
+  CatalogRecord record;
+
+  /**
+   * @brief Guarda um valor simples no campo atual do livro.
+   */
+  bool scalar(std::string value) {
+    if (depth != recordDepth) return true;
+    if (field == "isbn") {
+      // No formato {isbn: {...}} a chave do objeto é que vale
+      if (recordDepth == 1 || record.isbn.empty()) {
+        record.isbn = std::move(value);
+      }
+    } else if (field == "title") {
+      record.title = std::move(value);
+    } else if (field == "author") {
+      record.author = std::move(value);
+    } else if (field == "date") {
+      record.date = std::move(value);
+    } else if (field == "createdDate") {
+      record.createdDate = std::move(value);
+    } else if (field == "publisher") {
+      record.publisher = std::move(value);
+    } else if (field == "description") {
+      record.description = std::move(value);
+    } else if (field == "genre") {
+      record.genre = std::move(value);
+    } else if (field == "tags") {
+      // Formato do scraper: as tags como um texto só
+      record.tags.clear();
+      if (!value.empty()) record.tags.push_back(std::move(value));
+    }
+    return true;
+  }
+};
+
+}  // namespace
+
+bool CatalogReader::readJson(std::istream& in, const Visitor& visit,
+                             std::string& error) {
+  RecordHandler handler(visit, false);
+  if (!json::sax_parse(in, &handler)) {
+    error = handler.error;
+    return false;
+  }
+  return true;
+}
+
+bool CatalogReader::readJsonLines(std::istream& in, const Visitor& visit,
+                                  std::string& error) {
+  std::string line;
+  std::size_t number = 0;
+  while (std::getline(in, line)) {
+    ++number;
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+    RecordHandler handler(visit, true);
+    if (!json::sax_parse(line, &handler)) {
+      error = "linha " + std::to_string(number) + ", " + handler.error;
+      return false;
+    }
+  }
+  return true;
+}
+
+CatalogRecord CatalogReader::fromJson(const std::string& isbn,
+                                      const json& book) {
+  CatalogRecord record;
+  record.isbn = isbn;
+  if (!book.is_object()) return record;
+  // Mesmo tratamento do SAX: números viram texto, o resto é ignorado
+  auto text = [&book](const char* key) {
+    auto it = book.find(key);
+    if (it == book.end()) return std::string();
+    if (it->is_string()) return it->get<std::string>();
+    if (it->is_number()) return it->dump();
+    return std::string();
+  };
+  record.title = text("title");
+  record.author = text("author");
+  record.date = text("date");
+  record.createdDate = text("createdDate");
+  record.publisher = text("publisher");
+  record.description = text("description");
+  record.genre = text("genre");
+  auto tags = book.find("tags");
+  if (tags != book.end()) {
+    if (tags->is_array()) {
+      for (const auto& tag : *tags) {
+        if (tag.is_string()) record.tags.push_back(tag.get<std::string>());
+      }
+    } else if (tags->is_string() && !tags->get<std::string>().empty()) {
+      record.tags.push_back(tags->get<std::string>());
+    }
+  }
+  return record;
+}
+
+bool CatalogReader::readFile(const std::string& path, const Visitor& visit,
+                             std::string& error) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) {
+    error = "não foi possível abrir '" + path + "'";
+    return false;
+  }
+  std::string extension = std::filesystem::path(path).extension().string();
+  if (extension == ".jsonl" || extension == ".ndjson") {
+    return readJsonLines(in, visit, error);
+  }
+  return readJson(in, visit, error);
+}
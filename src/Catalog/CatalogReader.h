@@ -0,0 +1,101 @@
+/**
+ * @file: CatalogReader.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do leitor de catálogos em streaming (SAX), usado
+ * para importar livros sem montar o json inteiro em memória.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef CATALOG_READER_H
+#define CATALOG_READER_H
+
+#include <functional>
+#include <istream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+/**
+ * @brief Um livro lido do catálogo, com os campos como aparecem no arquivo
+ * (a data ainda não foi normalizada).
+ */
+struct CatalogRecord {
+  std::string isbn;
+  std::string title;
+  std::string author;
+  std::string date;
+  std::string createdDate;
+  std::string publisher;
+  std::string description;
+  std::string genre;
+  std::vector<std::string> tags;
+};
+
+/**
+ * @class CatalogReader
+ * @brief Lê catálogos com o parser SAX do nlohmann::json: cada livro é
+ * entregue assim que termina de ser lido, de forma que a memória usada não
+ * depende do tamanho do arquivo.
+ *
+ * Formatos aceitos:
+ * - JSON: o formato do books.json e do BookScraper.py ({isbn: {...}}), ou
+ *   uma lista de livros com o campo "isbn" ([{"isbn": ...}, ...]).
+ * - JSON Lines (.jsonl ou .ndjson): um livro por linha, com o campo "isbn".
+ *
+ * Campos desconhecidos são ignorados; números viram texto (ex: "date": 1999)
+ * e "tags" pode ser uma lista ou um texto só.
+ */
+class CatalogReader {
+ public:
+  /**
+   * @brief Recebe cada livro lido (pode mover os campos).
+   */
+  using Visitor = std::function<void(CatalogRecord&)>;
+
+  /**
+   * @brief Lê um catálogo em JSON.
+   * @param in A entrada.
+   * @param visit Chamado para cada livro.
+   * @param error Mensagem de erro, se a leitura falhar.
+   * @return true se o arquivo foi lido até o fim.
+   */
+  static bool readJson(std::istream& in, const Visitor& visit,
+                       std::string& error);
+
+  /**
+   * @brief Lê um catálogo em JSON Lines (linhas vazias são ignoradas).
+   * @param in A entrada.
+   * @param visit Chamado para cada livro.
+   * @param error Mensagem de erro (com o número da linha), se a leitura falhar.
+   * @return true se o arquivo foi lido até o fim.
+   */
+  static bool readJsonLines(std::istream& in, const Visitor& visit,
+                            std::string& error);
+
+  /**
+   * @brief Converte um livro já em json (ex: um registro do journal) com as
+   * mesmas regras da leitura em streaming.
+   * @param isbn O ISBN (chave do livro no catálogo).
+   * @param book O json do livro.
+   * @return O livro.
+   */
+  static CatalogRecord fromJson(const std::string& isbn, const json& book);
+
+  /**
+   * @brief Lê um arquivo, escolhendo o formato pela extensão.
+   * @param path O caminho do arquivo.
+   * @param visit Chamado para cada livro.
+   * @param error Mensagem de erro, se a leitura falhar.
+   * @return true se o arquivo foi lido até o fim.
+   */
+  static bool readFile(const std::string& path, const Visitor& visit,
+                       std::string& error);
+};
+
+#endif  // CATALOG_READER_H
@@ -10,12 +10,459 @@
 */
 
 #include "DataManager.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <fstream>
+#include <list>
+#include <map>
+#include <mutex>
 #include <nlohmann/json.hpp>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+// Sem NOMINMAX, as macros min e max do windows.h quebram std::min/std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
 
 using json = nlohmann::json;
 
+namespace {
+
+/**
+ * @brief "Assinatura" de um arquivo em disco (mtime + tamanho), usada para
+ * detectar se ele mudou desde a última leitura.
+ */
+struct FileStamp {
+    bool exists = false;
+    std::filesystem::file_time_type mtime{};
+    std::uintmax_t size = 0;
+
+    bool operator==(const FileStamp&) const = default;
+};
+
+FileStamp stampOf(const std::string& path) {
+    FileStamp stamp;
+    std::error_code ec;
+    stamp.mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return FileStamp{};
+    stamp.size = std::filesystem::file_size(path, ec);
+    if (ec) return FileStamp{};
+    stamp.exists = true;
+    return stamp;
+}
+
+/**
+ * @brief Descarta uma linha incompleta no fim de um arquivo de linhas (queda
+ * no meio de uma escrita), cortando-o logo depois do último '\n'. Sem isso,
+ * a próxima linha acrescentada seria emendada na incompleta, e as duas se
+ * perderiam na leitura.
+ */
+void trimTornTail(const std::string& path) {
+    std::error_code ec;
+    const std::uintmax_t size = std::filesystem::file_size(path, ec);
+    if (ec || size == 0) return;
+    std::ifstream file(path, std::ios::binary);
+    char buffer[4096];
+    std::uintmax_t end = size;  // Tudo a partir daqui não tem '\n'
+    while (end > 0) {
+        const std::uintmax_t chunk =
+            std::min<std::uintmax_t>(end, sizeof(buffer));
+        file.seekg(static_cast<std::streamoff>(end - chunk));
+        if (!file.read(buffer, static_cast<std::streamsize>(chunk))) return;
+        std::uintmax_t i = chunk;
+        while (i > 0 && buffer[i - 1] != '\n') --i;
+        if (i > 0) {
+            end = end - chunk + i;
+            break;
+        }
+        end -= chunk;
+    }
+    if (end == size) return;  // Já termina com '\n'
+    file.close();
+    std::cerr << "Descartando registro incompleto no fim de " << path
+              << std::endl;
+    std::filesystem::resize_file(path, end, ec);
+}
+
+/**
+ * @brief Acrescenta linhas ao final de um arquivo e força a gravação em disco
+ * (fsync) antes de retornar. Uma linha incompleta deixada no fim por uma
+ * queda é descartada antes.
+ */
+bool appendDurably(const std::string& path, const std::string& bytes) {
+    trimTornTail(path);
+#ifdef _WIN32
+    int fd = _open(path.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+    if (fd < 0) return false;
+    bool ok = _write(fd, bytes.data(), static_cast<unsigned>(bytes.size())) ==
+              static_cast<int>(bytes.size());
+    ok = ok && _commit(fd) == 0;
+    _close(fd);
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) return false;
+    bool ok = ::write(fd, bytes.data(), bytes.size()) ==
+              static_cast<ssize_t>(bytes.size());
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+#endif
+    return ok;
+}
+
+/**
+ * @brief Força a gravação em disco de um arquivo já escrito.
+ */
+bool syncFile(const std::string& path) {
+#ifdef _WIN32
+    int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) return false;
+    bool ok = _commit(fd) == 0;
+    _close(fd);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+#endif
+    return ok;
+}
+
+/**
+ * @brief Força a gravação em disco da entrada de diretório de um arquivo
+ * (ex: depois de um rename). No Windows não há equivalente e nada é feito.
+ */
+bool syncDirectory(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    return true;
+#else
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+/**
+ * @brief Trava consultiva entre processos sobre o arquivo "<arquivo>.lock"
+ * (flock no POSIX, LockFileEx no Windows), liberada no destrutor.
+ *
+ * Dentro do processo o acesso já é serializado pelo mutex do cache, então a
+ * trava é reentrante: se o processo já a possui (held == true), o objeto não
+ * faz nada. Se o arquivo de trava não puder ser criado (ex: diretório só de
+ * leitura), segue sem trava.
+ */
+class FileLock {
+ public:
+    FileLock(int& fd, bool& held, const std::string& path, bool exclusive) {
+        if (held) return;
+#ifdef _WIN32
+        if (fd < 0) fd = _open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY,
+                               _S_IREAD | _S_IWRITE);
+        if (fd < 0) return;
+        HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+        OVERLAPPED overlapped{};
+        if (!LockFileEx(handle, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0, 0,
+                        MAXDWORD, MAXDWORD, &overlapped)) {
+            return;
+        }
+#else
+        if (fd < 0) fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return;
+        int result;
+        do {
+            result = ::flock(fd, exclusive ? LOCK_EX : LOCK_SH);
+        } while (result != 0 && errno == EINTR);
+        if (result != 0) return;
+#endif
+        this->fd = fd;
+        this->held = &held;
+        held = true;
+    }
+
+    ~FileLock() {
+        if (!held) return;
+#ifdef _WIN32
+        HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+        OVERLAPPED overlapped{};
+        UnlockFileEx(handle, 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+        ::flock(fd, LOCK_UN);
+#endif
+        *held = false;
+    }
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+ private:
+    int fd = -1;
+    bool* held = nullptr;  // nullptr quando a trava já era do processo
+};
+
+/**
+ * @brief Versão de um valor: hash FNV-1a do json serializado (0 se a chave
+ * não existe). Valores iguais têm a mesma versão, então uma troca A -> B -> A
+ * no meio de uma atualização não é um conflito, e sim o mesmo estado.
+ */
+std::uint64_t versionOf(const json* value) {
+    if (!value) return 0;
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : value->dump()) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash | 1;
+}
+
+/**
+ * @brief Refaz as modificações pendentes de uma chave (ver updateAsync) sobre
+ * o valor atual dela.
+ */
+void applyPending(json& data, const std::string& key,
+                  const std::vector<DataManager::Modifier>& modifiers) {
+    for (const DataManager::Modifier& modify : modifiers) {
+        auto it = data.find(key);
+        std::optional<json> next = modify(it != data.end() ? &*it : nullptr);
+        if (next) data[key] = std::move(*next);
+    }
+}
+
+/**
+ * @brief Aplica um registro do journal ({"op": "put"|"erase", "key", "value"})
+ * sobre o json em memória. Os registros são idempotentes.
+ */
+void applyRecord(json& data, const json& record) {
+    if (!record.is_object() || !record.contains("key")) return;
+    const std::string key = record["key"].get<std::string>();
+    const std::string op = record.value("op", "");
+    if (op == "put" && record.contains("value")) {
+        data[key] = record["value"];
+    } else if (op == "erase") {
+        data.erase(key);
+    }
+}
+
+/**
+ * @brief Lê os registros de um journal, na ordem em que foram gravados.
+ * Linhas ilegíveis (ex: incompletas, por uma queda no meio de uma escrita) e
+ * registros sem uma chave de texto ou com operação desconhecida são
+ * ignorados, sem descartar os que vêm depois.
+ * @param path O caminho do journal (pode não existir).
+ * @param visit Recebe a chave e o valor gravado, ou nullptr se a chave foi
+ * removida; o valor pode ser movido.
+ */
+void replayJournal(
+    const std::string& path,
+    const std::function<void(const std::string&, json*)>& visit) {
+    std::ifstream journal(path);
+    std::string line;
+    while (std::getline(journal, line)) {
+        if (line.empty()) continue;
+        json record = json::parse(line, nullptr, false);
+        if (record.is_discarded() || !record.is_object()) continue;
+        auto key = record.find("key");
+        auto op = record.find("op");
+        if (key == record.end() || !key->is_string() || op == record.end()) {
+            continue;
+        }
+        auto value = record.find("value");
+        if (*op == "put" && value != record.end()) {
+            visit(key->get_ref<const std::string&>(), &*value);
+        } else if (*op == "erase") {
+            visit(key->get_ref<const std::string&>(), nullptr);
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief Estado compartilhado por todas as instâncias que gerenciam o mesmo
+ * arquivo: o json já parseado (snapshot + journal aplicados) e as assinaturas
+ * dos dois arquivos no momento da leitura.
+ */
+struct DataManager::Cache {
+    std::mutex mutex;
+    std::shared_ptr<json> data;
+    FileStamp snapshotStamp;
+    FileStamp journalStamp;
+    std::uintmax_t journalLimit = DataManager::DEFAULT_JOURNAL_LIMIT;
+    std::uint64_t generation = 1;
+    std::vector<DataManager::ChangeListener> listeners;
+    int lockFd = -1;          // "<arquivo>.lock", aberto na primeira trava
+    bool fileLocked = false;  // Se este processo segura a trava agora
+    // Modificações feitas com updateAsync que ainda não estão no journal, na
+    // ordem em que foram feitas; são refeitas sobre cada releitura do disco
+    std::map<std::string, std::vector<DataManager::Modifier>> pending;
+
+    ~Cache() {
+#ifdef _WIN32
+        if (lockFd >= 0) _close(lockFd);
+#else
+        if (lockFd >= 0) ::close(lockFd);
+#endif
+    }
+};
+
+/**
+ * @brief Obtém (ou cria) o cache associado ao caminho completo do arquivo.
+ * Os caches ficam em ordem de uso; quando passam de MAX_CACHED_FILES, os
+ * menos recentes que só o registro usa (sem instâncias, assinantes nem
+ * mudanças pendentes) são descartados, fechando a trava aberta.
+ * @param fullPath Caminho "diretorio/nome_do_arquivo".
+ * @param create Se false, não cria um cache novo.
+ * @return O cache compartilhado, ou nullptr se não existe e create é false.
+ */
+std::shared_ptr<DataManager::Cache> DataManager::cacheFor(const std::string& fullPath,
+                                                          bool create) {
+    using Entry = std::pair<std::string, std::shared_ptr<Cache>>;
+    static std::mutex registryMutex;
+    static std::list<Entry> recent;  // Mais recente primeiro
+    static std::unordered_map<std::string, std::list<Entry>::iterator> registry;
+    // Maior geração de um cache descartado: um cache recriado começa depois
+    // dela, para que quem guardou uma geração antiga perceba a mudança
+    static std::uint64_t retiredGeneration = 0;
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    auto it = registry.find(fullPath);
+    if (it != registry.end()) {
+        recent.splice(recent.begin(), recent, it->second);
+        return it->second->second;
+    }
+    if (!create) return nullptr;
+
+    auto cache = std::make_shared<Cache>();
+    cache->generation = retiredGeneration + 1;
+    recent.emplace_front(fullPath, cache);
+    registry.emplace(fullPath, recent.begin());
+
+    auto victim = recent.end();
+    while (registry.size() > MAX_CACHED_FILES && victim != recent.begin()) {
+        --victim;
+        // Com use_count() == 1 ninguém mais alcança o cache, então a trava
+        // dele está livre
+        if (victim->second.use_count() > 1) continue;
+        {
+            std::lock_guard<std::mutex> cacheLock(victim->second->mutex);
+            if (!victim->second->listeners.empty() ||
+                !victim->second->pending.empty()) {
+                continue;
+            }
+            retiredGeneration =
+                std::max(retiredGeneration, victim->second->generation);
+        }
+        registry.erase(victim->first);
+        victim = recent.erase(victim);
+    }
+    return cache;
+}
+
+namespace {
+
+/**
+ * @class WriteBehind
+ * @brief A thread de escrita de updateAsync. Guarda uma cópia do DataManager
+ * de cada arquivo com mudanças pendentes (as cópias dividem o cache, então
+ * várias mudanças no mesmo arquivo viram um único flush()) e grava tudo a
+ * cada FLUSH_INTERVAL_MS, ou antes se as mudanças passarem de
+ * FLUSH_PENDING_KEYS. No fim do programa, o destrutor grava o que sobrou.
+ */
+class WriteBehind {
+ public:
+    static WriteBehind& instance() {
+        static WriteBehind queue;
+        return queue;
+    }
+
+    void schedule(const DataManager& dataManager) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            dirty.try_emplace(dataManager.getFullPath(), dataManager);
+            ++pendingKeys;
+        }
+        wake.notify_one();
+    }
+
+    bool flushAll() {
+        std::unordered_map<std::string, DataManager> batch;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            batch.swap(dirty);
+            pendingKeys = 0;
+        }
+        bool ok = true;
+        for (auto& [path, dataManager] : batch) {
+            if (!dataManager.flush()) {
+                // Continua pendente: tenta de novo na próxima rodada
+                std::lock_guard<std::mutex> lock(mutex);
+                dirty.try_emplace(path, dataManager);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    ~WriteBehind() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) thread.join();
+        flushAll();
+    }
+
+ private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::unordered_map<std::string, DataManager> dirty;  // Por caminho
+    std::size_t pendingKeys = 0;
+    bool stopping = false;
+    std::thread thread;
+
+    WriteBehind() : thread([this] { run(); }) {}
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopping) {
+            wake.wait(lock, [this] { return stopping || !dirty.empty(); });
+            // A primeira mudança abre uma janela em que as próximas são
+            // acumuladas, a não ser que o lote já esteja grande
+            wake.wait_for(lock,
+                          std::chrono::milliseconds(DataManager::FLUSH_INTERVAL_MS),
+                          [this] {
+                              return stopping ||
+                                     pendingKeys >= DataManager::FLUSH_PENDING_KEYS;
+                          });
+            if (stopping) break;
+            lock.unlock();
+            flushAll();
+            lock.lock();
+        }
+    }
+};
+
+}  // namespace
+
 /**
  * @brief Construtor que assume o diretório padrão "data".
  * @param filename O nome do arquivo a ser gerenciado (ex: "users.txt").
@@ -25,6 +472,7 @@ DataManager::DataManager(const std::string& filename)
     ensureDirectoryExists();
     // Garante que o arquivo exista
     std::ofstream f(getFullPath(), std::ios::app);
+    this->cache = cacheFor(getFullPath());
 }
 
 /**
@@ -36,6 +484,30 @@ DataManager::DataManager(const std::string& filename, const std::string& directo
     : directoryPath(directory), fileName(filename) {
     ensureDirectoryExists();
     std::ofstream f(getFullPath(), std::ios::app);
+    this->cache = cacheFor(getFullPath());
+}
+
+/**
+ * @brief Construtor usado por read(): não cria o diretório nem o arquivo.
+ */
+DataManager::DataManager(const std::string& filename, const std::string& directory,
+                         std::shared_ptr<Cache> cache)
+    : directoryPath(directory), fileName(filename), cache(std::move(cache)) {}
+
+/**
+ * @brief Lê um arquivo sem registrar o cache. Um cache temporário é lido como
+ * qualquer outro (com a trava compartilhada e o journal) e descartado no fim;
+ * como só os caches registrados recebem mudanças pendentes, um arquivo sem
+ * cache neste processo não tem nenhuma.
+ * @param filename O nome do arquivo.
+ * @param directory O diretório do arquivo.
+ * @return O json lido.
+ */
+json DataManager::read(const std::string& filename, const std::string& directory) {
+    std::shared_ptr<Cache> cache = cacheFor(directory + "/" + filename, false);
+    if (!cache) cache = std::make_shared<Cache>();
+    DataManager reader(filename, directory, std::move(cache));
+    return *reader.snapshot();
 }
 
 /**
@@ -44,7 +516,7 @@ DataManager::DataManager(const std::string& filename, const std::string& directo
 void DataManager::ensureDirectoryExists() {
     try {
         if (!std::filesystem::exists(this->directoryPath)) {
-            std::filesystem::create_directory(this->directoryPath);
+            std::filesystem::create_directories(this->directoryPath);
         }
     } catch (const std::filesystem::filesystem_error& e) {
         std::cerr << "Erro de Filesystem ao criar diretório: " << e.what() << std::endl;
@@ -75,56 +547,487 @@ std::string DataManager::getFullPath() const {
     return this->directoryPath + "/" + this->fileName;
 }
 
+/**
+ * @brief Obtém o caminho do journal (log de escrita) associado ao arquivo.
+ * @return Uma string contendo "diretorio/nome_do_arquivo.log".
+ */
+std::string DataManager::getJournalPath() const {
+    return getFullPath() + ".log";
+}
+
+/**
+ * @brief Obtém o caminho do arquivo usado para a trava entre processos.
+ * @return Uma string contendo "diretorio/nome_do_arquivo.lock".
+ */
+std::string DataManager::getLockPath() const {
+    return getFullPath() + ".lock";
+}
+
 /**
  * @brief Salva o objeto JSON no arquivo, usando escrita atômica para evitar corrupção de dados.
  * @param j O objeto JSON a ser salvo.
  * @return true se o salvamento foi bem-sucedido, false caso contrário.
+ * @note Como o snapshot passa a conter tudo, o journal é descartado.
  */
 bool DataManager::save(json &j) {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    FileLock fileLock(this->cache->lockFd, this->cache->fileLocked,
+                      getLockPath(), true);
+    return writeSnapshotLocked(j);
+}
+
+/**
+ * @brief Escreve o snapshot completo (tmp + fsync + rename + fsync do
+ * diretório) e descarta o journal. Deve ser chamado com o mutex do cache
+ * adquirido. Se algum fsync falha, retorna false e mantém o journal.
+ * @note Se o processo cair entre o rename e a remoção do journal, o journal
+ * antigo é reaplicado sobre o snapshot novo na próxima leitura; como put/erase
+ * são idempotentes, o resultado é o mesmo.
+ */
+bool DataManager::writeSnapshotLocked(const json& j) {
     std::string tempPath = getFullPath() + ".tmp";
     {
         std::ofstream tempFile(tempPath, std::ios::trunc);
         if (!tempFile.is_open()) return false;
         tempFile << j.dump(4);
         tempFile.close();
+        if (!tempFile) return false;
+    }
+    if (!syncFile(tempPath)) {
+        std::cerr << "Erro ao gravar " << tempPath << " em disco" << std::endl;
+        std::error_code ec;
+        std::filesystem::remove(tempPath, ec);
+        return false;
     }
     try {
         std::filesystem::rename(tempPath, getFullPath());
+        // Sem o rename em disco, o journal ainda é necessário (reaplicá-lo
+        // sobre o snapshot novo dá o mesmo resultado)
+        if (!syncDirectory(getFullPath())) {
+            std::cerr << "Erro ao gravar o diretório de " << getFullPath()
+                      << " em disco" << std::endl;
+            this->cache->data.reset();
+            return false;
+        }
+        std::filesystem::remove(getJournalPath());
     } catch (const std::filesystem::filesystem_error& e) {
         std::cerr << "Erro ao salvar JSON: " << e.what() << std::endl;
+        this->cache->data.reset();
         return false;
     }
+    // O que acabou de ser escrito vira o novo snapshot, sem reler o disco
+    if (this->cache->data.get() != &j) {
+        this->cache->data = std::make_shared<json>(j);
+        ++this->cache->generation;
+    }
+    this->cache->snapshotStamp = stampOf(getFullPath());
+    this->cache->journalStamp = FileStamp{};
+    // O snapshot novo já contém (ou substitui) as mudanças pendentes
+    this->cache->pending.clear();
+    return true;
+}
+
+/**
+ * @brief Retorna o snapshot em memória do arquivo. O arquivo só é relido e
+ * parseado novamente quando seu mtime ou tamanho mudam (ex: outro processo o
+ * alterou), de forma que consultas pontuais não tocam no disco.
+ * @return Ponteiro compartilhado para o json, ou para um objeto vazio em caso de erro.
+ */
+std::shared_ptr<const json> DataManager::snapshot() {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    return refreshLocked();
+}
+
+/**
+ * @brief Compara as assinaturas em disco com as do cache. Se algo mudou por
+ * fora (ex: outro processo), descarta o json em memória e avança a geração,
+ * sem reler o arquivo. Deve ser chamado com o mutex do cache adquirido.
+ */
+void DataManager::checkLocked() {
+    FileStamp snapshotStamp = stampOf(getFullPath());
+    FileStamp journalStamp = stampOf(getJournalPath());
+    if (this->cache->snapshotStamp == snapshotStamp &&
+        this->cache->journalStamp == journalStamp) {
+        return;
+    }
+    this->cache->data.reset();
+    this->cache->snapshotStamp = snapshotStamp;
+    this->cache->journalStamp = journalStamp;
+    ++this->cache->generation;
+}
+
+/**
+ * @brief Garante que o cache reflita o snapshot + journal em disco, relendo
+ * apenas o que mudou. Deve ser chamado com o mutex do cache adquirido.
+ * @return O json atual do cache.
+ */
+std::shared_ptr<json> DataManager::refreshLocked() {
+    checkLocked();
+    if (this->cache->data) return this->cache->data;
+
+    // Sob trava compartilhada nenhum outro processo está no meio de uma
+    // compactação; as assinaturas são refeitas para bater com o que for lido
+    FileLock fileLock(this->cache->lockFd, this->cache->fileLocked,
+                      getLockPath(), false);
+    this->cache->snapshotStamp = stampOf(getFullPath());
+    this->cache->journalStamp = stampOf(getJournalPath());
+
+    auto data = std::make_shared<json>(json::object());
+    if (this->cache->snapshotStamp.exists && this->cache->snapshotStamp.size > 0) {
+        std::ifstream file(getFullPath());
+        try {
+            file >> *data;
+        } catch (const json::parse_error& e) {
+            std::cerr << "Erro ao ler JSON: " << e.what() << std::endl;
+            *data = json::object();
+        }
+    }
+
+    // Reaplica o journal; uma linha incompleta (queda no meio de uma
+    // escrita) é ignorada, mas os registros depois dela continuam valendo
+    if (this->cache->journalStamp.exists) {
+        replayJournal(getJournalPath(),
+                      [&data](const std::string& key, json* value) {
+                          if (value) {
+                              (*data)[key] = std::move(*value);
+                          } else {
+                              data->erase(key);
+                          }
+                      });
+    }
+
+    // As mudanças ainda não gravadas são refeitas por cima do disco, de forma
+    // que o que outros processos gravaram na mesma chave não se perde
+    for (const auto& [key, modifiers] : this->cache->pending) {
+        applyPending(*data, key, modifiers);
+    }
+
+    this->cache->data = data;
+    return this->cache->data;
+}
+
+/**
+ * @brief Lê o snapshot em streaming e devolve as mudanças posteriores a ele.
+ * O arquivo fica travado (trava compartilhada) durante toda a leitura, para
+ * que snapshot e journal sejam do mesmo momento.
+ * @param read Recebe o snapshot.
+ * @return As chaves alteradas pelo journal e pelas mudanças pendentes.
+ */
+std::map<std::string, std::optional<json>> DataManager::readStreaming(
+    const std::function<void(std::istream&)>& read) {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    FileLock fileLock(this->cache->lockFd, this->cache->fileLocked,
+                      getLockPath(), false);
+    {
+        std::ifstream file(getFullPath(), std::ios::binary);
+        read(file);
+    }
+
+    std::map<std::string, std::optional<json>> changes;
+    replayJournal(getJournalPath(),
+                  [&changes](const std::string& key, json* value) {
+                      if (value) {
+                          changes[key] = std::move(*value);
+                      } else {
+                          changes[key] = std::nullopt;
+                      }
+                  });
+    if (!this->cache->pending.empty()) {
+        std::shared_ptr<json> data = refreshLocked();
+        for (const auto& [key, modifiers] : this->cache->pending) {
+            auto it = data->find(key);
+            if (it != data->end()) changes[key] = *it;
+        }
+    }
+    return changes;
+}
+
+/**
+ * @brief Calcula uma impressão digital do snapshot e do journal em disco.
+ * @return Hash FNV-1a das assinaturas (existência, tamanho e mtime) dos dois arquivos.
+ */
+std::uint64_t DataManager::fingerprint() const {
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (i * 8)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    };
+    for (const std::string& path : {getFullPath(), getJournalPath()}) {
+        FileStamp stamp = stampOf(path);
+        mix(stamp.exists);
+        mix(stamp.size);
+        mix(static_cast<std::uint64_t>(stamp.mtime.time_since_epoch().count()));
+    }
+    return hash;
+}
+
+/**
+ * @brief Acrescenta um registro ao journal sob a trava exclusiva do arquivo,
+ * depois de incorporar ao cache o que outros processos tenham gravado.
+ * @param record O registro {"op", "key", "value"}.
+ * @return true se o registro foi gravado, false caso contrário.
+ */
+bool DataManager::appendRecord(const json& record) {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    FileLock fileLock(this->cache->lockFd, this->cache->fileLocked,
+                      getLockPath(), true);
+    refreshLocked();
+    return appendRecordLocked(record);
+}
+
+/**
+ * @brief Acrescenta um registro ao journal (com fsync) e o aplica ao cache.
+ * Dispara a compactação quando o journal passa do limite. Deve ser chamado
+ * com o mutex do cache e a trava exclusiva do arquivo adquiridos, logo após
+ * refreshLocked().
+ * @param record O registro {"op", "key", "value"}.
+ * @return true se o registro foi gravado, false caso contrário.
+ */
+bool DataManager::appendRecordLocked(const json& record) {
+    if (!appendDurably(getJournalPath(), record.dump() + "\n")) {
+        std::cerr << "Erro ao gravar journal: " << getJournalPath() << std::endl;
+        return false;
+    }
+    // O registro síncrono substitui um valor pendente da mesma chave, que
+    // senão o sobrescreveria no próximo flush
+    this->cache->pending.erase(record["key"].get<std::string>());
+    applyLocked(record);
+    this->cache->journalStamp = stampOf(getJournalPath());
+    compactIfNeededLocked();
+    return true;
+}
+
+/**
+ * @brief Aplica um registro ao cache (copiando o json se algum leitor ainda
+ * segura o snapshot antigo), avança a geração e avisa os listeners. Deve ser
+ * chamado com o mutex do cache adquirido.
+ * @param record O registro {"op", "key", "value"}.
+ */
+void DataManager::applyLocked(const json& record) {
+    // Leitores que ainda seguram o snapshot antigo continuam com ele intacto
+    if (this->cache->data.use_count() > 1) {
+        this->cache->data = std::make_shared<json>(*this->cache->data);
+    }
+    applyRecord(*this->cache->data, record);
+    std::uint64_t generation = ++this->cache->generation;
+    const std::string& key = record["key"].get_ref<const std::string&>();
+    const json* value = record.contains("value") ? &record["value"] : nullptr;
+    for (const auto& listener : this->cache->listeners) {
+        listener(generation, key, value);
+    }
+}
+
+/**
+ * @brief Compacta quando o journal fica do tamanho de metade do snapshot (ou
+ * do limite configurado), mantendo o custo amortizado de escrita proporcional
+ * ao tamanho do registro. Deve ser chamado com o mutex do cache e a trava
+ * exclusiva do arquivo adquiridos.
+ */
+void DataManager::compactIfNeededLocked() {
+    std::uintmax_t limit = std::max(this->cache->journalLimit,
+                                    this->cache->snapshotStamp.size / 2);
+    if (this->cache->journalStamp.size > limit) {
+        writeSnapshotLocked(*this->cache->data);
+    }
+}
+
+/**
+ * @brief Grava (insere ou substitui) o valor de uma chave de primeiro nível.
+ * @param key A chave (ex: ISBN ou nome de usuário).
+ * @param value O novo valor.
+ * @return true se a operação foi registrada, false caso contrário.
+ */
+bool DataManager::put(const std::string& key, const json& value) {
+    return appendRecord({{"op", "put"}, {"key", key}, {"value", value}});
+}
+
+/**
+ * @brief Remove uma chave de primeiro nível.
+ * @param key A chave a ser removida.
+ * @return true se a operação foi registrada, false caso contrário.
+ */
+bool DataManager::erase(const std::string& key) {
+    return appendRecord({{"op", "erase"}, {"key", key}});
+}
+
+/**
+ * @brief Leitura-modificação-escrita otimista de uma chave: modify roda sem
+ * travas sobre o valor lido, e o resultado só é gravado se a versão da chave
+ * (ver versionOf) ainda for a mesma sob a trava exclusiva. Em caso de
+ * conflito, lê de novo e repete.
+ * @param key A chave.
+ * @param modify Recebe o valor atual (nullptr se ausente) e devolve o novo,
+ * ou std::nullopt para não gravar nada. Pode ser chamada mais de uma vez.
+ * @param maxAttempts Quantidade máxima de tentativas.
+ * @return true se o valor foi gravado (ou modify não pediu gravação), false
+ * em caso de erro de escrita ou se os conflitos esgotaram as tentativas.
+ */
+bool DataManager::update(const std::string& key, const Modifier& modify,
+                         int maxAttempts) {
+    for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        std::optional<json> current;
+        {
+            std::lock_guard<std::mutex> lock(this->cache->mutex);
+            std::shared_ptr<json> data = refreshLocked();
+            auto it = data->find(key);
+            if (it != data->end()) current = *it;
+        }
+        const std::uint64_t version = versionOf(current ? &*current : nullptr);
+        std::optional<json> next = modify(current ? &*current : nullptr);
+        if (!next) return true;
+
+        std::lock_guard<std::mutex> lock(this->cache->mutex);
+        FileLock fileLock(this->cache->lockFd, this->cache->fileLocked,
+                          getLockPath(), true);
+        std::shared_ptr<json> data = refreshLocked();
+        auto it = data->find(key);
+        if (versionOf(it != data->end() ? &*it : nullptr) != version) {
+            continue;  // Outra thread ou processo mudou a chave no meio
+        }
+        return appendRecordLocked({{"op", "put"}, {"key", key}, {"value", *next}});
+    }
+    std::cerr << "Conflito ao atualizar '" << key << "' em " << getFullPath()
+              << std::endl;
+    return false;
+}
+
+/**
+ * @brief Atualiza a chave só na memória e a marca como pendente; a thread de
+ * escrita grava depois. O custo não depende do tamanho do arquivo em disco.
+ * @param key A chave.
+ * @param modify Recebe o valor atual (nullptr se ausente) e devolve o novo,
+ * ou std::nullopt para não gravar nada.
+ * @return true se a mudança foi aceita.
+ */
+bool DataManager::updateAsync(const std::string& key, const Modifier& modify) {
+    {
+        std::lock_guard<std::mutex> lock(this->cache->mutex);
+        std::optional<json> next;
+        {
+            std::shared_ptr<json> data = refreshLocked();
+            auto it = data->find(key);
+            next = modify(it != data->end() ? &*it : nullptr);
+        }
+        if (!next) return true;
+        this->cache->pending[key].push_back(modify);
+        applyLocked({{"op", "put"}, {"key", key}, {"value", std::move(*next)}});
+    }
+    WriteBehind::instance().schedule(*this);
     return true;
 }
 
+/**
+ * @brief Grava as mudanças pendentes deste arquivo.
+ * @return true se nada ficou pendente.
+ */
+bool DataManager::flush() {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    if (this->cache->pending.empty()) return true;
+    FileLock fileLock(this->cache->lockFd, this->cache->fileLocked,
+                      getLockPath(), true);
+    // Incorpora antes o que outros processos gravaram (as pendentes são
+    // reaplicadas por cima)
+    refreshLocked();
+    return flushLocked();
+}
+
+/**
+ * @brief Grava todas as mudanças pendentes no journal em uma única escrita
+ * (com um único fsync). Deve ser chamado com o mutex do cache e a trava
+ * exclusiva do arquivo adquiridos, logo após refreshLocked(): o valor gravado
+ * de cada chave é o do cache, em que as modificações pendentes já foram
+ * refeitas sobre o que está em disco.
+ * @return true se as mudanças foram gravadas; senão continuam pendentes.
+ */
+bool DataManager::flushLocked() {
+    std::string batch;
+    for (const auto& [key, modifiers] : this->cache->pending) {
+        auto it = this->cache->data->find(key);
+        if (it == this->cache->data->end()) continue;
+        batch += json{{"op", "put"}, {"key", key}, {"value", *it}}.dump();
+        batch += '\n';
+    }
+    if (!appendDurably(getJournalPath(), batch)) {
+        std::cerr << "Erro ao gravar journal: " << getJournalPath() << std::endl;
+        return false;
+    }
+    this->cache->pending.clear();
+    this->cache->journalStamp = stampOf(getJournalPath());
+    compactIfNeededLocked();
+    return true;
+}
+
+/**
+ * @brief Grava as mudanças pendentes de todos os arquivos.
+ * @return true se todas foram gravadas.
+ */
+bool DataManager::flushAll() {
+    return WriteBehind::instance().flushAll();
+}
+
+/**
+ * @brief Incorpora o journal ao snapshot e o descarta.
+ * @return true se a compactação ocorreu com sucesso, false caso contrário.
+ */
+bool DataManager::compact() {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    FileLock fileLock(this->cache->lockFd, this->cache->fileLocked,
+                      getLockPath(), true);
+    std::shared_ptr<json> data = refreshLocked();
+    if (!this->cache->journalStamp.exists) return true;
+    return writeSnapshotLocked(*data);
+}
+
+/**
+ * @brief Retorna a geração atual do conteúdo. Só consulta as assinaturas dos
+ * arquivos; o json não é relido.
+ * @return A geração.
+ */
+std::uint64_t DataManager::generation() {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    checkLocked();
+    return this->cache->generation;
+}
+
+/**
+ * @brief Registra um callback para as mudanças feitas por put/erase.
+ * @param listener O callback.
+ */
+void DataManager::subscribe(ChangeListener listener) {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    this->cache->listeners.push_back(std::move(listener));
+}
+
+/**
+ * @brief Define o tamanho mínimo (em bytes) do journal antes da compactação.
+ * @param bytes O novo limite.
+ */
+void DataManager::setJournalLimit(std::uintmax_t bytes) {
+    std::lock_guard<std::mutex> lock(this->cache->mutex);
+    this->cache->journalLimit = bytes;
+}
+
 /**
  * @brief Carrega o objeto JSON do arquivo. Se uma query é fornecida, retorna apenas o valor correspondente à chave.
  * @param query A chave do valor a ser retornado (opcional).
  * @return O objeto JSON carregado, ou um objeto JSON vazio em caso de erro.
  */
 json DataManager::load(std::string query) {
-    json data = load();
-    if (data.contains(query)) return data[query];
+    std::shared_ptr<const json> data = snapshot();
+    auto it = data->find(query);
+    if (it != data->end()) return *it;
     return json::object();
 }
 
 /**
  * @brief Carrega o objeto JSON principal do arquivo.
- * @return O objeto JSON carregado, ou um objeto JSON vazio em caso de erro.
+ * @return Uma cópia do objeto JSON carregado, ou um objeto JSON vazio em caso de erro.
+ * @note Para apenas ler, prefira snapshot(), que não copia o catálogo.
  */
 json DataManager::load() {
-    std::ifstream file(getFullPath());
-    if (!file.is_open()) return json::object();
-    file.seekg(0, std::ios::end);
-    if (file.tellg() == 0) {
-        file.close();
-        return json::object();
-    }
-    file.seekg(0, std::ios::beg);
-    json data;
-    file >> data;
-    file.close();
-    return data;
+    return *snapshot();
 }
 
 /**
@@ -133,11 +1036,8 @@ json DataManager::load() {
  * @return true se o elemento foi removido com sucesso, false caso contrário.
  */
 bool DataManager::remove(std::string query) {
-    json data = load();
-    if (data.is_null() || data.empty()) return false;
-    if (!data.contains(query)) return false;
-    data.erase(query);
-    return save(data);
+    if (!has(query)) return false;
+    return erase(query);
 }
 
 /**
@@ -146,7 +1046,7 @@ bool DataManager::remove(std::string query) {
  * @return true se o elemento existe, false caso contrário.
  */
 bool DataManager::has(std::string query) {
-    json data = load();
-    if (data.is_null() || data.empty()) return false;
-    return data.contains(query);
+    std::shared_ptr<const json> data = snapshot();
+    if (data->is_null() || data->empty()) return false;
+    return data->contains(query);
 }
@@ -13,9 +13,16 @@
 #ifndef DATA_MANAGER_H
 #define DATA_MANAGER_H
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>  // C++17+ para manipulação de sistema de arquivos
 #include <fstream>
+#include <functional>
+#include <istream>
+#include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
 
 using json = nlohmann::json;
@@ -23,12 +30,81 @@ using json = nlohmann::json;
 /**
  * @class DataManager
  * @brief Gerencia operações de I/O em arquivos de dados.
+ *
+ * Vários processos podem usar o mesmo diretório de dados: as escritas
+ * (put, erase, update, save, compactação) seguram uma trava exclusiva em
+ * "<arquivo>.lock" e incorporam antes o que os outros processos gravaram; as
+ * releituras do disco seguram a mesma trava em modo compartilhado.
+ *
+ * Gravação em segundo plano (updateAsync): o valor novo vale na memória na
+ * hora, para todas as instâncias do processo, e uma thread de escrita grava
+ * as chaves pendentes no journal em lote, um registro por chave. Até lá, as
+ * modificações ficam guardadas e são refeitas, na ordem, sobre o valor em
+ * disco sempre que o arquivo é relido (inclusive sob a trava exclusiva, logo
+ * antes de gravar), como em update(). Regras em caso de queda:
+ * - put, erase, update e save continuam síncronos: quando retornam true, o
+ *   registro já está em disco (fsync).
+ * - Uma chave gravada com updateAsync chega ao disco em até FLUSH_INTERVAL_MS
+ *   (ou antes, se houver FLUSH_PENDING_KEYS pendentes), em flush() /
+ *   flushAll() ou no fim normal do programa. Se o processo cair antes disso,
+ *   a mudança se perde, mas os arquivos nunca ficam corrompidos: um lote é
+ *   uma única escrita no journal, e uma linha incompleta no fim do journal é
+ *   ignorada na leitura e cortada antes da próxima escrita.
+ * - Outros processos só veem a mudança depois que ela é gravada; se dois
+ *   processos mudarem a mesma chave em segundo plano, as duas modificações
+ *   entram (a segunda é refeita sobre o valor gravado pela primeira).
  */
 class DataManager {
+ public:
+  /**
+   * @brief Callback chamado após cada put/erase: (geração, chave, valor), com
+   * valor nullptr quando a chave foi removida.
+   * @note É chamado com o cache travado; não deve chamar o DataManager.
+   */
+  using ChangeListener =
+      std::function<void(std::uint64_t, const std::string&, const json*)>;
+
+  /**
+   * @brief Função de update(): recebe o valor atual (nullptr se a chave não
+   * existe) e devolve o novo valor, ou std::nullopt para não gravar.
+   */
+  using Modifier = std::function<std::optional<json>(const json*)>;
+
  private:
   std::string directoryPath;
   std::string fileName;
 
+  /**
+   * @brief Snapshot compartilhado do arquivo em memória.
+   * @note Instâncias (e cópias) que apontam para o mesmo arquivo dividem o
+   * mesmo cache, que só é relido quando o mtime ou o tamanho mudam.
+   */
+  struct Cache;
+  std::shared_ptr<Cache> cache;
+
+  /**
+   * @brief Obtém (ou cria) o cache associado ao caminho completo do arquivo.
+   * @param create Se false, retorna nullptr quando o cache ainda não existe.
+   */
+  static std::shared_ptr<Cache> cacheFor(const std::string& fullPath,
+                                         bool create = true);
+
+  /**
+   * @brief Instância sobre um cache já obtido, sem criar o arquivo.
+   */
+  DataManager(const std::string& filename, const std::string& directory,
+              std::shared_ptr<Cache> cache);
+
+  // --- Journal (log de escrita) ---
+  void checkLocked();
+  std::shared_ptr<json> refreshLocked();
+  bool writeSnapshotLocked(const json& j);
+  bool appendRecord(const json& record);
+  bool appendRecordLocked(const json& record);
+  void applyLocked(const json& record);
+  void compactIfNeededLocked();
+  bool flushLocked();
+
   /**
    * @brief Garante que o diretório de dados exista, criando-o se necessário.
    * @note Utiliza a biblioteca <filesystem> para portabilidade.
@@ -36,6 +112,30 @@ class DataManager {
   void ensureDirectoryExists();
 
  public:
+  /**
+   * @brief Tamanho mínimo padrão do journal (em bytes) antes de compactar.
+   */
+  static constexpr std::uintmax_t DEFAULT_JOURNAL_LIMIT = 4 * 1024 * 1024;
+
+  /**
+   * @brief Tempo máximo (em milissegundos) que uma mudança feita com
+   * updateAsync espera antes de ser gravada.
+   */
+  static constexpr int FLUSH_INTERVAL_MS = 200;
+
+  /**
+   * @brief Quantidade de mudanças pendentes (em todos os arquivos) que
+   * antecipa a gravação em segundo plano.
+   */
+  static constexpr std::size_t FLUSH_PENDING_KEYS = 256;
+
+  /**
+   * @brief Quantidade de caches registrados no processo acima da qual os
+   * que nenhuma instância usa mais (ex: os dos arquivos por usuário) são
+   * descartados, do menos para o mais recente, fechando a trava aberta.
+   */
+  static constexpr std::size_t MAX_CACHED_FILES = 256;
+
   /**
    * @brief Construtor que assume o diretório padrão "data".
    * @param filename O nome do arquivo a ser gerenciado (ex: "users.txt").
@@ -71,15 +171,139 @@ class DataManager {
   std::string getFileName() const;
   std::string getDirectoryPath() const;
   std::string getFullPath() const;
+  std::string getJournalPath() const;
+  std::string getLockPath() const;
 
   json getJSON();
 
+  /**
+   * @brief Retorna o snapshot em memória do arquivo, relendo-o do disco apenas
+   * se o arquivo mudou desde a última leitura.
+   * @return Ponteiro compartilhado para o json (somente leitura).
+   */
+  std::shared_ptr<const json> snapshot();
+
+  /**
+   * @brief Lê um arquivo inteiro (snapshot + journal + mudanças pendentes
+   * deste processo) sem deixar o cache dele em memória, para varrer muitos
+   * arquivos pequenos (ex: os históricos de todos os usuários). Se o arquivo
+   * já tem cache neste processo, esse cache é usado.
+   * @param filename O nome do arquivo.
+   * @param directory O diretório do arquivo (não é criado).
+   * @return O json, ou um objeto vazio se o arquivo não existir.
+   */
+  static json read(const std::string& filename, const std::string& directory);
+
+  /**
+   * @brief Lê o arquivo em streaming, sem montar o json inteiro em memória
+   * (ex: para gerar o catálogo binário de um books.json grande).
+   * @param read Recebe o snapshot em disco; é chamada com o arquivo travado e
+   * não deve chamar o DataManager.
+   * @return As chaves alteradas depois do snapshot (journal e mudanças
+   * pendentes), com o valor final, ou std::nullopt se a chave foi removida.
+   * Esses valores substituem os do snapshot.
+   */
+  std::map<std::string, std::optional<json>> readStreaming(
+      const std::function<void(std::istream&)>& read);
+
+  /**
+   * @brief Calcula uma impressão digital (mtime + tamanho) do arquivo e do
+   * seu journal, usada por arquivos derivados (ex: catálogo binário) para
+   * saber se estão desatualizados.
+   * @return Um valor que muda sempre que o conteúdo em disco muda.
+   */
+  std::uint64_t fingerprint() const;
+
+  /**
+   * @brief Contador que muda a cada alteração do conteúdo (put, erase, save
+   * ou releitura do disco). Índices derivados comparam este valor para saber
+   * se podem aplicar apenas as mudanças notificadas ou precisam se reconstruir.
+   * @return A geração atual.
+   */
+  std::uint64_t generation();
+
+  /**
+   * @brief Registra um callback para as mudanças de chave feitas por put/erase
+   * em qualquer instância que gerencie este arquivo.
+   * @param listener O callback.
+   */
+  void subscribe(ChangeListener listener);
+
   /**
    * @brief Salva um json no arquivo usando atomic write.
    * @return true se o salvamento ocorreu com sucesso, false caso contrário.
    */
   bool save(json& json);
 
+  /**
+   * @brief Grava o valor de uma chave de primeiro nível acrescentando um
+   * registro ao journal, sem reescrever o arquivo inteiro.
+   * @return true se o registro foi gravado, false caso contrário.
+   */
+  bool put(const std::string& key, const json& value);
+
+  /**
+   * @brief Atualiza uma chave com leitura-modificação-escrita otimista: se
+   * outra thread ou processo alterar a chave entre a leitura e a gravação, a
+   * modificação é refeita sobre o valor novo.
+   * @param key A chave de primeiro nível.
+   * @param modify Calcula o novo valor a partir do atual (pode ser chamada
+   * mais de uma vez).
+   * @param maxAttempts Quantidade máxima de tentativas em caso de conflito.
+   * @return true se gravou (ou não havia o que gravar), false caso contrário.
+   */
+  bool update(const std::string& key, const Modifier& modify,
+              int maxAttempts = 16);
+
+  /**
+   * @brief Atualiza uma chave na memória na hora e deixa a gravação em disco
+   * para a thread de escrita (ver as regras em caso de queda acima). Não
+   * espera nenhuma escrita ou fsync.
+   * @param key A chave de primeiro nível.
+   * @param modify Calcula o novo valor a partir do atual; é guardada e
+   * chamada de novo, com o cache travado, a cada releitura do arquivo até a
+   * gravação. Por isso não deve chamar o DataManager, ter efeitos colaterais
+   * ou guardar referências para variáveis locais do chamador.
+   * @return true se a mudança foi aceita (ou modify não pediu gravação).
+   */
+  bool updateAsync(const std::string& key, const Modifier& modify);
+
+  /**
+   * @brief Grava agora as mudanças pendentes deste arquivo feitas com
+   * updateAsync.
+   * @return true se não sobrou nada pendente, false em caso de erro de escrita
+   * (as mudanças continuam pendentes).
+   */
+  bool flush();
+
+  /**
+   * @brief Grava agora as mudanças pendentes de todos os arquivos (ex: ao
+   * encerrar o programa).
+   * @return true se todas foram gravadas.
+   */
+  static bool flushAll();
+
+  /**
+   * @brief Remove uma chave de primeiro nível acrescentando um registro ao
+   * journal.
+   * @return true se o registro foi gravado, false caso contrário.
+   */
+  bool erase(const std::string& key);
+
+  /**
+   * @brief Incorpora o journal ao snapshot (escrita atômica) e o descarta.
+   * @note Chamado automaticamente quando o journal passa do limite.
+   * @return true se a compactação ocorreu com sucesso, false caso contrário.
+   */
+  bool compact();
+
+  /**
+   * @brief Define o tamanho mínimo do journal (em bytes) antes da compactação
+   * automática. O limite efetivo é o maior entre este valor e metade do
+   * snapshot.
+   */
+  void setJournalLimit(std::uintmax_t bytes);
+
   /**
    * @brief Carrega um json especifico.
    * @return json.
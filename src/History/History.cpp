@@ -1,27 +1,104 @@
 #include "History.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <filesystem>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <string>
 #include <vector>
 
 using json = nlohmann::json;
 using namespace std;
 
+namespace {
+
+// Nomes codificados maiores que isso são abreviados: o arquivo e os
+// auxiliares do DataManager (".log", ".lock", ".tmp") precisam caber no
+// limite de 255 bytes por nome dos sistemas de arquivos
+const size_t MAX_ENCODED_NAME = 200;
+
+/**
+ * @brief Diretório e arquivo do histórico de um usuário, dentro do diretório
+ * do history.json.
+ */
+DataManager openShard(const DataManager& legacy, const string& username) {
+  auto [directory, file] = History::shardPath(username);
+  filesystem::path path(legacy.getDirectoryPath());
+  path /= "history";
+  path /= directory;
+  return DataManager(file, path.string());
+}
+
+}  // namespace
+
 History::History(DataManager& dataManager, User& user)
-    : dataManager(dataManager), user(user) {
+    : store(openShard(dataManager, user.getUsername())),
+      legacy(dataManager),
+      user(user) {
   load();
 }
 
 /**
- * @brief Carrega o histórico do usuário atual a partir do arquivo JSON.
+ * @brief Codifica o nome do usuário: letras minúsculas, dígitos, '-' e '_'
+ * são mantidos e o resto vira %XX. Um nome codificado com mais de
+ * MAX_ENCODED_NAME bytes fica com o começo seguido de '~' e do hash FNV-1a de
+ * 64 bits do nome inteiro ('~' nunca aparece na codificação normal). O
+ * subdiretório são os 8 bits de baixo do hash FNV-1a de 32 bits do nome.
+ */
+pair<string, string> History::shardPath(const string& username) {
+  static const char hex[] = "0123456789abcdef";
+  string file;
+  uint32_t hash = 2166136261u;
+  uint64_t longHash = 14695981039346656037ull;
+  for (unsigned char c : username) {
+    hash = (hash ^ c) * 16777619u;
+    longHash = (longHash ^ c) * 1099511628211ull;
+    if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' ||
+        c == '_') {
+      file += static_cast<char>(c);
+    } else {
+      file += '%';
+      file += hex[c >> 4];
+      file += hex[c & 0xF];
+    }
+  }
+  if (file.size() > MAX_ENCODED_NAME) {
+    // Corta antes de um %XX pela metade
+    size_t cut = MAX_ENCODED_NAME - 17;
+    if (file[cut - 1] == '%') {
+      cut -= 1;
+    } else if (file[cut - 2] == '%') {
+      cut -= 2;
+    }
+    file.resize(cut);
+    file += '~';
+    for (int shift = 60; shift >= 0; shift -= 4) {
+      file += hex[(longHash >> shift) & 0xF];
+    }
+  }
+  string directory{hex[(hash >> 4) & 0xF], hex[hash & 0xF]};
+  return {directory, file + ".json"};
+}
+
+/**
+ * @brief Carrega o histórico do usuário atual a partir do seu arquivo,
+ * migrando-o do history.json compartilhado se ainda estiver lá.
  */
 bool History::load() {
-  json allHistoryData = this->dataManager.load();
-  string username = this->user.getUsername();
+  const string& username = this->user.getUsername();
+  json userHistory = this->store.load(username);
 
-  if (allHistoryData.contains(username)) {
-    this->history = allHistoryData[username].get<vector<string>>();
+  if (!userHistory.is_array()) {
+    json oldHistory = this->legacy.load(username);
+    if (oldHistory.is_array()) {
+      userHistory = oldHistory;
+      if (this->store.put(username, userHistory)) this->legacy.erase(username);
+    }
+  }
+
+  if (userHistory.is_array()) {
+    this->history = userHistory.get<vector<string>>();
   } else
     this->history.clear();
 
@@ -29,12 +106,10 @@ bool History::load() {
 }
 
 /**
- * @brief Salva o histórico do usuário atual de volta no arquivo JSON.
+ * @brief Salva o histórico do usuário atual de volta no seu arquivo.
  */
 bool History::save() {
-  json allHistoryData = this->dataManager.load();
-  allHistoryData[this->user.getUsername()] = this->history;
-  return this->dataManager.save(allHistoryData);
+  return this->store.put(this->user.getUsername(), this->history);
 }
 
 /**
@@ -61,12 +136,25 @@ bool History::set(vector<string>& newHistory) {
  * Para evitar duplicatas, primeiro verifica se o ISBN já está presente.
  */
 bool History::add(string& isbn) {
-  if (find(this->history.begin(), this->history.end(), isbn) ==
-      this->history.end()) {
-    this->history.push_back(isbn);
-  }
-  this->save();
-  return true;
+  // A lista é refeita sobre a versão mais recente, para não perder o que
+  // outra sessão (ou outro processo) do mesmo usuário tenha acrescentado; a
+  // gravação em disco fica para a thread de escrita, sem atrasar o comando
+  const string& username = this->user.getUsername();
+  bool saved = this->store.updateAsync(
+      username, [isbn](const json* current) -> optional<json> {
+        json latest =
+            current && current->is_array() ? *current : json::array();
+        for (const json& item : latest) {
+          if (item.is_string() && item.get_ref<const string&>() == isbn) {
+            return nullopt;
+          }
+        }
+        latest.push_back(isbn);
+        return latest;
+      });
+  json latest = this->store.load(username);
+  if (latest.is_array()) this->history = latest.get<vector<string>>();
+  return saved;
 }
 
 /**
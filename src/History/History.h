@@ -9,15 +9,42 @@
 
 using namespace std;
 
+/**
+ * @class History
+ * @brief Histórico de livros consultados por um usuário.
+ *
+ * Cada usuário tem o seu próprio arquivo (ver shardPath), de forma que ler ou
+ * gravar um histórico não toca nos dos outros usuários. Históricos antigos,
+ * guardados todos juntos em history.json, são migrados para o arquivo do
+ * usuário no primeiro acesso.
+ */
 class History {
  private:
-  DataManager dataManager;
-  User user;
+  DataManager store;     // Arquivo do usuário
+  DataManager &legacy;   // history.json compartilhado (formato antigo)
+  User &user;
   vector<string> history;
   bool load();
 
  public:
+  /**
+   * @param dataManager Gerenciador do history.json; os arquivos por usuário
+   * ficam no subdiretório "history" do mesmo diretório.
+   * @param user O usuário dono do histórico.
+   */
   explicit History(DataManager &dataManager, User &user);
+
+  /**
+   * @brief Caminho relativo (diretório, arquivo) do histórico de um usuário.
+   * O nome é codificado para ser seguro em qualquer sistema de arquivos
+   * (inclusive os que não diferenciam maiúsculas), nomes muito longos são
+   * abreviados com um hash (o arquivo guarda o histórico sob o nome inteiro,
+   * então nem uma colisão misturaria usuários) e os arquivos são espalhados
+   * em 256 subdiretórios pelo hash do nome.
+   * @param username O nome do usuário.
+   * @return O par (subdiretório, nome do arquivo).
+   */
+  static pair<string, string> shardPath(const string &username);
   User &getUser();
 
   // History methods
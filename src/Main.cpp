@@ -14,6 +14,11 @@
  */
 
 #include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
 #include <functional>
 #include <iomanip>
 #include <iostream>
@@ -24,13 +29,20 @@
 #define byte win_byte_override
 #include <tabulate/table.hpp>
 #undef byte
-#include <set>
+#include <filesystem>
+#include <memory>
 #include <vector>
 
 #include "Book/Book.h"
+#include "Catalog/BinaryCatalog.h"
+#include "Catalog/CatalogReader.h"
 #include "DataManager/DataManager.h"
-#include "History/History.h"
-#include "User/User.h"
+#include "Recommendations/ContentSimilarity.h"
+#include "Recommendations/EmbeddingIndex.h"
+#include "Server/Client.h"
+#include "Server/Server.h"
+#include "Search/TitleIndex.h"
+#include "Service/Service.h"
 #include "Utils/FormatAux.h"
 
 using json = nlohmann::json;
@@ -73,22 +85,79 @@ void displayMainMenu();
 void displayWelcomeMessage(const string& username);
 
 /**
- * @brief Busca livros pelo título usando distância de Jaro-Winkler.
+ * @brief Exibe a mensagem de erro de uma resposta do serviço, se houver.
+ * @param response A resposta.
+ * @return true se a resposta era um erro.
+ */
+bool displayError(const json& response);
+
+/**
+ * @brief Exibe os resultados de uma busca em uma tabela.
  * @param query Termo de busca.
- * @param result_limit Número máximo de resultados.
- * @param booksDataManager Gerenciador de dados dos livros.
+ * @param response A resposta do comando "busca".
+ */
+void displaySearchResults(const string& query, const json& response);
+
+/**
+ * @brief Exibe o histórico de livros consultados.
+ * @param response A resposta do comando "historico".
+ */
+void displayHistory(const json& response);
+
+/**
+ * @brief Exibe as recomendações de livros da home page.
+ * @param response A resposta do comando "homepage".
+ */
+void displayRecommendations(const json& response);
+
+/**
+ * @brief Exibe os livros parecidos com um livro ("mais como este").
+ * @param similar A lista "results" do comando "similares" (ou "similar" do
+ * comando "info").
+ */
+void displaySimilar(const json& similar);
+
+/**
+ * @brief Converte um catálogo json (books.json + journal) para o formato
+ * binário mapeado em memória.
+ * @param input Caminho do json de entrada.
+ * @param output Caminho do arquivo binário de saída.
+ * @return 0 em caso de sucesso, 1 em caso de erro.
+ */
+int convertCatalog(const string& input, const string& output);
+
+/**
+ * @brief Importa livros (saída do BookScraper.py ou JSON Lines) para o
+ * catálogo, lendo a entrada em streaming. ISBNs repetidos ficam com o último
+ * registro, e os livros que já existiam no catálogo são substituídos. Tudo é
+ * gravado de uma vez e os índices (books.bin, books.tri e books.sim) são
+ * refeitos. Os livros lidos ficam em memória, compactos, até a gravação, que
+ * monta o json do catálogo inteiro: a memória usada cresce com o catálogo.
+ * @param input Caminho do arquivo de entrada.
+ * @param output Caminho do catálogo json.
+ * @return 0 em caso de sucesso, 1 em caso de erro.
  */
-void search(const string& query, unsigned int result_limit,
-            DataManager& booksDataManager);
+int importCatalog(const string& input, const string& output);
 
 /**
- * @brief Exibe recomendações de livros para o usuário na home page.
- * @param booksDataManager Gerenciador de dados dos livros.
- * @param historyDataManager Gerenciador de histórico.
- * @param currentUser Usuário atual.
+ * @brief (Re)constrói o índice HNSW (books.hnsw) a partir do
+ * embeddings.jsonl do diretório do catálogo.
+ * @param catalog Caminho do catálogo json.
+ * @return 0 em caso de sucesso, 1 em caso de erro.
  */
-void homePage(DataManager& booksDataManager, DataManager& historyDataManager,
-              User& currentUser);
+int indexEmbeddings(const string& catalog);
+
+/**
+ * @brief Mede a revocação@10 das buscas no índice HNSW contra a força bruta
+ * e o tempo de cada uma, para vários valores de ef. Cada consulta é a média
+ * dos vetores de dois livros, como as consultas das recomendações.
+ * @param catalog Caminho do catálogo json.
+ * @param queries Quantidade de consultas.
+ * @param efs Valores de ef testados.
+ * @return 0 em caso de sucesso, 1 em caso de erro.
+ */
+int evaluateEmbeddings(const string& catalog, size_t queries,
+                       const vector<size_t>& efs);
 
 /**
  * @brief Exibe a lista de comandos disponíveis e suas utilizações.
@@ -102,25 +171,80 @@ void displayHelp() {
        << endl;
   cout << YELLOW << "* busca <termo>" << RESET << " - Busca livros pelo título."
        << endl;
+  cout << YELLOW << "* similares <ISBN>" << RESET
+       << " - Exibe livros com a descrição parecida (mais como este)." << endl;
   cout << YELLOW << "* historico" << RESET
        << " - Exibe o histórico de livros consultados." << endl;
   cout << YELLOW << "* homepage" << RESET << " - Exibe recomendações de livros."
        << endl;
+  cout << YELLOW << "* avaliar <ISBN> <nota>" << RESET
+       << " - Avalia um livro com uma nota de 0 a 5." << endl;
   cout << YELLOW << "* sair" << RESET << " - Encerra o programa." << endl;
 }
 
 /**
  * @brief Ponto de entrada principal da aplicação.
  * @return 0 em caso de sucesso, 1 em caso de erro.
+ * @note "BookMatch converter [entrada.json] [saida.bin]" gera o catálogo
+ * binário sem abrir a interface interativa, "BookMatch importar <entrada>
+ * [catalogo.json]" importa livros em lote, "BookMatch vetores [avaliar
+ * [consultas] [ef...]]" indexa o embeddings.jsonl ou mede a revocação do
+ * índice e "BookMatch servidor [socket]" inicia o servidor (ver Server).
  */
-int main() {
+int main(int argc, char* argv[]) {
   setupConsole();
 
-  // --- Inicialização dos Gestores de Dados ---
-  DataManager userDataManager("users.json");
-  DataManager booksDataManager("books.json");
-  DataManager historyDataManager("history.json");
-  DataManager ratingsDataManager("ratings.json");
+  // --- Subcomandos (sem interface interativa) ---
+  if (argc > 1 && string(argv[1]) == "converter") {
+    string input = argc > 2 ? argv[2] : "data/books.json";
+    string output = argc > 3 ? argv[3] : "data/books.bin";
+    return convertCatalog(input, output);
+  }
+  if (argc > 1 &&
+      (string(argv[1]) == "importar" || string(argv[1]) == "import")) {
+    if (argc < 3) {
+      cout << RED << "Uso: BookMatch importar <entrada.json|.jsonl> "
+                     "[catalogo.json]"
+           << RESET << endl;
+      return 1;
+    }
+    return importCatalog(argv[2], argc > 3 ? argv[3] : "data/books.json");
+  }
+
+  if (argc > 1 && string(argv[1]) == "vetores") {
+    if (argc > 2 && string(argv[2]) == "avaliar") {
+      size_t queries = argc > 3 ? strtoul(argv[3], nullptr, 10) : 1000;
+      vector<size_t> efs;
+      for (int i = 4; i < argc; ++i) {
+        efs.push_back(strtoul(argv[i], nullptr, 10));
+      }
+      if (efs.empty()) efs = {10, 20, 40, 80, 160, 320};
+      return evaluateEmbeddings("data/books.json", queries, efs);
+    }
+    return indexEmbeddings("data/books.json");
+  }
+
+  if (argc > 1 && string(argv[1]) == "servidor") {
+    Service service;
+    Server server(service, argc > 2 ? argv[2] : Server::defaultSocketPath());
+    return server.run();
+  }
+
+  // --- Conexão com o Serviço ---
+  // Com um servidor rodando, a interface só repassa os comandos para ele;
+  // sem servidor, o serviço roda neste processo
+  Service::Session session;
+  unique_ptr<Service> localService;
+  unique_ptr<Client> client = Client::connect(Server::defaultSocketPath());
+  function<json(const json&)> call;
+  if (client) {
+    call = [&client](const json& request) { return client->call(request); };
+  } else {
+    localService = make_unique<Service>();
+    call = [&localService, &session](const json& request) {
+      return localService->handle(request, session);
+    };
+  }
 
   displayMainMenu();
 
@@ -129,55 +253,46 @@ int main() {
   bool isLoggedIn = false;
 
   // --- Loop de Autenticação de Utilizador ---
-  User currentUser(userDataManager);
   while (!isLoggedIn) {
     cout << endl << YELLOW << "-> Usuário: " << RESET;
     getline(cin >> ws, username);
-    currentUser.setUsername(username);
 
-    if (!currentUser.exists()) {
+    json existing = call({{"cmd", "usuario"}, {"user", username}});
+    if (displayError(existing)) continue;
+
+    if (!existing.value("exists", false)) {
       cout << username
            << ", percebi que você não está cadastrado em nosso sistema. "
               "Por favor, crie uma senha."
            << endl;
       cout << endl << YELLOW << "-> Crie uma senha: " << RESET;
       getline(cin >> ws, password);
-      currentUser.hashPassword(password);
 
-      if (!currentUser.save()) {
+      json created = call(
+          {{"cmd", "cadastro"}, {"user", username}, {"password", password}});
+      if (!created.value("ok", false)) {
         cout << RED << BOLD
-             << "Ocorreu um erro crítico ao salvar o usuário. O programa "
-                "será encerrado."
-             << RESET << endl;
+             << created.value("error", string("Ocorreu um erro crítico."))
+             << " O programa será encerrado." << RESET << endl;
         return 1;
       }
       cout << GREEN << "Usuário cadastrado com sucesso!" << RESET << endl;
       isLoggedIn = true;
     } else {
-      currentUser.load();
-      string storedPasswordHash = currentUser.getPasswordHash();
-
-      User validator(
-          userDataManager);  // Usado apenas para validar a senha inserida
-      bool passwordCorrect = false;
-      while (!passwordCorrect) {
+      while (!isLoggedIn) {
         cout << YELLOW << "-> Senha: " << RESET;
         getline(cin >> ws, password);
-        validator.hashPassword(password);
-        if (validator.getPasswordHash() == storedPasswordHash) {
-          passwordCorrect = true;
-          isLoggedIn = true;
-        } else {
-          cout << RED << "Senha incorreta, tente novamente." << RESET << endl;
-        }
+        json loggedIn = call(
+            {{"cmd", "login"}, {"user", username}, {"password", password}});
+        isLoggedIn = !displayError(loggedIn);
       }
     }
   }
 
   // Exibindo mensagem de boas-vindas.
-  displayWelcomeMessage(currentUser.getUsername());
+  displayWelcomeMessage(username);
   // Exibindo recomendações iniciais
-  homePage(booksDataManager, historyDataManager, currentUser);
+  displayRecommendations(call({{"cmd", "homepage"}}));
 
   // --- Manipulador de Comandos ---
   string userInput;
@@ -211,53 +326,63 @@ int main() {
         continue;
       }
 
-      Book book(args, booksDataManager);
-      string isbn = book.getIsbn();
-      if (!book.exists()) {
-        cout << RED << "O livro com o ISBN '" << isbn << "' não foi encontrado."
-             << RESET << endl;
-      } else {
-        book.load();
-        History history(historyDataManager, currentUser);
-        history.add(isbn);
-
+      json response = call({{"cmd", "info"}, {"isbn", args}});
+      if (!displayError(response)) {
         cout << endl
-             << BOLD << "Detalhes do Livro (" << isbn << ")" << RESET << endl;
-        book.display();
+             << BOLD << "Detalhes do Livro (" << args << ")" << RESET << endl;
+        Book::display(response["book"]);
+        displaySimilar(response["similar"]);
       }
+    } else if (command == "similares" || command == "similar") {
+      if (args.empty()) {
+        cout << RED << "Uso: similares <ISBN>" << RESET << endl;
+        continue;
+      }
+      json response = call({{"cmd", "similares"}, {"isbn", args}});
+      if (!displayError(response)) displaySimilar(response["results"]);
     } else if (command == "busca" || command == "buscar" ||
                command == "search" || command == "query") {
-      search(args, 10, booksDataManager);
+      displaySearchResults(
+          args, call({{"cmd", "busca"}, {"query", args}, {"limit", 10}}));
     } else if (command == "historico" || command == "history") {
-      History history(historyDataManager, currentUser);
-      vector<string> userHistory = history.get();
-      if (userHistory.empty()) {
-        cout << RED << "Seu histórico está vazio." << RESET << endl;
-      } else {
-        cout << endl
-             << BOLD << "Histórico de Livros Consultados:" << RESET << endl;
-        for (size_t i = 0; i < userHistory.size(); ++i) {
-          Book book(userHistory[i], booksDataManager);
-          string displayTitle;
-          if (book.exists() && book.load()) {
-            displayTitle = book.getTitle();
-            if (displayTitle.empty()) displayTitle = "[...]";
-          } else {
-            displayTitle = "[...]";
-          }
-          cout << YELLOW << i + 1 << ". " << displayTitle
-               << " - ISBN: " << userHistory[i] << RESET << endl;
-        }
-      }
+      displayHistory(call({{"cmd", "historico"}}));
     } else if (command == "homepage" || command == "casa" ||
                command == "recomendacoes" || command == "recommendations") {
-      homePage(booksDataManager, historyDataManager, currentUser);
+      displayRecommendations(call({{"cmd", "homepage"}}));
+    } else if (command == "avaliar" || command == "rate") {
+      // A nota tem que ser um número inteiro: "4.5" ou "5 lixo" são
+      // recusados em vez de truncados
+      stringstream argsStream(args);
+      string isbn, scoreText, extra;
+      int score = 0;
+      bool valid = static_cast<bool>(argsStream >> isbn >> scoreText) &&
+                   !(argsStream >> extra);
+      if (valid) {
+        const char* end = scoreText.data() + scoreText.size();
+        auto [last, error] = from_chars(scoreText.data(), end, score);
+        valid = error == errc() && last == end;
+      }
+      if (!valid) {
+        cout << RED << "Uso: avaliar <ISBN> <nota>" << RESET << endl;
+        continue;
+      }
+      json response =
+          call({{"cmd", "avaliar"}, {"isbn", isbn}, {"nota", score}});
+      if (!displayError(response)) {
+        uint64_t count = response.value("ratings", uint64_t(0));
+        cout << GREEN << "Avaliação registrada. Média do livro: " << fixed
+             << setprecision(1) << response.value("rating", 0.0) << "/5.0 ("
+             << count << (count == 1 ? " avaliação)." : " avaliações).")
+             << RESET << endl;
+      }
     } else {
       cout << RED << "Comando '" << command << "' desconhecido." << RESET
            << endl;
     }
   }
 
+  // Grava o que ainda estiver pendente (ex: histórico) antes de sair
+  DataManager::flushAll();
   cout << endl
        << GREEN << "Obrigado por utilizar o BookMatch." << RESET << endl;
   return 0;
@@ -309,111 +434,261 @@ void displayWelcomeMessage(const string& username) {
   cout << GREEN << "Bem-vindo, " << BOLD << username << "!" << RESET << endl;
 }
 
-// Jaro-Winkler Similarity (retorna valor entre 0.0 e 1.0, quanto maior mais
-// parecido)
-// Referência: https://www.geeksforgeeks.org/jaro-and-jaro-winkler-similarity/
-double jaroWinkler(const string& s1, const string& s2) {
-  const size_t len1 = s1.size();
-  const size_t len2 = s2.size();
-  if (len1 == 0 && len2 == 0) return 1.0;
-  if (len1 == 0 || len2 == 0) return 0.0;
-  const size_t match_distance = max(len1, len2) / 2 - 1;
-  vector<bool> s1_matches(len1, false);
-  vector<bool> s2_matches(len2, false);
-  int matches = 0;
-  for (size_t i = 0; i < len1; ++i) {
-    size_t start = (i >= match_distance) ? i - match_distance : 0;
-    size_t end = min(i + match_distance + 1, len2);
-    for (size_t j = start; j < end; ++j) {
-      if (s2_matches[j]) continue;
-      if (s1[i] != s2[j]) continue;
-      s1_matches[i] = true;
-      s2_matches[j] = true;
-      ++matches;
-      break;
+int convertCatalog(const string& input, const string& output) {
+  filesystem::path inputPath(input);
+  string directory = inputPath.parent_path().string();
+  DataManager source(inputPath.filename().string(),
+                     directory.empty() ? "." : directory);
+  uint64_t fingerprint = source.fingerprint();
+  vector<CatalogRecord> books;
+  if (!BinaryCatalog::readRecords(source, books) ||
+      !BinaryCatalog::write(books, output, fingerprint)) {
+    cout << RED << "Não foi possível gerar '" << output << "'." << RESET
+         << endl;
+    return 1;
+  }
+  cout << GREEN << books.size() << " livros convertidos para '" << output
+       << "'." << RESET << endl;
+  return 0;
+}
+
+
+int importCatalog(const string& input, const string& output) {
+  auto start = chrono::steady_clock::now();
+  filesystem::path outputPath(output);
+  string directory = outputPath.parent_path().string();
+  DataManager catalog(outputPath.filename().string(),
+                      directory.empty() ? "." : directory);
+
+  // Livros sem createdDate recebem o horário da importação, como no scraper
+  time_t now = time(nullptr);
+  stringstream nowText;
+  nowText << put_time(localtime(&now), "%Y-%m-%dT%H:%M:%S");
+
+  // Os livros lidos ficam como CatalogRecord (só as strings dos campos); o
+  // json de cada um só é montado na hora de juntá-lo ao catálogo
+  vector<CatalogRecord> imported;
+  size_t read = 0, skipped = 0;
+  string error;
+  bool ok = CatalogReader::readFile(
+      input,
+      [&](CatalogRecord& record) {
+        ++read;
+        string isbn;
+        for (char c : record.isbn) {
+          if (c != '-' && c != ' ') isbn += c;
+        }
+        if (isbn.empty()) {
+          ++skipped;
+          return;
+        }
+        record.isbn = move(isbn);
+        imported.push_back(move(record));
+      },
+      error);
+  if (!ok) {
+    cout << RED << "Erro ao ler '" << input << "': " << error << RESET << endl;
+    return 1;
+  }
+
+  // ISBNs repetidos ficam com o último registro
+  stable_sort(imported.begin(), imported.end(),
+              [](const CatalogRecord& a, const CatalogRecord& b) {
+                return a.isbn < b.isbn;
+              });
+  size_t unique = 0;
+  for (size_t i = 0; i < imported.size(); ++i) {
+    if (i + 1 < imported.size() && imported[i + 1].isbn == imported[i].isbn) {
+      continue;
     }
+    if (unique != i) imported[unique] = move(imported[i]);
+    ++unique;
   }
-  if (matches == 0) return 0.0;
-  double t = 0.0;
-  int k = 0;
-  for (size_t i = 0; i < len1; ++i) {
-    if (!s1_matches[i]) continue;
-    while (!s2_matches[k]) ++k;
-    if (s1[i] != s2[k]) t += 0.5;
-    ++k;
+  imported.resize(unique);
+  imported.shrink_to_fit();
+
+  // Uma única gravação do catálogo inteiro, em vez de uma por livro
+  json books = *catalog.snapshot();
+  size_t replaced = 0;
+  for (CatalogRecord& record : imported) {
+    if (books.contains(record.isbn)) ++replaced;
+    // Mesmo formato de Book::save(): a data vira só o ano
+    books[record.isbn] = {
+        {"title", move(record.title)},
+        {"author", move(record.author)},
+        {"date", to_string(Book::parseYear(record.date))},
+        {"createdDate", record.createdDate.empty() ? nowText.str()
+                                                   : move(record.createdDate)},
+        {"publisher", move(record.publisher)},
+        {"description", move(record.description)},
+        {"genre", move(record.genre)},
+        {"tags", move(record.tags)}};
+    record = CatalogRecord();  // Libera as strings que não foram movidas
   }
-  double m = matches;
-  double jaro = (m / len1 + m / len2 + (m - t) / m) / 3.0;
-  // Winkler boost
-  int prefix = 0;
-  for (size_t i = 0; i < min({len1, len2, size_t(4)}); ++i) {
-    if (s1[i] == s2[i])
-      ++prefix;
-    else
-      break;
+  if (!catalog.save(books)) {
+    cout << RED << "Não foi possível gravar '" << output << "'." << RESET
+         << endl;
+    return 1;
   }
-  return jaro + 0.1 * prefix * (1.0 - jaro);
+  BinaryCatalog::openFor(catalog);
+  TitleIndex::forCatalog(catalog);
+  ContentSimilarity::forCatalog(catalog)->refresh();
+
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  cout << GREEN << imported.size() << " livros importados para '" << output
+       << "' (" << replaced << " substituídos, "
+       << read - skipped - imported.size() << " ISBNs repetidos, " << skipped
+       << " sem ISBN) em " << fixed << setprecision(1) << seconds << "s."
+       << RESET << endl;
+  return 0;
 }
 
-void search(const string& query, unsigned int result_limit,
-            DataManager& booksDataManager) {
-  // Carrega todos os livros do JSON
-  json books = booksDataManager.load();
-  if (books.empty()) {
-    cout << "Nenhum livro encontrado." << endl;
-    return;
-  }
+/**
+ * @brief Gerenciador de um catálogo a partir do caminho do json.
+ */
+DataManager catalogAt(const string& catalog) {
+  filesystem::path path(catalog);
+  string directory = path.parent_path().string();
+  return DataManager(path.filename().string(),
+                     directory.empty() ? "." : directory);
+}
 
-  FormatAux formatAux = FormatAux();
+int indexEmbeddings(const string& catalog) {
+  auto start = chrono::steady_clock::now();
+  DataManager books = catalogAt(catalog);
+  string source = EmbeddingIndex::sourcePathFor(books);
+  string path = EmbeddingIndex::pathFor(books);
+  uint64_t fingerprint = EmbeddingIndex::fingerprintOf(source);
+  if (fingerprint == 0) {
+    cout << RED << "Arquivo '" << source << "' não encontrado." << RESET
+         << endl;
+    return 1;
+  }
+  string error;
+  shared_ptr<const EmbeddingIndex> index;
+  if (EmbeddingIndex::build(source, path, fingerprint, error)) {
+    index = EmbeddingIndex::open(path);
+  }
+  if (!index) {
+    cout << RED << "Não foi possível indexar '" << source << "': "
+         << (error.empty() ? "arquivo inválido" : error) << RESET << endl;
+    return 1;
+  }
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  cout << GREEN << index->size() << " vetores (dimensão " << index->dimension()
+       << ", " << index->levels() << " camadas) indexados em '" << path
+       << "' em " << fixed << setprecision(1) << seconds << "s." << RESET
+       << endl;
+  return 0;
+}
 
-  vector<pair<double, string>> results;  // (similaridade, ISBN)
-  // Similaridade Jaro-Winkler
-  string queryLower = formatAux.toLower(query);
-  string queryNorm = formatAux.removeAccents(queryLower);
+int evaluateEmbeddings(const string& catalog, size_t queries,
+                       const vector<size_t>& efs) {
+  const size_t k = 10;
+  DataManager books = catalogAt(catalog);
+  shared_ptr<const EmbeddingIndex> index = EmbeddingIndex::refreshFor(books);
+  if (!index || index->size() < 2 || queries == 0) {
+    cout << RED << "Nenhum vetor indexado (ver 'BookMatch vetores')." << RESET
+         << endl;
+    return 1;
+  }
 
-  for (auto it = books.begin(); it != books.end(); ++it) {
-    string isbn = it.key();
-    string title = it.value().value("title", "");
+  // Consultas fixas, espalhadas pelo índice
+  const size_t n = index->size();
+  vector<vector<float>> inputs(queries, vector<float>(index->dimension()));
+  for (size_t q = 0; q < queries; ++q) {
+    auto a = index->vector(static_cast<uint32_t>(q * n / queries));
+    auto b = index->vector(static_cast<uint32_t>((q * 7919 + 1) % n));
+    double norm = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+      inputs[q][i] = a[i] + b[i];
+      norm += double(inputs[q][i]) * inputs[q][i];
+    }
+    for (float& value : inputs[q]) {
+      value = norm > 0 ? static_cast<float>(value / sqrt(norm)) : 0.0f;
+    }
+  }
 
-    string titleLower = formatAux.toLower(title);
-    string titleNorm = formatAux.removeAccents(titleLower);
+  auto start = chrono::steady_clock::now();
+  vector<vector<uint32_t>> truth(queries);
+  for (size_t q = 0; q < queries; ++q) {
+    for (const EmbeddingIndex::Result& result : index->exact(inputs[q], k)) {
+      truth[q].push_back(result.node);
+    }
+    sort(truth[q].begin(), truth[q].end());
+  }
+  double exactMs =
+      chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+          .count() /
+      queries;
+
+  cout << BOLD << "Revocação@" << k << " contra a força bruta (" << n
+       << " vetores, dimensão " << index->dimension() << ", " << queries
+       << " consultas)" << RESET << endl;
+  cout << fixed << setprecision(3) << "força bruta: " << exactMs
+       << " ms/consulta" << endl;
+  for (size_t ef : efs) {
+    size_t hits = 0, total = 0;
+    start = chrono::steady_clock::now();
+    for (size_t q = 0; q < queries; ++q) {
+      for (const EmbeddingIndex::Result& result :
+           index->search(inputs[q], k, ef)) {
+        hits += binary_search(truth[q].begin(), truth[q].end(), result.node);
+      }
+      total += truth[q].size();
+    }
+    double ms =
+        chrono::duration<double, milli>(chrono::steady_clock::now() - start)
+            .count() /
+        queries;
+    cout << "ef=" << setw(4) << left << ef << right << " revocação "
+         << setprecision(4) << double(hits) / total << "  " << setprecision(3)
+         << ms << " ms/consulta" << endl;
+  }
+  return 0;
+}
 
-    double sim = jaroWinkler(queryNorm, titleNorm);
+bool displayError(const json& response) {
+  if (response.value("ok", false)) return false;
+  cout << RED << response.value("error", string("Erro desconhecido.")) << RESET
+       << endl;
+  return true;
+}
 
-    // Limite de similaridade
-    if (sim <= 0.67) continue;
-    results.emplace_back(sim, isbn);
+void displaySearchResults(const string& query, const json& response) {
+  if (displayError(response)) return;
+  if (response.value("total", 0) == 0) {
+    cout << "Nenhum livro encontrado." << endl;
+    return;
   }
-
+  const json& results = response["results"];
   if (results.empty()) {
     cout << "Nenhum resultado encontrado para '" << query << "'." << endl;
     return;
   }
 
-  sort(results.begin(), results.end(), [](const auto& a, const auto& b) {
-    return a.first > b.first;  // Maior similaridade primeiro
-  });
-
   cout << endl
        << BOLD << "Resultados da Busca para '" << query << "'" << RESET << endl;
 
   Table table;
   table.add_row({"#", "ISBN", "Título", "Autor", "Similaridade"});
 
-  for (size_t i = 0; i < min(results.size(), (size_t)result_limit); ++i) {
-    const auto& book = books[results[i].second];
-    string title = book.value("title", "");
-    string author = book.value("author", "");
+  for (size_t i = 0; i < results.size(); ++i) {
+    string title = results[i].value("title", string());
+    string author = results[i].value("author", string());
 
     // Trunca strings longas para caber nas colunas
     if (title.length() > 45) title = title.substr(0, 42) + "...";
     if (author.length() > 27) author = author.substr(0, 24) + "...";
 
     stringstream similarity_ss;
-    similarity_ss << fixed << setprecision(2) << results[i].first;
+    similarity_ss << fixed << setprecision(2)
+                  << results[i].value("similarity", 0.0);
 
-    table.add_row({to_string(i + 1), results[i].second, title, author,
-                   similarity_ss.str()});
+    table.add_row({to_string(i + 1), results[i].value("isbn", string()), title,
+                   author, similarity_ss.str()});
   }
 
   // Formatação da tabela
@@ -436,96 +711,44 @@ void search(const string& query, unsigned int result_limit,
   cout << table << endl;
 }
 
-void homePage(DataManager& booksDataManager, DataManager& historyDataManager,
-              User& currentUser) {
-  History history(historyDataManager, currentUser);
-  vector<string> userHistory = history.get();
-  json books = booksDataManager.load();
-  vector<pair<string, string>> recommendations;  // (ISBN, Título)
-
-  set<string> userTags;
-  size_t lastN = min(userHistory.size(), size_t(3));
-  // Coleta tags dos últimos N livros do histórico (mais recentes)
-  for (size_t idx = 0; idx < lastN; ++idx) {
-    size_t i = userHistory.size() - 1 - idx;
-    Book book(userHistory[i], booksDataManager);
-    if (book.exists() && book.load()) {
-      vector<string> tags = book.getTags();
-      for (const auto& tag : tags) {
-        if (!tag.empty()) userTags.insert(tag);
-      }
-    }
-  }
-
-  // Mapeia ISBN para (qtd_tags_em_comum, createdDate)
-  vector<tuple<int, string, string>>
-      candidates;  // (qtd_tags, createdDate, ISBN)
-  for (auto it = books.begin(); it != books.end(); ++it) {
-    string isbn = it.key();
-    if (find(userHistory.begin(), userHistory.end(), isbn) != userHistory.end())
-      continue;
-    set<string> bookTags;
-    if (it.value().contains("tags")) {
-      if (it.value()["tags"].is_array()) {
-        for (const auto& tag : it.value()["tags"]) {
-          if (tag.is_string()) bookTags.insert(tag.get<string>());
-        }
-      } else if (it.value()["tags"].is_string()) {
-        string tagStr = it.value()["tags"].get<string>();
-        if (!tagStr.empty()) bookTags.insert(tagStr);
-      }
-    }
-    int common = 0;
-    for (const auto& tag : bookTags) {
-      if (!tag.empty() && userTags.count(tag)) ++common;
-    }
-    if (!userTags.empty() && common > 0) {
-      string createdDate = it.value().value("createdDate", "");
-      candidates.emplace_back(common, createdDate, isbn);
-    }
+void displayHistory(const json& response) {
+  if (displayError(response)) return;
+  const json& items = response["items"];
+  if (items.empty()) {
+    cout << RED << "Seu histórico está vazio." << RESET << endl;
+    return;
   }
-
-  // Ordena por qtd_tags_em_comum (desc), depois por createdDate (desc)
-  sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
-    if (get<0>(a) != get<0>(b)) return get<0>(a) > get<0>(b);
-    return get<1>(a) > get<1>(b);
-  });
-
-  for (size_t i = 0; i < min(candidates.size(), size_t(3)); ++i) {
-    string isbn = get<2>(candidates[i]);
-    string title = books[isbn].value("title", "[...]");
-    recommendations.emplace_back(isbn, title);
+  cout << endl << BOLD << "Histórico de Livros Consultados:" << RESET << endl;
+  for (size_t i = 0; i < items.size(); ++i) {
+    string displayTitle = items[i].value("title", string());
+    if (displayTitle.empty()) displayTitle = "[...]";
+    cout << YELLOW << i + 1 << ". " << displayTitle
+         << " - ISBN: " << items[i].value("isbn", string()) << RESET << endl;
   }
+}
 
-  // Se não houver recomendações por tags, recomenda os mais recentes
-  if (recommendations.empty()) {
-    vector<pair<string, string>> bookDates;  // (ISBN, createdDate)
-    for (auto it = books.begin(); it != books.end(); ++it) {
-      string isbn = it.key();
-      if (!userHistory.empty() && find(userHistory.begin(), userHistory.end(),
-                                       isbn) != userHistory.end())
-        continue;
-      string createdDate = it.value().value("createdDate", "");
-      bookDates.emplace_back(isbn, createdDate);
-    }
-    sort(bookDates.begin(), bookDates.end(), [](const auto& a, const auto& b) {
-      return a.second > b.second;  // Mais recente primeiro
-    });
-    for (size_t i = 0; i < min(bookDates.size(), size_t(3)); ++i) {
-      string isbn = bookDates[i].first;
-      string title = books[isbn].value("title", "[...]");
-      recommendations.emplace_back(isbn, title);
-    }
+void displaySimilar(const json& similar) {
+  if (!similar.is_array() || similar.empty()) return;
+  cout << endl << BOLD << "Mais como este:" << RESET << endl;
+  for (size_t i = 0; i < similar.size(); ++i) {
+    cout << GREEN << i + 1 << ". " << similar[i].value("title", string())
+         << " - ISBN: " << similar[i].value("isbn", string()) << RESET << endl;
   }
+}
 
+void displayRecommendations(const json& response) {
+  if (displayError(response)) return;
+  const json& recommendations = response["recommendations"];
   cout << endl << BOLD << "Recomendações para você:" << RESET << endl;
   if (recommendations.empty()) {
     cout << YELLOW << "Nenhuma recomendação disponível no momento." << RESET
          << endl;
   } else {
     for (size_t i = 0; i < recommendations.size(); ++i) {
-      cout << GREEN << i + 1 << ". " << recommendations[i].second
-           << " - ISBN: " << recommendations[i].first << RESET << endl;
+      cout << GREEN << i + 1 << ". "
+           << recommendations[i].value("title", string())
+           << " - ISBN: " << recommendations[i].value("isbn", string()) << RESET
+           << endl;
     }
   }
 }
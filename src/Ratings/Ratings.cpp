@@ -0,0 +1,291 @@
+/**
+ * @file: Ratings.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação das avaliações dos livros.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "Ratings.h"
+
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "../History/History.h"
+
+namespace {
+
+/**
+ * @brief Lê o agregado guardado para um livro ({"count", "sum"}).
+ */
+Ratings::Summary parseSummary(const json* value) {
+  Ratings::Summary summary;
+  if (!value || !value->is_object()) return summary;
+  auto count = value->find("count");
+  auto sum = value->find("sum");
+  if (count != value->end() && count->is_number_unsigned()) {
+    summary.count = count->get<std::uint64_t>();
+  }
+  if (sum != value->end() && sum->is_number_unsigned()) {
+    summary.sum = sum->get<std::uint64_t>();
+  }
+  return summary;
+}
+
+/**
+ * @brief Hash de string que aceita std::string_view na busca.
+ */
+struct StringHash {
+  using is_transparent = void;
+  std::size_t operator()(std::string_view text) const {
+    return std::hash<std::string_view>()(text);
+  }
+};
+
+}  // namespace
+
+/**
+ * @brief Agregados de um ratings.json em memória: ISBN -> Summary e os
+ * totais de todos os livros.
+ */
+struct Ratings::Index {
+  mutable std::shared_mutex mutex;
+  std::uint64_t generation = 0;
+  std::unordered_map<std::string, Summary, StringHash, std::equal_to<>> books;
+  std::uint64_t totalCount = 0;
+  std::uint64_t totalSum = 0;
+
+  void rebuild(const json& all, std::uint64_t generation) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    books.clear();
+    totalCount = 0;
+    totalSum = 0;
+    if (all.is_object()) {
+      books.reserve(all.size());
+      for (const auto& [isbn, value] : all.items()) {
+        Summary summary = parseSummary(&value);
+        if (summary.count == 0) continue;
+        books.emplace(isbn, summary);
+        totalCount += summary.count;
+        totalSum += summary.sum;
+      }
+    }
+    this->generation = generation;
+  }
+
+  /**
+   * @brief Aplica uma mudança notificada pelo DataManager. Se alguma mudança
+   * anterior foi perdida, o índice é refeito no próximo acesso.
+   */
+  void apply(std::uint64_t generation, const std::string& isbn,
+             const json* value) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (this->generation + 1 != generation) {
+      this->generation = 0;
+      return;
+    }
+    auto it = books.find(isbn);
+    if (it != books.end()) {
+      totalCount -= it->second.count;
+      totalSum -= it->second.sum;
+      books.erase(it);
+    }
+    Summary summary = parseSummary(value);
+    if (summary.count > 0) {
+      books.emplace(isbn, summary);
+      totalCount += summary.count;
+      totalSum += summary.sum;
+    }
+    this->generation = generation;
+  }
+
+  /**
+   * @brief Retorna (e mantém sincronizado) o índice de um arquivo.
+   */
+  static std::shared_ptr<Index> forFile(DataManager& aggregates) {
+    static std::mutex registryMutex;
+    static std::unordered_map<std::string, std::shared_ptr<Index>> registry;
+
+    std::lock_guard<std::mutex> registryLock(registryMutex);
+    auto& index = registry[aggregates.getFullPath()];
+    if (!index) {
+      index = std::make_shared<Index>();
+      std::weak_ptr<Index> weak = index;
+      aggregates.subscribe([weak](std::uint64_t generation,
+                                  const std::string& isbn, const json* value) {
+        if (auto shared = weak.lock()) shared->apply(generation, isbn, value);
+      });
+    }
+    // A geração é lida antes do arquivo: se algo mudar no meio, a próxima
+    // chamada percebe a diferença e refaz de novo
+    std::uint64_t current = aggregates.generation();
+    bool stale;
+    {
+      std::shared_lock<std::shared_mutex> lock(index->mutex);
+      stale = index->generation != current;
+    }
+    if (stale) index->rebuild(*aggregates.snapshot(), current);
+    return index;
+  }
+};
+
+double Ratings::Summary::average() const {
+  return count == 0 ? 0.0 : static_cast<double>(sum) / count;
+}
+
+Ratings::Ratings(const DataManager& ratingsDataManager)
+    : aggregates(ratingsDataManager), index(Index::forFile(aggregates)) {}
+
+Ratings Ratings::forBooks(const DataManager& booksDataManager) {
+  return Ratings(
+      DataManager("ratings.json", booksDataManager.getDirectoryPath()));
+}
+
+Ratings::Summary Ratings::summary(std::string_view isbn) const {
+  std::shared_lock<std::shared_mutex> lock(index->mutex);
+  auto it = index->books.find(isbn);
+  return it == index->books.end() ? Summary() : it->second;
+}
+
+/**
+ * @brief (PRIOR_WEIGHT * média geral + soma) / (PRIOR_WEIGHT + contagem).
+ */
+double Ratings::bayesian(std::string_view isbn) const {
+  std::shared_lock<std::shared_mutex> lock(index->mutex);
+  if (index->totalCount == 0) return 0.0;
+  const double mean = static_cast<double>(index->totalSum) / index->totalCount;
+  auto it = index->books.find(isbn);
+  if (it == index->books.end()) return mean;
+  return (PRIOR_WEIGHT * mean + it->second.sum) /
+         (PRIOR_WEIGHT + it->second.count);
+}
+
+/**
+ * @brief Hash FNV-1a da contagem e da soma de cada livro, na ordem dada.
+ */
+std::uint64_t Ratings::fingerprint(std::span<const std::string> isbns) const {
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+      hash ^= (value >> (i * 8)) & 0xFF;
+      hash *= 1099511628211ULL;
+    }
+  };
+  std::shared_lock<std::shared_mutex> lock(index->mutex);
+  for (const std::string& isbn : isbns) {
+    auto it = index->books.find(isbn);
+    Summary summary = it == index->books.end() ? Summary() : it->second;
+    mix(summary.count);
+    mix(summary.sum);
+  }
+  return hash;
+}
+
+/**
+ * @brief Arquivo das notas de um usuário, dentro do diretório do
+ * ratings.json.
+ */
+DataManager Ratings::userStore(const std::string& username) const {
+  auto [directory, file] = History::shardPath(username);
+  std::filesystem::path path(aggregates.getDirectoryPath());
+  path /= "ratings";
+  path /= directory;
+  return DataManager(file, path.string());
+}
+
+std::optional<int> Ratings::userScore(const std::string& username,
+                                      const std::string& isbn) {
+  json scores = userStore(username).load(username);
+  if (!scores.is_object()) return std::nullopt;
+  auto it = scores.find(isbn);
+  if (it == scores.end() || !it->is_number_integer()) return std::nullopt;
+  return it->get<int>();
+}
+
+/**
+ * @brief Soma as notas de um livro em todos os arquivos de usuários. Só é
+ * usado quando o agregado guardado está inconsistente, então percorrer todos
+ * os arquivos (sem deixá-los no cache, ver DataManager::read) é aceitável.
+ */
+Ratings::Summary Ratings::recount(const std::string& isbn) const {
+  Summary summary;
+  std::filesystem::path root =
+      std::filesystem::path(aggregates.getDirectoryPath()) / "ratings";
+  std::error_code error;
+  for (const auto& shard : std::filesystem::directory_iterator(root, error)) {
+    if (!shard.is_directory()) continue;
+    std::error_code listError;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(shard.path(), listError)) {
+      if (!entry.is_regular_file() || entry.path().extension() != ".json") {
+        continue;
+      }
+      json file = DataManager::read(entry.path().filename().string(),
+                                    shard.path().string());
+      if (!file.is_object()) continue;
+      for (const auto& [username, scores] : file.items()) {
+        if (!scores.is_object()) continue;
+        auto it = scores.find(isbn);
+        if (it == scores.end() || !it->is_number_integer()) continue;
+        std::int64_t score = it->get<std::int64_t>();
+        if (score < MIN_SCORE || score > MAX_SCORE) continue;
+        ++summary.count;
+        summary.sum += static_cast<std::uint64_t>(score);
+      }
+    }
+  }
+  return summary;
+}
+
+/**
+ * @brief Grava a nota no arquivo do usuário e depois ajusta o agregado do
+ * livro pela diferença. Os dois passos são síncronos (update); se o processo
+ * cair entre eles, o agregado fica sem essa nota. Se o agregado não tem a
+ * nota antiga (count 0 ou soma menor que ela), ele é recontado em vez de
+ * ajustado, o que também corrige a nota perdida.
+ */
+bool Ratings::rate(const std::string& username, const std::string& isbn,
+                   int score) {
+  if (score < MIN_SCORE || score > MAX_SCORE) return false;
+
+  std::optional<int> previous;
+  DataManager store = userStore(username);
+  bool saved = store.update(username, [&](const json* current)
+                                          -> std::optional<json> {
+    json scores =
+        current && current->is_object() ? *current : json::object();
+    previous.reset();
+    auto it = scores.find(isbn);
+    if (it != scores.end() && it->is_number_integer()) previous = it->get<int>();
+    if (previous == score) return std::nullopt;  // Nada muda
+    scores[isbn] = score;
+    return scores;
+  });
+  if (!saved) return false;
+  if (previous == score) return true;
+
+  return aggregates.update(isbn, [&](const json* current)
+                                     -> std::optional<json> {
+    Summary summary = parseSummary(current);
+    if (previous && (summary.count == 0 ||
+                     summary.sum < static_cast<std::uint64_t>(*previous))) {
+      // Fora de sincronia com os arquivos dos usuários, que já têm a nota
+      // nova
+      summary = recount(isbn);
+    } else {
+      if (previous) {
+        summary.sum -= static_cast<std::uint64_t>(*previous);
+      } else {
+        ++summary.count;
+      }
+      summary.sum += static_cast<std::uint64_t>(score);
+    }
+    return json{{"count", summary.count}, {"sum", summary.sum}};
+  });
+}
@@ -0,0 +1,119 @@
+/**
+ * @file: Ratings.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição das avaliações dos livros (notas de 0 a 5).
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef RATINGS_H
+#define RATINGS_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "../DataManager/DataManager.h"
+
+/**
+ * @class Ratings
+ * @brief Notas (inteiras, de 0 a 5) dadas pelos usuários aos livros.
+ *
+ * A nota de cada usuário fica no arquivo dele
+ * (ratings/<xx>/<usuário>.json, ver History::shardPath), e o ratings.json
+ * guarda só o agregado de cada livro ({"count", "sum"}), atualizado de forma
+ * incremental a cada nota: uma nota nova soma 1 à contagem e a nota à soma;
+ * uma nota trocada só ajusta a soma. Assim nenhuma consulta precisa percorrer
+ * as notas. As duas gravações não são atômicas juntas: se o agregado de um
+ * livro não comporta a nota antiga que está sendo trocada (ex: o processo
+ * caiu entre elas), ele é recontado a partir dos arquivos dos usuários.
+ *
+ * Os agregados ficam em memória em uma tabela hash por arquivo, mantida em
+ * dia pelas mudanças notificadas pelo DataManager, junto com os totais do
+ * catálogo inteiro; summary() e bayesian() custam O(1).
+ */
+class Ratings {
+ public:
+  /**
+   * @brief Agregado das notas de um livro.
+   */
+  struct Summary {
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+
+    /**
+     * @brief Média simples (0 se não há notas).
+     */
+    double average() const;
+  };
+
+  static const int MIN_SCORE = 0;
+  static const int MAX_SCORE = 5;
+
+  /**
+   * @brief Peso da média geral na média bayesiana (equivale a esse número de
+   * notas com a média geral).
+   */
+  static constexpr double PRIOR_WEIGHT = 5.0;
+
+  /**
+   * @param ratingsDataManager Gerenciador do ratings.json; os arquivos por
+   * usuário ficam no subdiretório "ratings" do mesmo diretório.
+   */
+  explicit Ratings(const DataManager& ratingsDataManager);
+
+  /**
+   * @brief As avaliações do diretório de um catálogo (ratings.json ao lado
+   * do books.json).
+   */
+  static Ratings forBooks(const DataManager& booksDataManager);
+
+  /**
+   * @brief Agregado das notas de um livro.
+   */
+  Summary summary(std::string_view isbn) const;
+
+  /**
+   * @brief Média bayesiana de um livro: a média das notas puxada para a
+   * média geral de todos os livros, tanto mais quanto menos notas o livro
+   * tiver. Livros sem notas ficam com a média geral.
+   */
+  double bayesian(std::string_view isbn) const;
+
+  /**
+   * @brief Nota que um usuário deu a um livro, se deu.
+   */
+  std::optional<int> userScore(const std::string& username,
+                               const std::string& isbn);
+
+  /**
+   * @brief Grava (ou troca) a nota de um usuário para um livro.
+   * @param score A nota, de MIN_SCORE a MAX_SCORE.
+   * @return false se a nota é inválida ou não foi possível gravar.
+   */
+  bool rate(const std::string& username, const std::string& isbn, int score);
+
+  /**
+   * @brief Hash dos agregados de alguns livros, para quem guarda um resultado
+   * que depende das notas deles: só muda quando a nota de um desses livros
+   * muda, e não a cada nota dada a qualquer livro.
+   */
+  std::uint64_t fingerprint(std::span<const std::string> isbns) const;
+
+ private:
+  struct Index;
+
+  DataManager aggregates;  // ratings.json
+  std::shared_ptr<Index> index;
+
+  DataManager userStore(const std::string& username) const;
+  Summary recount(const std::string& isbn) const;
+};
+
+#endif  // RATINGS_H
@@ -0,0 +1,518 @@
+/**
+ * @file: CoOccurrence.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação da filtragem colaborativa item a item.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "CoOccurrence.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "../Utils/ThreadPool.h"
+#include "../Utils/TopK.h"
+
+namespace {
+
+// Livros por tarefa no cálculo paralelo dos vizinhos
+const std::size_t ROWS_PER_TASK = 1024;
+
+/**
+ * @brief Ordem dos vizinhos: maior similaridade primeiro e, em caso de
+ * empate, a linha do catálogo (ordem de ISBN).
+ */
+struct NeighborRanking {
+  bool operator()(const std::pair<float, std::uint32_t>& a,
+                  const std::pair<float, std::uint32_t>& b) const {
+    if (a.first != b.first) return a.first > b.first;
+    return a.second < b.second;
+  }
+};
+
+/**
+ * @brief Hash FNV-1a de uma lista de vizinhos (ver Model::digest).
+ */
+std::uint64_t digestOf(std::span<const CoOccurrence::Neighbor> neighbors) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  auto mix = [&hash](std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+      hash ^= (value >> (i * 8)) & 0xFF;
+      hash *= 1099511628211ULL;
+    }
+  };
+  for (const CoOccurrence::Neighbor& neighbor : neighbors) {
+    mix(neighbor.row);
+    mix(std::bit_cast<std::uint32_t>(neighbor.score));
+  }
+  return hash;
+}
+
+/**
+ * @brief Acrescenta os históricos de um arquivo json ({usuário: [ISBNs]}).
+ */
+void collect(const json& file,
+             std::vector<std::pair<std::string, std::vector<std::string>>>&
+                 histories) {
+  if (!file.is_object()) return;
+  for (const auto& [username, history] : file.items()) {
+    if (!history.is_array()) continue;
+    std::vector<std::string> isbns;
+    isbns.reserve(history.size());
+    for (const json& isbn : history) {
+      if (isbn.is_string()) isbns.push_back(isbn.get<std::string>());
+    }
+    histories.emplace_back(username, std::move(isbns));
+  }
+}
+
+}  // namespace
+
+std::span<const CoOccurrence::Neighbor> CoOccurrence::Model::neighbors(
+    std::size_t row) const {
+  if (row + 1 >= offsets.size()) return {};
+  return std::span<const Neighbor>(entries).subspan(
+      offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+std::uint64_t CoOccurrence::Model::digest(std::size_t row) const {
+  return row < digests.size() ? digests[row] : 0;
+}
+
+std::uint64_t CoOccurrence::Model::getVersion() const { return version; }
+
+/**
+ * @brief Retorna o modelo de um diretório de dados. A primeira construção é
+ * feita aqui mesmo, para que as primeiras recomendações já a usem.
+ */
+std::shared_ptr<CoOccurrence> CoOccurrence::forHistory(
+    DataManager& booksDataManager, const DataManager& historyDataManager) {
+  static std::mutex registryMutex;
+  static std::unordered_map<std::string, std::shared_ptr<CoOccurrence>>
+      registry;
+
+  std::lock_guard<std::mutex> registryLock(registryMutex);
+  auto& model = registry[historyDataManager.getFullPath() + '\n' +
+                         booksDataManager.getFullPath()];
+  if (!model) {
+    model = std::make_shared<CoOccurrence>(booksDataManager,
+                                           historyDataManager);
+    {
+      std::lock_guard<std::mutex> lock(model->mutex);
+      model->refreshing = true;
+    }
+    model->refresh();
+  }
+  return model;
+}
+
+CoOccurrence::CoOccurrence(DataManager& booksDataManager,
+                           const DataManager& historyDataManager)
+    : booksDataManager(booksDataManager),
+      historyDirectory(historyDataManager.getDirectoryPath()),
+      historyFile(historyDataManager.getFileName()) {}
+
+std::shared_ptr<const CoOccurrence::Model> CoOccurrence::model(
+    const BinaryCatalog& books) {
+  std::shared_ptr<const Model> result;
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool sameCatalog =
+        current && current->catalog->getFingerprint() == books.getFingerprint();
+    if (sameCatalog) result = current;
+    if ((!sameCatalog || !pending.empty()) && !refreshing &&
+        std::chrono::steady_clock::now() - lastRefresh >=
+            std::chrono::milliseconds(REFRESH_INTERVAL_MS)) {
+      refreshing = true;
+      schedule = true;
+    }
+  }
+  if (schedule) {
+    // Fora de shared(), para que refresh() possa usar todas as threads dele
+    ThreadPool::background().submit(
+        [self = shared_from_this()] { self->refresh(); });
+  }
+  return result;
+}
+
+void CoOccurrence::update(const std::string& username,
+                          const std::vector<std::string>& history) {
+  std::lock_guard<std::mutex> lock(mutex);
+  pending[username] = history;
+}
+
+CoOccurrence::Stats CoOccurrence::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats stats = counters;
+  stats.pendingUsers = pending.size();
+  return stats;
+}
+
+/**
+ * @brief Linhas do catálogo (ordenadas e sem repetição) dos
+ * MAX_ITEMS_PER_USER livros mais recentes de um histórico.
+ */
+std::vector<std::uint32_t> CoOccurrence::rowsOf(
+    const BinaryCatalog& books, const std::vector<std::string>& history) {
+  std::vector<std::uint32_t> rows;
+  std::size_t first =
+      history.size() > MAX_ITEMS_PER_USER ? history.size() - MAX_ITEMS_PER_USER
+                                          : 0;
+  rows.reserve(history.size() - first);
+  for (std::size_t i = first; i < history.size(); ++i) {
+    if (std::optional<std::size_t> row = books.find(history[i])) {
+      rows.push_back(static_cast<std::uint32_t>(*row));
+    }
+  }
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  return rows;
+}
+
+/**
+ * @brief Lê todos os históricos: os do history.json antigo e, por cima deles,
+ * os arquivos por usuário (ver History::shardPath). Os 256 subdiretórios são
+ * lidos em paralelo, sem deixar os arquivos no cache do DataManager.
+ */
+void CoOccurrence::loadAll(const BinaryCatalog& books) {
+  std::vector<std::pair<std::string, std::vector<std::string>>> histories;
+  collect(DataManager::read(historyFile, historyDirectory), histories);
+
+  std::vector<std::filesystem::path> shards;
+  std::filesystem::path root = std::filesystem::path(historyDirectory) / "history";
+  std::error_code error;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(root, error)) {
+    if (entry.is_directory()) shards.push_back(entry.path());
+  }
+  std::sort(shards.begin(), shards.end());
+  std::vector<std::vector<std::pair<std::string, std::vector<std::string>>>>
+      shardHistories(shards.size());
+  ThreadPool::shared().parallelFor(shards.size(), [&](std::size_t shard) {
+    std::vector<std::string> files;
+    std::error_code listError;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(shards[shard], listError)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".json") {
+        files.push_back(entry.path().filename().string());
+      }
+    }
+    std::sort(files.begin(), files.end());
+    for (const std::string& file : files) {
+      collect(DataManager::read(file, shards[shard].string()),
+              shardHistories[shard]);
+    }
+  });
+  for (auto& shard : shardHistories) {
+    for (auto& history : shard) histories.push_back(std::move(history));
+  }
+
+  // Um usuário migrado aparece nos dois lugares; vale o arquivo por usuário,
+  // lido por último
+  usernames.clear();
+  userIds.clear();
+  std::vector<std::vector<std::uint32_t>> rows;
+  for (auto& [username, history] : histories) {
+    auto [it, inserted] =
+        userIds.try_emplace(username, static_cast<std::uint32_t>(rows.size()));
+    if (inserted) {
+      usernames.push_back(username);
+      rows.emplace_back();
+    }
+    rows[it->second] = rowsOf(books, history);
+  }
+  users = Matrix();
+  for (const auto& userRows : rows) {
+    users.columns.insert(users.columns.end(), userRows.begin(), userRows.end());
+    users.offsets.push_back(users.columns.size());
+  }
+}
+
+/**
+ * @brief Transposta de uma matriz CSR (ordenação por contagem: as linhas da
+ * transposta saem em ordem crescente).
+ */
+CoOccurrence::Matrix CoOccurrence::transpose(const Matrix& matrix,
+                                             std::size_t columns) {
+  Matrix result;
+  result.offsets.assign(columns + 1, 0);
+  for (std::uint32_t column : matrix.columns) ++result.offsets[column + 1];
+  for (std::size_t c = 0; c < columns; ++c) {
+    result.offsets[c + 1] += result.offsets[c];
+  }
+  result.columns.resize(matrix.columns.size());
+  std::vector<std::uint64_t> next(result.offsets.begin(),
+                                  result.offsets.end() - 1);
+  for (std::size_t r = 0; r < matrix.rows(); ++r) {
+    for (std::uint32_t column : matrix.row(r)) {
+      result.columns[next[column]++] = static_cast<std::uint32_t>(r);
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Calcula os vizinhos de algumas linhas. A coocorrência de uma linha i
+ * com as outras é acumulada em um vetor denso (um por thread, reaproveitado)
+ * percorrendo os usuários de i e os livros de cada um deles.
+ * @param sizes Recebe a quantidade de vizinhos de cada linha.
+ * @param neighbors Recebe os vizinhos de todas as linhas, em sequência.
+ */
+void CoOccurrence::computeRows(const Matrix& users, const Matrix& books,
+                               std::span<const std::uint32_t> rows,
+                               std::vector<std::uint32_t>& sizes,
+                               std::vector<Neighbor>& neighbors) {
+  static thread_local std::vector<std::uint32_t> counts;
+  static thread_local std::vector<std::uint32_t> touched;
+  if (counts.size() < books.rows()) counts.resize(books.rows(), 0);
+
+  for (std::uint32_t i : rows) {
+    touched.clear();
+    for (std::uint32_t user : books.row(i)) {
+      for (std::uint32_t j : users.row(user)) {
+        if (j != i && counts[j]++ == 0) touched.push_back(j);
+      }
+    }
+    TopK<std::pair<float, std::uint32_t>, NeighborRanking> top(NEIGHBORS);
+    const double readersOfI = static_cast<double>(books.row(i).size());
+    for (std::uint32_t j : touched) {
+      double score =
+          counts[j] / std::sqrt(readersOfI * books.row(j).size());
+      top.push({static_cast<float>(score), j});
+      counts[j] = 0;
+    }
+    std::vector<std::pair<float, std::uint32_t>> best = top.take();
+    sizes.push_back(static_cast<std::uint32_t>(best.size()));
+    for (const auto& [score, j] : best) neighbors.push_back({j, score});
+  }
+}
+
+/**
+ * @brief Aplica as mudanças pendentes e publica uma versão nova do modelo.
+ * Na primeira chamada lê todos os históricos; se o catálogo mudou, traduz as
+ * linhas pelo ISBN e recalcula tudo; senão recalcula só os livros afetados.
+ */
+void CoOccurrence::refresh() {
+  std::lock_guard<std::mutex> refreshLock(refreshMutex);
+  const auto start = std::chrono::steady_clock::now();
+  // Fora do try: em caso de erro voltam para pending
+  std::unordered_map<std::string, std::vector<std::string>> changes;
+  try {
+    std::shared_ptr<const BinaryCatalog> books =
+        BinaryCatalog::openFor(booksDataManager);
+    std::shared_ptr<const Model> previous;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      previous = current;
+      changes.swap(pending);
+    }
+    const std::size_t bookCount = books->size();
+
+    bool full = !previous || previous->catalog->getFingerprint() !=
+                                 books->getFingerprint();
+    // Históricos anteriores em linhas de books. users só é trocado junto com
+    // current, para as linhas continuarem valendo no catálogo publicado se
+    // algo falhar antes disso
+    const Matrix* base = &users;
+    Matrix translated;
+    if (!previous) {
+      loadAll(*books);
+    } else if (full) {
+      std::vector<std::uint32_t> rows;
+      for (std::size_t user = 0; user < users.rows(); ++user) {
+        rows.clear();
+        for (std::uint32_t old : users.row(user)) {
+          std::string_view isbn =
+              previous->catalog->field(BinaryCatalog::ISBN, old);
+          if (std::optional<std::size_t> row = books->find(isbn)) {
+            rows.push_back(static_cast<std::uint32_t>(*row));
+          }
+        }
+        std::sort(rows.begin(), rows.end());
+        translated.columns.insert(translated.columns.end(), rows.begin(),
+                                  rows.end());
+        translated.offsets.push_back(translated.columns.size());
+      }
+      base = &translated;
+    }
+
+    // Históricos novos: a matriz é refeita com as linhas trocadas
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> replaced;
+    for (const auto& [username, history] : changes) {
+      auto [it, inserted] = userIds.try_emplace(
+          username, static_cast<std::uint32_t>(usernames.size()));
+      if (inserted) usernames.push_back(username);
+      replaced[it->second] = rowsOf(*books, history);
+    }
+    // Variação de n(i) dos livros que entraram ou saíram de algum histórico
+    std::unordered_map<std::uint32_t, int> readerChanges;
+    std::vector<std::uint32_t> affectedBooks;  // Dos históricos alterados
+    Matrix next;
+    next.columns.reserve(base->columns.size());
+    for (std::size_t user = 0; user < usernames.size(); ++user) {
+      std::span<const std::uint32_t> old;
+      if (user < base->rows()) old = base->row(user);
+      auto it = replaced.find(static_cast<std::uint32_t>(user));
+      if (it == replaced.end()) {
+        next.columns.insert(next.columns.end(), old.begin(), old.end());
+      } else {
+        const std::vector<std::uint32_t>& now = it->second;
+        std::vector<std::uint32_t> difference;
+        std::set_difference(now.begin(), now.end(), old.begin(), old.end(),
+                            std::back_inserter(difference));
+        for (std::uint32_t row : difference) ++readerChanges[row];
+        difference.clear();
+        std::set_difference(old.begin(), old.end(), now.begin(), now.end(),
+                            std::back_inserter(difference));
+        for (std::uint32_t row : difference) --readerChanges[row];
+        affectedBooks.insert(affectedBooks.end(), old.begin(), old.end());
+        affectedBooks.insert(affectedBooks.end(), now.begin(), now.end());
+        next.columns.insert(next.columns.end(), now.begin(), now.end());
+      }
+      next.offsets.push_back(next.columns.size());
+    }
+    Matrix byBook = transpose(next, bookCount);
+
+    std::vector<std::uint32_t> dirty;
+    if (!full) {
+      std::vector<bool> marked(bookCount, false);
+      std::size_t markedCount = 0;
+      auto mark = [&](std::uint32_t row) {
+        if (!marked[row]) {
+          marked[row] = true;
+          ++markedCount;
+        }
+      };
+      // c(i, j) só muda se os dois livros estão em um histórico alterado
+      for (std::uint32_t row : affectedBooks) mark(row);
+      // Fora deles, só n(i) muda. Se n(i) cresceu, a similaridade de i com
+      // os outros livros diminui, e só as listas em que i já estava podem
+      // mudar; se diminuiu, i pode entrar na lista de qualquer livro que
+      // coocorra com ele
+      std::vector<bool> grown(bookCount, false);
+      bool anyGrown = false;
+      for (const auto& [row, change] : readerChanges) {
+        if (change > 0) {
+          grown[row] = true;
+          anyGrown = true;
+        } else if (change < 0) {
+          for (std::uint32_t user : byBook.row(row)) {
+            for (std::uint32_t other : next.row(user)) mark(other);
+          }
+        }
+        if (markedCount > bookCount / 4) break;
+      }
+      for (std::size_t row = 0; anyGrown && row < bookCount; ++row) {
+        for (const Neighbor& neighbor : previous->neighbors(row)) {
+          if (grown[neighbor.row]) {
+            mark(static_cast<std::uint32_t>(row));
+            break;
+          }
+        }
+      }
+      // Com boa parte do catálogo afetada, recalcular tudo sai mais barato
+      // que copiar os vizinhos antigos
+      if (markedCount > bookCount / 4) {
+        full = true;
+      } else {
+        dirty.reserve(markedCount);
+        for (std::size_t row = 0; row < bookCount; ++row) {
+          if (marked[row]) dirty.push_back(static_cast<std::uint32_t>(row));
+        }
+      }
+    }
+    if (full) {
+      dirty.resize(bookCount);
+      for (std::size_t row = 0; row < bookCount; ++row) {
+        dirty[row] = static_cast<std::uint32_t>(row);
+      }
+    }
+
+    const std::size_t tasks = (dirty.size() + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    std::vector<std::vector<std::uint32_t>> sizes(tasks);
+    std::vector<std::vector<Neighbor>> lists(tasks);
+    ThreadPool::shared().parallelFor(tasks, [&](std::size_t task) {
+      std::size_t begin = task * ROWS_PER_TASK;
+      std::size_t end = std::min(dirty.size(), begin + ROWS_PER_TASK);
+      computeRows(next, byBook,
+                  std::span<const std::uint32_t>(dirty).subspan(begin,
+                                                                end - begin),
+                  sizes[task], lists[task]);
+    });
+
+    auto model = std::make_shared<Model>();
+    model->catalog = books;
+    model->offsets.reserve(bookCount + 1);
+    model->offsets.push_back(0);
+    model->digests.reserve(bookCount);
+    std::size_t booksWithNeighbors = 0;
+    std::size_t d = 0;
+    std::size_t cursor = 0;  // Posição em lists[d / ROWS_PER_TASK]
+    for (std::size_t row = 0; row < bookCount; ++row) {
+      if (d < dirty.size() && dirty[d] == row) {
+        const std::size_t task = d / ROWS_PER_TASK;
+        if (d % ROWS_PER_TASK == 0) cursor = 0;
+        const std::size_t count = sizes[task][d % ROWS_PER_TASK];
+        model->entries.insert(model->entries.end(),
+                              lists[task].begin() + cursor,
+                              lists[task].begin() + cursor + count);
+        model->digests.push_back(digestOf(
+            std::span<const Neighbor>(lists[task]).subspan(cursor, count)));
+        cursor += count;
+        ++d;
+      } else {
+        std::span<const Neighbor> old = previous->neighbors(row);
+        model->entries.insert(model->entries.end(), old.begin(), old.end());
+        model->digests.push_back(previous->digest(row));
+      }
+      if (model->entries.size() > model->offsets.back()) ++booksWithNeighbors;
+      model->offsets.push_back(model->entries.size());
+    }
+    users = std::move(next);
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() - start)
+                                 .count();
+    std::lock_guard<std::mutex> lock(mutex);
+    // Começar do relógio evita repetir a versão de uma execução anterior
+    // (as listas de recomendações guardam os hashes das listas, não ela)
+    model->version = std::max<std::uint64_t>(
+        counters.version + 1,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    counters.version = model->version;
+    current = model;
+    ++counters.refreshes;
+    counters.users = usernames.size();
+    counters.entries = users.columns.size();
+    counters.books = booksWithNeighbors;
+    counters.neighbors = model->entries.size();
+    counters.lastDirtyBooks = dirty.size();
+    counters.lastRefreshMs = elapsedMs;
+    refreshing = false;
+    lastRefresh = std::chrono::steady_clock::now();
+  } catch (const std::exception& e) {
+    std::cerr << "Erro ao atualizar os vizinhos: " << e.what() << std::endl;
+    std::lock_guard<std::mutex> lock(mutex);
+    // Um histórico que chegou durante a atualização é mais novo e fica
+    for (auto& [username, history] : changes) {
+      pending.try_emplace(username, std::move(history));
+    }
+    refreshing = false;
+    lastRefresh = std::chrono::steady_clock::now();
+  }
+}
@@ -0,0 +1,206 @@
+/**
+ * @file: CoOccurrence.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição da filtragem colaborativa item a item, calculada a
+ * partir da coocorrência de livros nos históricos dos usuários.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef CO_OCCURRENCE_H
+#define CO_OCCURRENCE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Catalog/BinaryCatalog.h"
+#include "../DataManager/DataManager.h"
+
+/**
+ * @class CoOccurrence
+ * @brief Vizinhos de cada livro para a filtragem colaborativa item a item:
+ * dois livros são vizinhos quando aparecem juntos nos históricos de vários
+ * usuários. A similaridade é o cosseno entre as colunas da matriz esparsa
+ * usuário × livro, ou seja, c(i, j) / sqrt(n(i) * n(j)), em que c(i, j) é a
+ * quantidade de usuários que consultaram os dois livros e n(i) a dos que
+ * consultaram i. Só os NEIGHBORS mais similares de cada livro são guardados.
+ *
+ * A matriz fica em memória em formato CSR nas duas direções (usuário -> livros
+ * e livro -> usuários, ambas com as linhas do catálogo binário), e os vizinhos
+ * de cada livro são calculados em paralelo (ThreadPool::shared) com um vetor
+ * denso de contagens por thread. De cada usuário só entram os
+ * MAX_ITEMS_PER_USER livros mais recentes do histórico, o que limita o custo
+ * de usuários com históricos muito longos.
+ *
+ * O modelo é construído uma vez, lendo todos os históricos (o history.json
+ * antigo e os arquivos por usuário), e depois atualizado de forma incremental:
+ * update() registra o histórico novo de um usuário e, no máximo a cada
+ * REFRESH_INTERVAL_MS, uma tarefa em segundo plano (ThreadPool::background)
+ * refaz a matriz e recalcula os vizinhos só dos livros afetados (os do
+ * usuário e aqueles cuja lista tem um livro que ganhou leitores). Quando o
+ * catálogo muda, as linhas são traduzidas pelo ISBN e os vizinhos são
+ * recalculados em segundo plano; enquanto isso, model() não devolve nada
+ * para o catálogo novo.
+ *
+ * Históricos gravados por outros processos só entram na próxima construção
+ * completa (ao iniciar o programa).
+ */
+class CoOccurrence : public std::enable_shared_from_this<CoOccurrence> {
+ public:
+  /**
+   * @brief Um vizinho: a linha do catálogo e a similaridade (0, 1].
+   */
+  struct Neighbor {
+    std::uint32_t row;
+    float score;
+  };
+
+  /**
+   * @class Model
+   * @brief Uma versão (imutável) dos vizinhos de todos os livros de um
+   * catálogo, em formato CSR.
+   */
+  class Model {
+   public:
+    /**
+     * @brief Vizinhos de um livro, do mais para o menos similar.
+     */
+    std::span<const Neighbor> neighbors(std::size_t row) const;
+
+    /**
+     * @brief Hash da lista de vizinhos de um livro (linhas e
+     * similaridades): só muda quando a lista muda, e é o mesmo entre
+     * execuções do programa para o mesmo catálogo e os mesmos históricos.
+     * Quem guarda um resultado calculado a partir de algumas listas compara
+     * só os hashes delas, e não a versão do modelo inteiro.
+     */
+    std::uint64_t digest(std::size_t row) const;
+
+    /**
+     * @brief Número da versão; muda a cada atualização do modelo e não se
+     * repete entre execuções do programa.
+     */
+    std::uint64_t getVersion() const;
+
+   private:
+    friend class CoOccurrence;
+    std::shared_ptr<const BinaryCatalog> catalog;  // Dono das linhas
+    std::uint64_t version = 0;
+    std::vector<std::uint64_t> offsets;  // Linha -> início em entries
+    std::vector<Neighbor> entries;
+    std::vector<std::uint64_t> digests;  // Linha -> hash da lista
+  };
+
+  /**
+   * @brief Tamanho do modelo atual e contadores das atualizações.
+   */
+  struct Stats {
+    std::size_t users = 0;
+    std::size_t entries = 0;    // Pares (usuário, livro) na matriz
+    std::size_t books = 0;      // Livros com algum vizinho
+    std::size_t neighbors = 0;  // Total de vizinhos guardados
+    std::size_t pendingUsers = 0;
+    std::uint64_t version = 0;
+    std::uint64_t refreshes = 0;
+    std::size_t lastDirtyBooks = 0;  // Livros recalculados na última
+    double lastRefreshMs = 0;
+  };
+
+  /**
+   * @brief Vizinhos guardados por livro.
+   */
+  static const std::size_t NEIGHBORS = 16;
+
+  /**
+   * @brief Livros mais recentes de cada histórico que entram na matriz.
+   */
+  static const std::size_t MAX_ITEMS_PER_USER = 256;
+
+  /**
+   * @brief Intervalo mínimo entre duas atualizações incrementais.
+   */
+  static const int REFRESH_INTERVAL_MS = 1000;
+
+  /**
+   * @brief Retorna o modelo de um diretório de dados, construindo-o na
+   * primeira chamada.
+   * @param booksDataManager Gerenciador do catálogo.
+   * @param historyDataManager Gerenciador do history.json; os históricos por
+   * usuário ficam no subdiretório "history" do mesmo diretório.
+   */
+  static std::shared_ptr<CoOccurrence> forHistory(
+      DataManager& booksDataManager, const DataManager& historyDataManager);
+
+  CoOccurrence(DataManager& booksDataManager,
+               const DataManager& historyDataManager);
+
+  /**
+   * @brief Versão atual do modelo, se ela corresponder ao catálogo dado.
+   * Agenda a atualização em segundo plano quando há mudanças pendentes.
+   * @return O modelo, ou nullptr se ainda não há um para este catálogo.
+   */
+  std::shared_ptr<const Model> model(const BinaryCatalog& books);
+
+  /**
+   * @brief Registra o histórico atual de um usuário; entra no modelo na
+   * próxima atualização.
+   */
+  void update(const std::string& username,
+              const std::vector<std::string>& history);
+
+  Stats stats() const;
+
+ private:
+  /**
+   * @brief Matriz esparsa em formato CSR: as colunas da linha r estão em
+   * columns[offsets[r], offsets[r + 1]), em ordem crescente.
+   */
+  struct Matrix {
+    std::vector<std::uint64_t> offsets{0};
+    std::vector<std::uint32_t> columns;
+
+    std::size_t rows() const { return offsets.size() - 1; }
+    std::span<const std::uint32_t> row(std::size_t r) const {
+      return std::span<const std::uint32_t>(columns).subspan(
+          offsets[r], offsets[r + 1] - offsets[r]);
+    }
+  };
+
+  DataManager& booksDataManager;
+  const std::string historyDirectory;  // Diretório do history.json
+  const std::string historyFile;
+
+  std::mutex refreshMutex;  // Uma atualização por vez; protege os campos abaixo
+  std::vector<std::string> usernames;
+  std::unordered_map<std::string, std::uint32_t> userIds;
+  Matrix users;  // Usuário -> livros (linhas de current->catalog)
+
+  mutable std::mutex mutex;  // Protege os campos abaixo
+  std::shared_ptr<const Model> current;
+  std::unordered_map<std::string, std::vector<std::string>> pending;
+  bool refreshing = false;
+  std::chrono::steady_clock::time_point lastRefresh;
+  Stats counters;
+
+  void refresh();
+  void loadAll(const BinaryCatalog& books);
+  static std::vector<std::uint32_t> rowsOf(
+      const BinaryCatalog& books, const std::vector<std::string>& history);
+  static Matrix transpose(const Matrix& matrix, std::size_t columns);
+  static void computeRows(const Matrix& users, const Matrix& books,
+                          std::span<const std::uint32_t> rows,
+                          std::vector<std::uint32_t>& sizes,
+                          std::vector<Neighbor>& neighbors);
+};
+
+#endif  // CO_OCCURRENCE_H
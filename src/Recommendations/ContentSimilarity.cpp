@@ -0,0 +1,873 @@
+/**
+ * @file: ContentSimilarity.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação da similaridade por conteúdo entre livros.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "ContentSimilarity.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "../Utils/FormatAux.h"
+#include "../Utils/ThreadPool.h"
+#include "../Utils/TopK.h"
+
+namespace {
+
+// A versão muda quando a separação das palavras ou os pesos mudam (os
+// vetores gravados deixariam de corresponder às descrições)
+const char MAGIC[8] = {'B', 'M', 'S', 'I', 'M', 'T', 'F', '1'};
+
+// Livros por tarefa nos laços paralelos
+const std::size_t ROWS_PER_TASK = 1024;
+// Termos por tarefa na ordenação das listas invertidas
+const std::size_t TERMS_PER_TASK = 4096;
+// Palavras menores que isso (em bytes, já normalizadas) são ignoradas
+const std::size_t MIN_TOKEN = 3;
+// Termos presentes em mais que essa fração dos livros quase não distinguem
+// nada e só alongariam as listas invertidas
+const double MAX_DOCUMENT_FREQUENCY = 0.9;
+
+const std::uint32_t NONE = UINT32_MAX;
+const std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+const std::uint64_t FNV_PRIME = 1099511628211ull;
+// Semente própria para o gênero, que não se confunde com uma palavra igual
+// da descrição
+const std::uint64_t GENRE_SEED = FNV_OFFSET ^ 0x9E3779B97F4A7C15ull;
+
+/**
+ * @brief Cabeçalho do books.sim. Depois dele vêm o vocabulário (hashes e
+ * IDFs), os vetores (offsets, termos e pesos) e os vizinhos (offsets e
+ * entradas).
+ */
+struct Header {
+  char magic[8];
+  std::uint64_t fingerprint;
+  std::uint64_t books;
+  std::uint64_t terms;
+  std::uint64_t entries;
+  std::uint64_t neighbors;
+  std::uint64_t changes;
+};
+
+/**
+ * @brief Ordem dos vizinhos (e das listas invertidas): maior valor primeiro
+ * e, em caso de empate, a linha do catálogo (ordem de ISBN).
+ */
+struct NeighborRanking {
+  bool operator()(const std::pair<float, std::uint32_t>& a,
+                  const std::pair<float, std::uint32_t>& b) const {
+    if (a.first != b.first) return a.first > b.first;
+    return a.second < b.second;
+  }
+};
+
+std::uint64_t hashToken(std::string_view token, std::uint64_t seed) {
+  std::uint64_t hash = seed;
+  for (char c : token) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+bool isWordByte(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+/**
+ * @brief Termos de um livro (hash, ocorrências), em ordem de hash: as
+ * palavras da descrição com pelo menos MIN_TOKEN bytes e o gênero inteiro,
+ * normalizados (minúsculas e sem acentos).
+ */
+void termCounts(const BinaryCatalog& books, std::size_t row,
+                std::vector<std::pair<std::uint64_t, std::uint32_t>>& out) {
+  static thread_local std::string normalized;
+  static thread_local std::vector<std::uint64_t> hashes;
+  FormatAux formatAux;
+  out.clear();
+  hashes.clear();
+
+  formatAux.normalizeInto(books.field(BinaryCatalog::DESCRIPTION, row),
+                          normalized);
+  std::size_t begin = 0;
+  for (std::size_t i = 0; i <= normalized.size(); ++i) {
+    if (i < normalized.size() &&
+        isWordByte(static_cast<unsigned char>(normalized[i]))) {
+      continue;
+    }
+    if (i - begin >= MIN_TOKEN) {
+      hashes.push_back(hashToken(
+          std::string_view(normalized).substr(begin, i - begin), FNV_OFFSET));
+    }
+    begin = i + 1;
+  }
+  formatAux.normalizeInto(books.field(BinaryCatalog::GENRE, row), normalized);
+  if (!normalized.empty()) hashes.push_back(hashToken(normalized, GENRE_SEED));
+
+  std::sort(hashes.begin(), hashes.end());
+  for (std::size_t i = 0; i < hashes.size();) {
+    std::size_t j = i;
+    while (j < hashes.size() && hashes[j] == hashes[i]) ++j;
+    out.emplace_back(hashes[i], static_cast<std::uint32_t>(j - i));
+    i = j;
+  }
+}
+
+/**
+ * @brief Produto escalar entre um vetor denso e um esparso (termos e pesos):
+ * soma de dense[terms[i]] * weights[i]. Com AVX2 os valores do vetor denso
+ * são lidos 8 por vez com gather; com SSE2, 4 por vez.
+ */
+float sparseDot(const float* dense, const std::uint32_t* terms,
+                const float* weights, std::size_t size) {
+  std::size_t i = 0;
+  float sum = 0;
+#if defined(__AVX2__)
+  __m256 acc = _mm256_setzero_ps();
+  for (; i + 8 <= size; i += 8) {
+    __m256i ids =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(terms + i));
+    __m256 values = _mm256_i32gather_ps(dense, ids, 4);
+    acc = _mm256_add_ps(acc,
+                        _mm256_mul_ps(values, _mm256_loadu_ps(weights + i)));
+  }
+  __m128 half =
+      _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+  sum = _mm_cvtss_f32(half);
+#elif defined(__SSE2__)
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= size; i += 4) {
+    __m128 values = _mm_setr_ps(dense[terms[i]], dense[terms[i + 1]],
+                                dense[terms[i + 2]], dense[terms[i + 3]]);
+    acc = _mm_add_ps(acc, _mm_mul_ps(values, _mm_loadu_ps(weights + i)));
+  }
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  sum = _mm_cvtss_f32(acc);
+#endif
+  for (; i < size; ++i) sum += dense[terms[i]] * weights[i];
+  return sum;
+}
+
+}  // namespace
+
+/**
+ * @brief Listas invertidas termo -> (livro, peso), do maior para o menor
+ * peso, com só os MAX_POSTING primeiros de cada termo.
+ */
+struct ContentSimilarity::Postings {
+  std::vector<std::uint64_t> offsets{0};
+  std::vector<Neighbor> entries;
+
+  std::span<const Neighbor> list(std::size_t term) const {
+    return std::span<const Neighbor>(entries).subspan(
+        offsets[term], offsets[term + 1] - offsets[term]);
+  }
+
+  explicit Postings(const Model& model) {
+    const std::size_t termCount = model.vocabulary->hashes.size();
+    std::vector<std::uint64_t> starts(termCount + 1, 0);
+    for (std::uint32_t term : model.terms) ++starts[term + 1];
+    for (std::size_t t = 0; t < termCount; ++t) starts[t + 1] += starts[t];
+    std::vector<Neighbor> all(model.terms.size());
+    std::vector<std::uint64_t> next(starts.begin(), starts.end() - 1);
+    for (std::size_t row = 0; row < model.rows(); ++row) {
+      for (std::uint64_t k = model.vectorOffsets[row];
+           k < model.vectorOffsets[row + 1]; ++k) {
+        all[next[model.terms[k]]++] = {static_cast<std::uint32_t>(row),
+                                       model.weights[k]};
+      }
+    }
+
+    const std::size_t tasks = (termCount + TERMS_PER_TASK - 1) / TERMS_PER_TASK;
+    ThreadPool::shared().parallelFor(tasks, [&](std::size_t task) {
+      std::size_t end = std::min(termCount, (task + 1) * TERMS_PER_TASK);
+      for (std::size_t t = task * TERMS_PER_TASK; t < end; ++t) {
+        std::sort(all.begin() + starts[t], all.begin() + starts[t + 1],
+                  [](const Neighbor& a, const Neighbor& b) {
+                    return NeighborRanking()({a.score, a.row},
+                                             {b.score, b.row});
+                  });
+      }
+    });
+    offsets.reserve(termCount + 1);
+    for (std::size_t t = 0; t < termCount; ++t) {
+      std::uint64_t size = std::min<std::uint64_t>(starts[t + 1] - starts[t],
+                                                   MAX_POSTING);
+      entries.insert(entries.end(), all.begin() + starts[t],
+                     all.begin() + starts[t] + size);
+      offsets.push_back(entries.size());
+    }
+  }
+};
+
+std::span<const ContentSimilarity::Neighbor>
+ContentSimilarity::Model::neighbors(std::size_t row) const {
+  if (row + 1 >= offsets.size()) return {};
+  return std::span<const Neighbor>(entries).subspan(
+      offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+const BinaryCatalog& ContentSimilarity::Model::getCatalog() const {
+  return *catalog;
+}
+
+/**
+ * @brief Retorna a similaridade de um catálogo (uma por arquivo).
+ */
+std::shared_ptr<ContentSimilarity> ContentSimilarity::forCatalog(
+    DataManager& booksDataManager) {
+  static std::mutex registryMutex;
+  static std::unordered_map<std::string, std::shared_ptr<ContentSimilarity>>
+      registry;
+
+  std::lock_guard<std::mutex> registryLock(registryMutex);
+  auto& similarity = registry[booksDataManager.getFullPath()];
+  if (!similarity) {
+    similarity = std::make_shared<ContentSimilarity>(booksDataManager);
+  }
+  return similarity;
+}
+
+ContentSimilarity::ContentSimilarity(DataManager& booksDataManager)
+    : booksDataManager(booksDataManager) {}
+
+std::string ContentSimilarity::pathFor(const DataManager& booksDataManager) {
+  std::filesystem::path path(booksDataManager.getFullPath());
+  path.replace_extension(".sim");
+  return path.string();
+}
+
+/**
+ * @brief Devolve o modelo do catálogo atual. Se o catálogo mudou, o modelo
+ * anterior continua sendo servido enquanto uma tarefa em segundo plano
+ * (ThreadPool::background) o atualiza; só a primeira chamada, sem nada para
+ * servir, espera a leitura do books.sim (ou a construção).
+ */
+std::shared_ptr<const ContentSimilarity::Model> ContentSimilarity::model() {
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+  std::shared_ptr<const Model> previous;
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    previous = current;
+    if (previous && !matches(*previous, *books) && !refreshing) {
+      refreshing = true;
+      schedule = true;
+    }
+  }
+  if (!previous) {
+    refresh();
+    std::lock_guard<std::mutex> lock(mutex);
+    return current;
+  }
+  if (schedule) {
+    // Fora de shared(), para que refresh() possa usar todas as threads dele
+    ThreadPool::background().submit([self = shared_from_this()] {
+      try {
+        self->refresh();
+      } catch (const std::exception& e) {
+        std::cerr << "Erro ao atualizar os livros parecidos: " << e.what()
+                  << std::endl;
+      }
+      std::lock_guard<std::mutex> lock(self->mutex);
+      self->refreshing = false;
+    });
+  }
+  return previous;
+}
+
+/**
+ * @brief Lê o books.sim (sem modelo ainda), atualiza o modelo anterior ou o
+ * refaz, grava o resultado e só então o publica. O mutex dos leitores fica
+ * livre durante o trabalho; refreshMutex impede duas atualizações ao mesmo
+ * tempo (e duas gravações do mesmo arquivo).
+ */
+void ContentSimilarity::refresh() {
+  std::lock_guard<std::mutex> refreshLock(refreshMutex);
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+  std::shared_ptr<const Model> previous;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    previous = current;
+  }
+  if (previous && matches(*previous, *books)) return;
+
+  const auto start = std::chrono::steady_clock::now();
+  const std::string path = pathFor(booksDataManager);
+  std::shared_ptr<Model> next;
+  std::size_t dirtyBooks = books->size();
+  bool loaded = false;
+  bool incremental = false;
+  if (!previous) {
+    next = load(path, books);
+    loaded = next != nullptr;
+  } else {
+    next = update(*previous, books, dirtyBooks);
+    incremental = next != nullptr;
+  }
+  if (!next) {
+    next = build(books);
+    dirtyBooks = books->size();
+  }
+  if (!loaded) save(*next, path);
+  std::size_t booksWithNeighbors = 0;
+  for (std::size_t row = 0; row < next->rows(); ++row) {
+    if (next->offsets[row + 1] > next->offsets[row]) ++booksWithNeighbors;
+  }
+  const double elapsedMs = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - start)
+                               .count();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (incremental) {
+    ++counters.refreshes;
+  } else if (!loaded) {
+    ++counters.builds;
+  }
+  counters.loaded = loaded;
+  counters.terms = next->vocabulary->hashes.size();
+  counters.entries = next->terms.size();
+  counters.neighbors = next->entries.size();
+  counters.books = booksWithNeighbors;
+  counters.lastDirtyBooks = loaded ? 0 : dirtyBooks;
+  counters.lastBuildMs = elapsedMs;
+  current = next;
+}
+
+/**
+ * @brief Informa se um modelo corresponde a um catálogo.
+ */
+bool ContentSimilarity::matches(const Model& model,
+                                const BinaryCatalog& books) {
+  return model.catalog->getFingerprint() == books.getFingerprint() &&
+         model.rows() == books.size();
+}
+
+ContentSimilarity::Stats ContentSimilarity::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
+
+/**
+ * @brief Vetores TF-IDF de algumas linhas: peso (1 + log(tf)) * idf para os
+ * termos do vocabulário, só os MAX_TERMS maiores, normalizados para norma 1
+ * e em ordem decrescente de peso.
+ * @param sizes Recebe a quantidade de termos de cada linha.
+ * @param terms Recebe os termos de todas as linhas, em sequência.
+ * @param weights Recebe os pesos correspondentes.
+ */
+void ContentSimilarity::vectorize(const BinaryCatalog& books,
+                                  const Model::Vocabulary& vocabulary,
+                                  std::span<const std::uint32_t> rows,
+                                  std::vector<std::uint32_t>& sizes,
+                                  std::vector<std::uint32_t>& terms,
+                                  std::vector<float>& weights) {
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> counts;
+  std::vector<std::pair<float, std::uint32_t>> vector;
+  for (std::uint32_t row : rows) {
+    termCounts(books, row, counts);
+    vector.clear();
+    for (const auto& [hash, count] : counts) {
+      auto it = vocabulary.ids.find(hash);
+      if (it == vocabulary.ids.end()) continue;
+      float weight = static_cast<float>((1.0 + std::log(count)) *
+                                        vocabulary.idf[it->second]);
+      if (weight > 0) vector.emplace_back(weight, it->second);
+    }
+    if (vector.size() > MAX_TERMS) {
+      std::nth_element(vector.begin(), vector.begin() + MAX_TERMS,
+                       vector.end(), NeighborRanking());
+      vector.resize(MAX_TERMS);
+    }
+    std::sort(vector.begin(), vector.end(), NeighborRanking());
+    double norm = 0;
+    for (const auto& entry : vector) norm += double(entry.first) * entry.first;
+    norm = std::sqrt(norm);
+    sizes.push_back(static_cast<std::uint32_t>(vector.size()));
+    for (const auto& [weight, term] : vector) {
+      terms.push_back(term);
+      weights.push_back(static_cast<float>(weight / norm));
+    }
+  }
+}
+
+/**
+ * @brief Preenche os vetores de todas as linhas do modelo: as de rows são
+ * calculadas em paralelo e as outras copiadas do modelo anterior.
+ * @param rows Linhas a calcular, em ordem crescente.
+ * @param previous O modelo anterior (pode ser nulo se rows tem todas).
+ * @param newToOld Linha atual -> linha no modelo anterior.
+ */
+void ContentSimilarity::fillVectors(Model& model,
+                                    std::span<const std::uint32_t> rows,
+                                    const Model* previous,
+                                    std::span<const std::uint32_t> newToOld) {
+  const std::size_t tasks = (rows.size() + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+  std::vector<std::vector<std::uint32_t>> sizes(tasks);
+  std::vector<std::vector<std::uint32_t>> terms(tasks);
+  std::vector<std::vector<float>> weights(tasks);
+  ThreadPool::shared().parallelFor(tasks, [&](std::size_t task) {
+    std::size_t begin = task * ROWS_PER_TASK;
+    std::size_t end = std::min(rows.size(), begin + ROWS_PER_TASK);
+    vectorize(*model.catalog, *model.vocabulary,
+              rows.subspan(begin, end - begin), sizes[task], terms[task],
+              weights[task]);
+  });
+
+  const std::size_t bookCount = model.catalog->size();
+  model.vectorOffsets.assign(1, 0);
+  model.vectorOffsets.reserve(bookCount + 1);
+  std::size_t r = 0;
+  std::size_t cursor = 0;  // Posição em terms[r / ROWS_PER_TASK]
+  for (std::size_t row = 0; row < bookCount; ++row) {
+    if (r < rows.size() && rows[r] == row) {
+      const std::size_t task = r / ROWS_PER_TASK;
+      if (r % ROWS_PER_TASK == 0) cursor = 0;
+      const std::size_t count = sizes[task][r % ROWS_PER_TASK];
+      model.terms.insert(model.terms.end(), terms[task].begin() + cursor,
+                         terms[task].begin() + cursor + count);
+      model.weights.insert(model.weights.end(), weights[task].begin() + cursor,
+                           weights[task].begin() + cursor + count);
+      cursor += count;
+      ++r;
+    } else {
+      const std::size_t old = newToOld[row];
+      model.terms.insert(
+          model.terms.end(),
+          previous->terms.begin() + previous->vectorOffsets[old],
+          previous->terms.begin() + previous->vectorOffsets[old + 1]);
+      model.weights.insert(
+          model.weights.end(),
+          previous->weights.begin() + previous->vectorOffsets[old],
+          previous->weights.begin() + previous->vectorOffsets[old + 1]);
+    }
+    model.vectorOffsets.push_back(model.terms.size());
+  }
+}
+
+/**
+ * @brief Calcula os vizinhos de algumas linhas em duas etapas. Primeiro uma
+ * pontuação parcial é acumulada em um vetor denso por livro (um por thread,
+ * reaproveitado), percorrendo só as listas dos PROBE_TERMS termos mais fortes
+ * da linha, que são lidas em sequência. Depois os RERANK_CANDIDATES melhores
+ * por essa pontuação são reordenados pelo cosseno exato, o produto escalar
+ * entre o vetor da linha espalhado em um vetor denso de termos e o vetor
+ * esparso de cada candidato.
+ * @param sizes Recebe a quantidade de vizinhos de cada linha.
+ * @param neighbors Recebe os vizinhos de todas as linhas, em sequência.
+ */
+void ContentSimilarity::computeRows(const Model& model,
+                                    const Postings& postings,
+                                    std::span<const std::uint32_t> rows,
+                                    std::vector<std::uint32_t>& sizes,
+                                    std::vector<Neighbor>& neighbors) {
+  static thread_local std::vector<float> dense;
+  static thread_local std::vector<float> partial;
+  static thread_local std::vector<std::uint32_t> touched;
+  if (dense.size() < model.vocabulary->hashes.size()) {
+    dense.resize(model.vocabulary->hashes.size(), 0.0f);
+  }
+  if (partial.size() < model.rows()) partial.resize(model.rows(), 0.0f);
+
+  for (std::uint32_t i : rows) {
+    const std::uint64_t begin = model.vectorOffsets[i];
+    const std::uint64_t end = model.vectorOffsets[i + 1];
+    const std::uint64_t probeEnd =
+        std::min<std::uint64_t>(end, begin + PROBE_TERMS);
+    touched.clear();
+    for (std::uint64_t k = begin; k < probeEnd; ++k) {
+      const float weight = model.weights[k];
+      for (const Neighbor& entry : postings.list(model.terms[k])) {
+        if (entry.row == i) continue;
+        if (partial[entry.row] == 0.0f) touched.push_back(entry.row);
+        partial[entry.row] += weight * entry.score;
+      }
+    }
+    TopK<std::pair<float, std::uint32_t>, NeighborRanking> candidates(
+        RERANK_CANDIDATES);
+    for (std::uint32_t j : touched) {
+      candidates.push({partial[j], j});
+      partial[j] = 0.0f;
+    }
+
+    for (std::uint64_t k = begin; k < end; ++k) {
+      dense[model.terms[k]] = model.weights[k];
+    }
+    TopK<std::pair<float, std::uint32_t>, NeighborRanking> top(NEIGHBORS);
+    for (const auto& candidate : candidates.take()) {
+      const std::uint32_t j = candidate.second;
+      const std::uint64_t jBegin = model.vectorOffsets[j];
+      float score = sparseDot(dense.data(), model.terms.data() + jBegin,
+                              model.weights.data() + jBegin,
+                              model.vectorOffsets[j + 1] - jBegin);
+      top.push({std::min(score, 1.0f), j});
+    }
+    for (std::uint64_t k = begin; k < end; ++k) dense[model.terms[k]] = 0.0f;
+
+    std::vector<std::pair<float, std::uint32_t>> best = top.take();
+    sizes.push_back(static_cast<std::uint32_t>(best.size()));
+    for (const auto& [score, j] : best) neighbors.push_back({j, score});
+  }
+}
+
+/**
+ * @brief Preenche os vizinhos de todas as linhas do modelo: as de dirty são
+ * calculadas em paralelo e as outras copiadas do modelo anterior, com as
+ * linhas traduzidas.
+ * @param dirty Linhas a calcular, em ordem crescente.
+ * @param previous O modelo anterior (pode ser nulo se dirty tem todas).
+ * @param newToOld Linha atual -> linha no modelo anterior.
+ * @param oldToNew Linha no modelo anterior -> linha atual (NONE se saiu).
+ */
+void ContentSimilarity::fillNeighbors(Model& model, const Postings& postings,
+                                      std::span<const std::uint32_t> dirty,
+                                      const Model* previous,
+                                      std::span<const std::uint32_t> newToOld,
+                                      std::span<const std::uint32_t> oldToNew) {
+  const std::size_t tasks = (dirty.size() + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+  std::vector<std::vector<std::uint32_t>> sizes(tasks);
+  std::vector<std::vector<Neighbor>> lists(tasks);
+  ThreadPool::shared().parallelFor(tasks, [&](std::size_t task) {
+    std::size_t begin = task * ROWS_PER_TASK;
+    std::size_t end = std::min(dirty.size(), begin + ROWS_PER_TASK);
+    computeRows(model, postings, dirty.subspan(begin, end - begin),
+                sizes[task], lists[task]);
+  });
+
+  const std::size_t bookCount = model.rows();
+  model.offsets.assign(1, 0);
+  model.offsets.reserve(bookCount + 1);
+  std::size_t d = 0;
+  std::size_t cursor = 0;  // Posição em lists[d / ROWS_PER_TASK]
+  for (std::size_t row = 0; row < bookCount; ++row) {
+    if (d < dirty.size() && dirty[d] == row) {
+      const std::size_t task = d / ROWS_PER_TASK;
+      if (d % ROWS_PER_TASK == 0) cursor = 0;
+      const std::size_t count = sizes[task][d % ROWS_PER_TASK];
+      model.entries.insert(model.entries.end(), lists[task].begin() + cursor,
+                           lists[task].begin() + cursor + count);
+      cursor += count;
+      ++d;
+    } else {
+      for (const Neighbor& neighbor : previous->neighbors(newToOld[row])) {
+        if (oldToNew[neighbor.row] != NONE) {
+          model.entries.push_back({oldToNew[neighbor.row], neighbor.score});
+        }
+      }
+    }
+    model.offsets.push_back(model.entries.size());
+  }
+}
+
+/**
+ * @brief Construção completa: vocabulário e IDF a partir de todas as
+ * descrições, vetores e vizinhos de todos os livros.
+ */
+std::shared_ptr<ContentSimilarity::Model> ContentSimilarity::build(
+    std::shared_ptr<const BinaryCatalog> books) {
+  const std::size_t bookCount = books->size();
+  const std::size_t tasks = (bookCount + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+
+  // Em quantos livros cada termo aparece
+  std::vector<std::unordered_map<std::uint64_t, std::uint32_t>> partial(tasks);
+  ThreadPool::shared().parallelFor(tasks, [&](std::size_t task) {
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> counts;
+    std::size_t end = std::min(bookCount, (task + 1) * ROWS_PER_TASK);
+    for (std::size_t row = task * ROWS_PER_TASK; row < end; ++row) {
+      termCounts(*books, row, counts);
+      for (const auto& entry : counts) ++partial[task][entry.first];
+    }
+  });
+  std::unordered_map<std::uint64_t, std::uint32_t> frequency;
+  for (auto& counts : partial) {
+    for (const auto& [hash, count] : counts) frequency[hash] += count;
+    counts = {};
+  }
+
+  // Termos que aparecem em um livro só não aproximam ninguém
+  auto vocabulary = std::make_shared<Model::Vocabulary>();
+  const double maxFrequency = MAX_DOCUMENT_FREQUENCY * bookCount;
+  for (const auto& [hash, count] : frequency) {
+    if (count >= 2 && count <= maxFrequency) {
+      vocabulary->hashes.push_back(hash);
+    }
+  }
+  std::sort(vocabulary->hashes.begin(), vocabulary->hashes.end());
+  vocabulary->ids.reserve(vocabulary->hashes.size());
+  vocabulary->idf.reserve(vocabulary->hashes.size());
+  for (std::size_t id = 0; id < vocabulary->hashes.size(); ++id) {
+    std::uint64_t hash = vocabulary->hashes[id];
+    vocabulary->ids.emplace(hash, static_cast<std::uint32_t>(id));
+    vocabulary->idf.push_back(static_cast<float>(
+        std::log(static_cast<double>(bookCount) / frequency[hash])));
+  }
+
+  auto model = std::make_shared<Model>();
+  model->catalog = books;
+  model->vocabulary = vocabulary;
+  std::vector<std::uint32_t> all(bookCount);
+  for (std::size_t row = 0; row < bookCount; ++row) {
+    all[row] = static_cast<std::uint32_t>(row);
+  }
+  fillVectors(*model, all, nullptr, {});
+  fillNeighbors(*model, Postings(*model), all, nullptr, {}, {});
+  return model;
+}
+
+/**
+ * @brief Atualiza o modelo anterior para um catálogo novo. Os livros são
+ * traduzidos pelo ISBN; só os novos ou com descrição/gênero diferentes são
+ * vetorizados (com o vocabulário anterior). Os vizinhos são recalculados para
+ * esses livros, para os que tinham na lista um livro que saiu ou mudou e para
+ * os que sondam uma lista invertida que mudou: com um livro alterado ou sem
+ * um livro que saiu ou mudou.
+ * @param dirtyBooks Recebe a quantidade de livros recalculados.
+ * @return O modelo novo, ou nullptr se o catálogo mudou demais desde a última
+ * construção completa.
+ */
+std::shared_ptr<ContentSimilarity::Model> ContentSimilarity::update(
+    const Model& previous, std::shared_ptr<const BinaryCatalog> books,
+    std::size_t& dirtyBooks) {
+  const BinaryCatalog& old = *previous.catalog;
+  const std::size_t bookCount = books->size();
+  std::vector<std::uint32_t> newToOld(bookCount, NONE);
+  std::vector<std::uint32_t> oldToNew(old.size(), NONE);
+  std::vector<std::uint32_t> changed;  // Novos ou alterados
+  std::size_t kept = 0;
+  std::size_t replaced = 0;
+  for (std::size_t row = 0; row < bookCount; ++row) {
+    std::optional<std::size_t> oldRow =
+        old.find(books->field(BinaryCatalog::ISBN, row));
+    if (oldRow &&
+        old.field(BinaryCatalog::DESCRIPTION, *oldRow) ==
+            books->field(BinaryCatalog::DESCRIPTION, row) &&
+        old.field(BinaryCatalog::GENRE, *oldRow) ==
+            books->field(BinaryCatalog::GENRE, row)) {
+      newToOld[row] = static_cast<std::uint32_t>(*oldRow);
+      oldToNew[*oldRow] = static_cast<std::uint32_t>(row);
+      ++kept;
+    } else {
+      if (oldRow) ++replaced;
+      changed.push_back(static_cast<std::uint32_t>(row));
+    }
+  }
+  const std::size_t removed = old.size() - kept - replaced;
+  const std::size_t changes = previous.changes + changed.size() + removed;
+  // O IDF antigo só vale enquanto o catálogo é quase o mesmo
+  if (changes * 4 > bookCount) return nullptr;
+
+  auto model = std::make_shared<Model>();
+  model->catalog = books;
+  model->vocabulary = previous.vocabulary;
+  model->changes = changes;
+  fillVectors(*model, changed, &previous, newToOld);
+  Postings postings(*model);
+
+  std::vector<bool> marked(bookCount, false);
+  std::size_t markedCount = 0;
+  auto mark = [&](std::size_t row) {
+    if (!marked[row]) {
+      marked[row] = true;
+      ++markedCount;
+    }
+  };
+  for (std::uint32_t row : changed) mark(row);
+  // Listas com um livro que saiu ou mudou
+  for (std::size_t row = 0; row < bookCount; ++row) {
+    if (newToOld[row] == NONE) continue;
+    for (const Neighbor& neighbor : previous.neighbors(newToOld[row])) {
+      if (oldToNew[neighbor.row] == NONE) {
+        mark(row);
+        break;
+      }
+    }
+  }
+  // Livros que passam a ver outros candidatos: os que sondam um termo em
+  // cuja lista (já truncada) há um livro alterado, ou em cuja lista anterior
+  // estava um livro que saiu ou mudou (o lugar dele fica com o seguinte, que
+  // antes ficava de fora)
+  const std::size_t termCount = model->vocabulary->hashes.size();
+  std::vector<bool> reaches(termCount, false);
+  bool anyReaches = false;
+  if (!changed.empty()) {
+    std::vector<bool> isChanged(bookCount, false);
+    for (std::uint32_t row : changed) isChanged[row] = true;
+    for (std::size_t term = 0; term < termCount; ++term) {
+      for (const Neighbor& entry : postings.list(term)) {
+        if (isChanged[entry.row]) {
+          reaches[term] = true;
+          anyReaches = true;
+          break;
+        }
+      }
+    }
+  }
+  for (std::size_t oldRow = 0; oldRow < old.size(); ++oldRow) {
+    if (oldToNew[oldRow] != NONE) continue;
+    for (std::uint64_t k = previous.vectorOffsets[oldRow];
+         k < previous.vectorOffsets[oldRow + 1]; ++k) {
+      // Estava na lista anterior se a atual não está cheia ou se o peso
+      // dele alcança o do último da lista atual
+      std::span<const Neighbor> list = postings.list(previous.terms[k]);
+      if (list.size() < MAX_POSTING ||
+          previous.weights[k] >= list.back().score) {
+        reaches[previous.terms[k]] = true;
+        anyReaches = true;
+      }
+    }
+  }
+  for (std::size_t row = 0; anyReaches && row < bookCount; ++row) {
+    const std::uint64_t begin = model->vectorOffsets[row];
+    const std::uint64_t end = std::min<std::uint64_t>(
+        model->vectorOffsets[row + 1], begin + PROBE_TERMS);
+    for (std::uint64_t k = begin; k < end; ++k) {
+      if (reaches[model->terms[k]]) {
+        mark(row);
+        break;
+      }
+    }
+  }
+
+  std::vector<std::uint32_t> dirty;
+  dirty.reserve(markedCount);
+  for (std::size_t row = 0; row < bookCount; ++row) {
+    if (marked[row]) dirty.push_back(static_cast<std::uint32_t>(row));
+  }
+  dirtyBooks = dirty.size();
+  fillNeighbors(*model, postings, dirty, &previous, newToOld, oldToNew);
+  return model;
+}
+
+bool ContentSimilarity::save(const Model& model, const std::string& path) {
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.fingerprint = model.catalog->getFingerprint();
+  header.books = model.rows();
+  header.terms = model.vocabulary->hashes.size();
+  header.entries = model.terms.size();
+  header.neighbors = model.entries.size();
+  header.changes = model.changes;
+
+  std::string tempPath = path + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    auto write = [&out](const auto& values) {
+      out.write(reinterpret_cast<const char*>(values.data()),
+                static_cast<std::streamsize>(values.size() *
+                                             sizeof(values[0])));
+    };
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write(model.vocabulary->hashes);
+    write(model.vocabulary->idf);
+    write(model.vectorOffsets);
+    write(model.terms);
+    write(model.weights);
+    write(model.offsets);
+    write(model.entries);
+    if (!out) return false;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    std::cerr << "Erro ao salvar os livros parecidos: " << ec.message()
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Lê um books.sim gravado por save(), se corresponder ao catálogo.
+ * @return O modelo, ou nullptr se o arquivo não existe, é inválido ou é de
+ * outra versão do catálogo.
+ */
+std::shared_ptr<ContentSimilarity::Model> ContentSimilarity::load(
+    const std::string& path, std::shared_ptr<const BinaryCatalog> books) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) return nullptr;
+  std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+
+  Header header;
+  if (bytes.size() < sizeof(header)) return nullptr;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.fingerprint != books->getFingerprint() ||
+      header.books != books->size()) {
+    return nullptr;
+  }
+
+  std::size_t offset = sizeof(header);
+  auto read = [&bytes, &offset](auto& values, std::uint64_t count) {
+    using Value = typename std::decay_t<decltype(values)>::value_type;
+    if ((bytes.size() - offset) / sizeof(Value) < count) return false;
+    values.resize(count);
+    std::memcpy(values.data(), bytes.data() + offset, count * sizeof(Value));
+    offset += count * sizeof(Value);
+    return true;
+  };
+  auto vocabulary = std::make_shared<Model::Vocabulary>();
+  auto model = std::make_shared<Model>();
+  if (!read(vocabulary->hashes, header.terms) ||
+      !read(vocabulary->idf, header.terms) ||
+      !read(model->vectorOffsets, header.books + 1) ||
+      !read(model->terms, header.entries) ||
+      !read(model->weights, header.entries) ||
+      !read(model->offsets, header.books + 1) ||
+      !read(model->entries, header.neighbors) || offset != bytes.size()) {
+    return nullptr;
+  }
+
+  // Confere os índices antes de usá-los
+  auto validOffsets = [](const std::vector<std::uint64_t>& offsets,
+                         std::uint64_t total) {
+    return offsets.front() == 0 && offsets.back() == total &&
+           std::is_sorted(offsets.begin(), offsets.end());
+  };
+  if (!validOffsets(model->vectorOffsets, header.entries) ||
+      !validOffsets(model->offsets, header.neighbors) ||
+      std::any_of(model->terms.begin(), model->terms.end(),
+                  [&](std::uint32_t term) { return term >= header.terms; }) ||
+      std::any_of(model->entries.begin(), model->entries.end(),
+                  [&](const Neighbor& neighbor) {
+                    return neighbor.row >= header.books;
+                  })) {
+    return nullptr;
+  }
+
+  vocabulary->ids.reserve(vocabulary->hashes.size());
+  for (std::size_t id = 0; id < vocabulary->hashes.size(); ++id) {
+    vocabulary->ids.emplace(vocabulary->hashes[id],
+                            static_cast<std::uint32_t>(id));
+  }
+  model->catalog = books;
+  model->vocabulary = vocabulary;
+  model->changes = header.changes;
+  return model;
+}
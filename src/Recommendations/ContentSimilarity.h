@@ -0,0 +1,221 @@
+/**
+ * @file: ContentSimilarity.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição da similaridade por conteúdo entre livros, com
+ * vetores TF-IDF das descrições.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef CONTENT_SIMILARITY_H
+#define CONTENT_SIMILARITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Catalog/BinaryCatalog.h"
+#include "../DataManager/DataManager.h"
+
+/**
+ * @class ContentSimilarity
+ * @brief Livros parecidos pelo conteúdo ("mais como este"): cada livro vira
+ * um vetor TF-IDF esparso com as palavras da descrição e o gênero
+ * (normalizados por FormatAux::normalizeInto), e os vizinhos de um livro são
+ * os de maior cosseno com ele.
+ *
+ * Os vizinhos são pré-calculados para o catálogo inteiro, em paralelo
+ * (ThreadPool::shared), e a busca é aproximada para que o custo não cresça
+ * com o quadrado do catálogo: cada vetor guarda só os MAX_TERMS termos de
+ * maior peso, cada lista invertida só os MAX_POSTING livros de maior peso, e
+ * os candidatos de um livro são pontuados só pelas listas dos seus
+ * PROBE_TERMS termos mais fortes. Os RERANK_CANDIDATES melhores candidatos
+ * são então reordenados pelo cosseno exato, o produto escalar entre o vetor
+ * do livro espalhado em um vetor denso e o vetor esparso do candidato (com
+ * gather AVX2 quando disponível).
+ *
+ * O resultado fica gravado ao lado do catálogo (books.sim), com a impressão
+ * digital do catálogo, e é lido na próxima execução sem recálculo; o
+ * importador o gera junto com os outros índices. Quando o catálogo muda, os
+ * livros são traduzidos pelo ISBN e só os novos ou alterados são
+ * vetorizados, com o vocabulário e os pesos (IDF) da última construção
+ * completa; os vizinhos são recalculados só para os livros que podem ter
+ * mudado. Depois que mais de um quarto do catálogo mudou desde a última
+ * construção completa, tudo é refeito. A atualização roda em segundo plano
+ * (ThreadPool::background) e, enquanto ela não termina, model() continua
+ * devolvendo o modelo anterior.
+ */
+class ContentSimilarity
+    : public std::enable_shared_from_this<ContentSimilarity> {
+ public:
+  /**
+   * @brief Um vizinho: a linha do catálogo e o cosseno (0, 1].
+   */
+  struct Neighbor {
+    std::uint32_t row;
+    float score;
+  };
+
+  /**
+   * @class Model
+   * @brief Os vetores e os vizinhos (imutáveis) de todos os livros de um
+   * catálogo, em formato CSR.
+   */
+  class Model {
+   public:
+    /**
+     * @brief Vizinhos de um livro, do mais para o menos similar.
+     */
+    std::span<const Neighbor> neighbors(std::size_t row) const;
+
+    /**
+     * @brief O catálogo a que as linhas se referem.
+     */
+    const BinaryCatalog& getCatalog() const;
+
+   private:
+    friend class ContentSimilarity;
+
+    /**
+     * @brief Termos conhecidos (hash da palavra -> ID) e o IDF de cada um.
+     */
+    struct Vocabulary {
+      std::unordered_map<std::uint64_t, std::uint32_t> ids;
+      std::vector<std::uint64_t> hashes;  // ID -> hash
+      std::vector<float> idf;
+    };
+
+    std::shared_ptr<const BinaryCatalog> catalog;  // Dono das linhas
+    std::shared_ptr<const Vocabulary> vocabulary;
+    std::size_t changes = 0;  // Livros alterados desde a construção completa
+    // Vetores: termos do livro r em [vectorOffsets[r], vectorOffsets[r + 1]),
+    // do maior para o menor peso, com norma 1
+    std::vector<std::uint64_t> vectorOffsets{0};
+    std::vector<std::uint32_t> terms;
+    std::vector<float> weights;
+    std::vector<std::uint64_t> offsets{0};  // Linha -> início em entries
+    std::vector<Neighbor> entries;
+
+    std::size_t rows() const { return vectorOffsets.size() - 1; }
+  };
+
+  /**
+   * @brief Tamanho do modelo atual e contadores das atualizações.
+   */
+  struct Stats {
+    std::size_t books = 0;      // Livros com algum vizinho
+    std::size_t terms = 0;      // Tamanho do vocabulário
+    std::size_t entries = 0;    // Termos guardados em todos os vetores
+    std::size_t neighbors = 0;  // Total de vizinhos guardados
+    std::uint64_t builds = 0;   // Construções completas
+    std::uint64_t refreshes = 0;  // Atualizações incrementais
+    bool loaded = false;  // Modelo atual lido do books.sim
+    std::size_t lastDirtyBooks = 0;  // Livros recalculados na última
+    double lastBuildMs = 0;
+  };
+
+  /**
+   * @brief Vizinhos guardados por livro.
+   */
+  static const std::size_t NEIGHBORS = 10;
+
+  /**
+   * @brief Termos de maior peso guardados no vetor de cada livro.
+   */
+  static const std::size_t MAX_TERMS = 32;
+
+  /**
+   * @brief Termos mais fortes de cada livro usados para achar candidatos.
+   */
+  static const std::size_t PROBE_TERMS = 24;
+
+  /**
+   * @brief Livros de maior peso guardados na lista invertida de cada termo.
+   */
+  static const std::size_t MAX_POSTING = 256;
+
+  /**
+   * @brief Candidatos de cada livro cujo cosseno exato é calculado.
+   */
+  static const std::size_t RERANK_CANDIDATES = 4 * NEIGHBORS;
+
+  /**
+   * @brief Retorna a similaridade de um catálogo, criando-a na primeira
+   * chamada.
+   */
+  static std::shared_ptr<ContentSimilarity> forCatalog(
+      DataManager& booksDataManager);
+
+  explicit ContentSimilarity(DataManager& booksDataManager);
+
+  /**
+   * @brief Caminho do arquivo dos vizinhos associado a um catálogo.
+   */
+  static std::string pathFor(const DataManager& booksDataManager);
+
+  /**
+   * @brief Modelo mais recente. Se o catálogo mudou, agenda a atualização e
+   * devolve o modelo anterior (cujas linhas são as de getCatalog()); só a
+   * primeira chamada espera o modelo ficar pronto.
+   * @return O modelo (nunca nullptr).
+   */
+  std::shared_ptr<const Model> model();
+
+  /**
+   * @brief Deixa o modelo em dia com o catálogo atual, esperando: lido do
+   * books.sim, atualizado de forma incremental ou construído (e gravado).
+   * Usado pelo importador e antes da primeira requisição do servidor.
+   */
+  void refresh();
+
+  Stats stats() const;
+
+ private:
+  struct Postings;
+
+  DataManager& booksDataManager;
+  std::mutex refreshMutex;   // Uma atualização por vez
+  mutable std::mutex mutex;  // Protege os campos abaixo
+  std::shared_ptr<const Model> current;
+  bool refreshing = false;  // Atualização agendada em segundo plano
+  Stats counters;
+
+  static bool matches(const Model& model, const BinaryCatalog& books);
+
+  static std::shared_ptr<Model> build(
+      std::shared_ptr<const BinaryCatalog> books);
+  static std::shared_ptr<Model> update(
+      const Model& previous, std::shared_ptr<const BinaryCatalog> books,
+      std::size_t& dirtyBooks);
+  static void vectorize(const BinaryCatalog& books,
+                        const Model::Vocabulary& vocabulary,
+                        std::span<const std::uint32_t> rows,
+                        std::vector<std::uint32_t>& sizes,
+                        std::vector<std::uint32_t>& terms,
+                        std::vector<float>& weights);
+  static void fillVectors(Model& model, std::span<const std::uint32_t> rows,
+                          const Model* previous,
+                          std::span<const std::uint32_t> newToOld);
+  static void computeRows(const Model& model, const Postings& postings,
+                          std::span<const std::uint32_t> rows,
+                          std::vector<std::uint32_t>& sizes,
+                          std::vector<Neighbor>& neighbors);
+  static void fillNeighbors(Model& model, const Postings& postings,
+                            std::span<const std::uint32_t> dirty,
+                            const Model* previous,
+                            std::span<const std::uint32_t> newToOld,
+                            std::span<const std::uint32_t> oldToNew);
+  static bool save(const Model& model, const std::string& path);
+  static std::shared_ptr<Model> load(
+      const std::string& path, std::shared_ptr<const BinaryCatalog> books);
+};
+
+#endif  // CONTENT_SIMILARITY_H
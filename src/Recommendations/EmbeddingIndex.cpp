@@ -0,0 +1,959 @@
+/**
+ * @file: EmbeddingIndex.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do índice HNSW dos vetores dos livros.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "EmbeddingIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "../Utils/ThreadPool.h"
+#include "../Utils/TopK.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr char MAGIC[8] = {'B', 'M', 'H', 'N', 'S', 'W', 'I', 'X'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Nós inseridos (ou comparados, na força bruta) por tarefa paralela
+const std::size_t NODES_PER_TASK = 256;
+// Faixas de nós com trava própria durante a construção
+const std::size_t LOCK_STRIPES = 4096;
+// Camada máxima sorteada (com LINKS = 16, a camada 8 já tem ~1 nó em 4 bi)
+const std::size_t MAX_LEVEL = 16;
+// Semente do sorteio das camadas: o mesmo arquivo gera as mesmas camadas
+const std::uint64_t LEVEL_SEED = 0x484e5357;
+
+std::size_t align8(std::size_t n) { return (n + 7) & ~std::size_t(7); }
+
+/**
+ * @brief Produto escalar de dois vetores densos. Com AVX2, 8 valores por vez;
+ * com SSE2, 4 por vez.
+ */
+float dot(const float* a, const float* b, std::size_t size) {
+  std::size_t i = 0;
+  float sum = 0;
+#if defined(__AVX2__)
+  __m256 acc = _mm256_setzero_ps();
+  for (; i + 8 <= size; i += 8) {
+    acc = _mm256_add_ps(
+        acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  }
+  __m128 half =
+      _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+  sum = _mm_cvtss_f32(half);
+#elif defined(__SSE2__)
+  __m128 acc = _mm_setzero_ps();
+  for (; i + 4 <= size; i += 4) {
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  }
+  acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+  acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+  sum = _mm_cvtss_f32(acc);
+#endif
+  for (; i < size; ++i) sum += a[i] * b[i];
+  return sum;
+}
+
+/**
+ * @brief Ordem dos resultados: maior cosseno primeiro e, em caso de empate,
+ * o menor nó (ordem de ISBN).
+ */
+struct ResultRanking {
+  bool operator()(const EmbeddingIndex::Result& a,
+                  const EmbeddingIndex::Result& b) const {
+    if (a.score != b.score) return a.score > b.score;
+    return a.node < b.node;
+  }
+};
+
+/**
+ * @brief Ordem inversa, para uma fila cujo topo é o melhor resultado.
+ */
+struct ResultRankingReversed {
+  bool operator()(const EmbeddingIndex::Result& a,
+                  const EmbeddingIndex::Result& b) const {
+    return ResultRanking()(b, a);
+  }
+};
+
+/**
+ * @brief Nós já visitados em uma busca. A marca de cada nó é o número da
+ * busca em que ele foi visto, então começar uma busca nova não exige limpar
+ * o vetor; há um por thread, reaproveitado entre as buscas.
+ */
+class VisitedSet {
+ private:
+  std::vector<std::uint32_t> marks;
+  std::uint32_t epoch = 0;
+
+ public:
+  static VisitedSet& next(std::size_t nodes) {
+    static thread_local VisitedSet visited;
+    if (visited.marks.size() < nodes) visited.marks.resize(nodes, 0);
+    if (++visited.epoch == 0) {
+      std::fill(visited.marks.begin(), visited.marks.end(), 0);
+      visited.epoch = 1;
+    }
+    return visited;
+  }
+
+  /**
+   * @brief Marca um nó como visitado.
+   * @return false se ele já tinha sido visitado nesta busca.
+   */
+  bool insert(std::uint32_t node) {
+    if (marks[node] == epoch) return false;
+    marks[node] = epoch;
+    return true;
+  }
+};
+
+}  // namespace
+
+/**
+ * @brief Cabeçalho do arquivo. Todos os offsets são relativos ao início do
+ * arquivo e alinhados em 8 bytes. Cada lista de vizinhos é um bloco de
+ * tamanho fixo: a quantidade seguida dos nós (2 * links na camada 0, links
+ * nas de cima); os blocos de cima de um nó são consecutivos, a partir de
+ * levelStarts[nó].
+ */
+struct EmbeddingIndex::Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byteOrder;
+  std::uint64_t fingerprint;
+  std::uint64_t nodeCount;
+  std::uint64_t dimension;
+  std::uint64_t links;
+  std::uint64_t maxLevel;
+  std::uint64_t entryPoint;
+  std::uint64_t upperBlocks;
+  std::uint64_t vectorsOffset;      // float[nodeCount * dimension]
+  std::uint64_t isbnOffsetsOffset;  // uint64[nodeCount + 1]
+  std::uint64_t levelStartsOffset;  // uint32[nodeCount + 1]
+  std::uint64_t baseLinksOffset;    // uint32[nodeCount * (2 * links + 1)]
+  std::uint64_t upperLinksOffset;   // uint32[upperBlocks * (links + 1)]
+  std::uint64_t poolOffset;
+  std::uint64_t poolSize;
+};
+
+/**
+ * @brief O grafo em construção, com as mesmas seções do arquivo. As listas
+ * de vizinhos são lidas e alteradas sob a trava da faixa do nó.
+ */
+struct EmbeddingIndex::Builder {
+  std::size_t dimensions = 0;
+  std::vector<float> vectors;
+  std::vector<std::uint64_t> isbnOffsets{0};
+  std::string pool;
+  std::vector<std::uint32_t> levelStarts{0};
+  mutable std::vector<std::uint32_t> baseLinks;   // Protegidas pelas travas
+  mutable std::vector<std::uint32_t> upperLinks;
+  std::unique_ptr<std::mutex[]> locks;
+  std::mutex entryMutex;  // Protege entryPoint e maxLevel
+  std::uint32_t entryPoint = 0;
+  std::size_t maxLevel = 0;
+
+  std::size_t size() const { return isbnOffsets.size() - 1; }
+  std::size_t dimension() const { return dimensions; }
+  std::span<const float> vector(std::uint32_t node) const {
+    return {vectors.data() + std::size_t(node) * dimensions, dimensions};
+  }
+  std::size_t levelOf(std::uint32_t node) const {
+    return levelStarts[node + 1] - levelStarts[node];
+  }
+  std::uint32_t* links(std::uint32_t node, std::size_t level) const {
+    if (level == 0) return baseLinks.data() + node * (2 * LINKS + 1);
+    return upperLinks.data() +
+           (std::size_t(levelStarts[node]) + level - 1) * (LINKS + 1);
+  }
+  std::mutex& lockFor(std::uint32_t node) const {
+    return locks[node % LOCK_STRIPES];
+  }
+
+  /**
+   * @brief Visita uma cópia da lista, feita sob a trava do nó.
+   */
+  template <typename Visit>
+  void forEachLink(std::uint32_t node, std::size_t level,
+                   Visit&& visit) const {
+    std::uint32_t copy[2 * LINKS];
+    std::uint32_t count;
+    {
+      std::lock_guard<std::mutex> lock(lockFor(node));
+      const std::uint32_t* block = links(node, level);
+      count = block[0];
+      std::copy(block + 1, block + 1 + count, copy);
+    }
+    for (std::uint32_t i = 0; i < count; ++i) visit(copy[i]);
+  }
+
+  bool read(const std::string& source, std::string& error);
+  void assignLevels();
+  void insert(std::uint32_t node);
+  std::vector<Result> select(const std::vector<Result>& candidates,
+                             std::size_t count) const;
+  void connect(std::uint32_t node, std::size_t level,
+               const std::vector<Result>& found);
+  bool write(const std::string& path, std::uint64_t fingerprint) const;
+};
+
+/**
+ * @brief Lê o JSON Lines, normaliza os vetores e os deixa em ordem de ISBN.
+ */
+bool EmbeddingIndex::Builder::read(const std::string& source,
+                                   std::string& error) {
+  std::ifstream in(source);
+  if (!in.is_open()) {
+    error = "não foi possível abrir '" + source + "'";
+    return false;
+  }
+  std::vector<std::string> isbns;
+  std::vector<float> raw;
+  std::string line;
+  std::size_t number = 0;
+  while (std::getline(in, line)) {
+    ++number;
+    if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+    json record = json::parse(line, nullptr, false);
+    auto isbn = record.is_object() ? record.find("isbn") : record.end();
+    auto values = record.is_object() ? record.find("vector") : record.end();
+    if (record.is_discarded() || isbn == record.end() || !isbn->is_string() ||
+        values == record.end() || !values->is_array() || values->empty()) {
+      error = "linha " + std::to_string(number) +
+              ", esperado {\"isbn\": \"...\", \"vector\": [...]}";
+      return false;
+    }
+    if (dimensions == 0) dimensions = values->size();
+    if (values->size() != dimensions) {
+      error = "linha " + std::to_string(number) + ", dimensão " +
+              std::to_string(values->size()) + " (esperada " +
+              std::to_string(dimensions) + ")";
+      return false;
+    }
+    const std::size_t start = raw.size();
+    double norm = 0;
+    for (const json& value : *values) {
+      if (!value.is_number()) {
+        error = "linha " + std::to_string(number) + ", valor não numérico";
+        return false;
+      }
+      raw.push_back(value.get<float>());
+      norm += double(raw.back()) * raw.back();
+    }
+    if (norm == 0 || !std::isfinite(norm)) {
+      raw.resize(start);  // Sem direção: não entra no índice
+      continue;
+    }
+    const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+    for (std::size_t i = start; i < raw.size(); ++i) raw[i] *= scale;
+    isbns.push_back(isbn->get<std::string>());
+  }
+
+  // Ordem de ISBN; com ISBNs repetidos, vale a última linha
+  std::vector<std::uint32_t> order(isbns.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    order[i] = static_cast<std::uint32_t>(i);
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [&isbns](std::uint32_t a, std::uint32_t b) {
+                     return isbns[a] < isbns[b];
+                   });
+  vectors.reserve(raw.size());
+  for (std::size_t i = 0; i < order.size(); ++i) {
+    if (i + 1 < order.size() && isbns[order[i + 1]] == isbns[order[i]]) {
+      continue;
+    }
+    const float* values = raw.data() + std::size_t(order[i]) * dimensions;
+    vectors.insert(vectors.end(), values, values + dimensions);
+    pool += isbns[order[i]];
+    isbnOffsets.push_back(pool.size());
+  }
+  return true;
+}
+
+/**
+ * @brief Sorteia a camada de cada nó (distribuição geométrica com razão
+ * 1/LINKS) e reserva as listas.
+ */
+void EmbeddingIndex::Builder::assignLevels() {
+  std::mt19937_64 random(LEVEL_SEED);
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  const double scale = 1.0 / std::log(double(LINKS));
+  for (std::size_t node = 0; node < size(); ++node) {
+    std::size_t level = std::min(
+        MAX_LEVEL, static_cast<std::size_t>(
+                       -std::log(1.0 - uniform(random)) * scale));
+    levelStarts.push_back(levelStarts.back() +
+                          static_cast<std::uint32_t>(level));
+  }
+  baseLinks.assign(size() * (2 * LINKS + 1), 0);
+  upperLinks.assign(std::size_t(levelStarts.back()) * (LINKS + 1), 0);
+  locks = std::make_unique<std::mutex[]>(LOCK_STRIPES);
+}
+
+/**
+ * @brief Heurística do HNSW: percorre os candidatos do mais para o menos
+ * similar e só fica com os que são mais similares à base do que a todos os
+ * já escolhidos, para que os vizinhos cubram direções diferentes.
+ * @param candidates Do mais para o menos similar à base.
+ */
+std::vector<EmbeddingIndex::Result> EmbeddingIndex::Builder::select(
+    const std::vector<Result>& candidates, std::size_t count) const {
+  std::vector<Result> selected;
+  selected.reserve(count);
+  for (const Result& candidate : candidates) {
+    if (selected.size() == count) break;
+    const float* values = vector(candidate.node).data();
+    bool diverse = true;
+    for (const Result& chosen : selected) {
+      if (dot(values, vector(chosen.node).data(), dimensions) >
+          candidate.score) {
+        diverse = false;
+        break;
+      }
+    }
+    if (diverse) selected.push_back(candidate);
+  }
+  return selected;
+}
+
+/**
+ * @brief Liga o nó aos vizinhos escolhidos em uma camada e cada vizinho de
+ * volta ao nó. Um vizinho com a lista cheia escolhe de novo, pela mesma
+ * heurística, entre os vizinhos que tinha e o nó novo.
+ */
+void EmbeddingIndex::Builder::connect(std::uint32_t node, std::size_t level,
+                                      const std::vector<Result>& found) {
+  const std::size_t capacity = level == 0 ? 2 * LINKS : LINKS;
+  std::vector<Result> candidates;
+  candidates.reserve(found.size());
+  for (const Result& result : found) {
+    if (result.node != node) candidates.push_back(result);
+  }
+  std::vector<Result> selected = select(candidates, LINKS);
+  {
+    std::lock_guard<std::mutex> lock(lockFor(node));
+    std::uint32_t* block = links(node, level);
+    block[0] = static_cast<std::uint32_t>(selected.size());
+    for (std::size_t i = 0; i < selected.size(); ++i) {
+      block[1 + i] = selected[i].node;
+    }
+  }
+
+  for (const Result& neighbor : selected) {
+    std::lock_guard<std::mutex> lock(lockFor(neighbor.node));
+    std::uint32_t* block = links(neighbor.node, level);
+    const std::uint32_t count = block[0];
+    if (std::find(block + 1, block + 1 + count, node) != block + 1 + count) {
+      continue;
+    }
+    if (count < capacity) {
+      block[1 + count] = node;
+      block[0] = count + 1;
+      continue;
+    }
+    const float* values = vector(neighbor.node).data();
+    std::vector<Result> pool{{node, neighbor.score}};
+    for (std::uint32_t i = 0; i < count; ++i) {
+      pool.push_back({block[1 + i],
+                      dot(values, vector(block[1 + i]).data(), dimensions)});
+    }
+    std::sort(pool.begin(), pool.end(), ResultRanking());
+    std::vector<Result> kept = select(pool, capacity);
+    block[0] = static_cast<std::uint32_t>(kept.size());
+    for (std::size_t i = 0; i < kept.size(); ++i) block[1 + i] = kept[i].node;
+  }
+}
+
+/**
+ * @brief Insere um nó: desce de forma gulosa até a camada dele e, dali para
+ * baixo, procura os EF_CONSTRUCTION mais próximos em cada camada e se liga a
+ * eles. Um nó que fica acima da camada máxima atual vira a entrada do grafo;
+ * nesse caso a trava da entrada fica presa durante a inserção inteira.
+ */
+void EmbeddingIndex::Builder::insert(std::uint32_t node) {
+  const float* query = vector(node).data();
+  const std::size_t level = levelOf(node);
+  std::unique_lock<std::mutex> entryLock(entryMutex);
+  const std::size_t top = maxLevel;
+  Result entry{entryPoint, 0};
+  if (level <= top) entryLock.unlock();
+
+  entry.score = dot(query, vector(entry.node).data(), dimensions);
+  for (std::size_t l = top; l > level; --l) descend(*this, query, l, entry);
+  for (std::size_t l = std::min(level, top) + 1; l-- > 0;) {
+    std::vector<Result> found =
+        searchLayer(*this, query, entry, EF_CONSTRUCTION, l);
+    connect(node, l, found);
+    entry = found.front();
+  }
+  if (level > top) {
+    entryPoint = node;
+    maxLevel = level;
+  }
+}
+
+/**
+ * @brief Grava as seções em sequência (tmp + rename), sem montar o arquivo
+ * em memória.
+ */
+bool EmbeddingIndex::Builder::write(const std::string& path,
+                                    std::uint64_t fingerprint) const {
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byteOrder = BYTE_ORDER_MARK;
+  header.fingerprint = fingerprint;
+  header.nodeCount = size();
+  header.dimension = dimensions;
+  header.links = LINKS;
+  header.maxLevel = maxLevel;
+  header.entryPoint = entryPoint;
+  header.upperBlocks = levelStarts.back();
+
+  std::size_t offset = align8(sizeof(header));
+  auto reserveSection = [&offset](std::size_t bytes) {
+    std::size_t start = offset;
+    offset = align8(offset + bytes);
+    return start;
+  };
+  header.vectorsOffset = reserveSection(vectors.size() * sizeof(float));
+  header.isbnOffsetsOffset =
+      reserveSection(isbnOffsets.size() * sizeof(std::uint64_t));
+  header.levelStartsOffset =
+      reserveSection(levelStarts.size() * sizeof(std::uint32_t));
+  header.baseLinksOffset =
+      reserveSection(baseLinks.size() * sizeof(std::uint32_t));
+  header.upperLinksOffset =
+      reserveSection(upperLinks.size() * sizeof(std::uint32_t));
+  header.poolOffset = reserveSection(pool.size());
+  header.poolSize = pool.size();
+
+  std::string tempPath = path + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    std::size_t written = 0;
+    auto put = [&out, &written](std::size_t at, const void* data,
+                                std::size_t size) {
+      static const char padding[8] = {};
+      out.write(padding, static_cast<std::streamsize>(at - written));
+      out.write(static_cast<const char*>(data),
+                static_cast<std::streamsize>(size));
+      written = at + size;
+    };
+    put(0, &header, sizeof(header));
+    put(header.vectorsOffset, vectors.data(), vectors.size() * sizeof(float));
+    put(header.isbnOffsetsOffset, isbnOffsets.data(),
+        isbnOffsets.size() * sizeof(std::uint64_t));
+    put(header.levelStartsOffset, levelStarts.data(),
+        levelStarts.size() * sizeof(std::uint32_t));
+    put(header.baseLinksOffset, baseLinks.data(),
+        baseLinks.size() * sizeof(std::uint32_t));
+    put(header.upperLinksOffset, upperLinks.data(),
+        upperLinks.size() * sizeof(std::uint32_t));
+    put(header.poolOffset, pool.data(), pool.size());
+    put(offset, nullptr, 0);
+    if (!out) return false;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    std::cerr << "Erro ao salvar índice de vetores: " << ec.message()
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// --- EmbeddingIndex ---
+
+EmbeddingIndex::~EmbeddingIndex() {
+#ifndef _WIN32
+  if (mapped && base) munmap(const_cast<char*>(base), length);
+#endif
+}
+
+/**
+ * @brief Insere o primeiro nó (a entrada inicial) e os demais em paralelo,
+ * NODES_PER_TASK por tarefa.
+ */
+bool EmbeddingIndex::build(const std::string& source, const std::string& path,
+                           std::uint64_t fingerprint, std::string& error) {
+  Builder builder;
+  if (!builder.read(source, error)) return false;
+  builder.assignLevels();
+  const std::size_t nodes = builder.size();
+  if (nodes > 0) {
+    builder.maxLevel = builder.levelOf(0);
+    const std::size_t tasks = (nodes - 1 + NODES_PER_TASK - 1) / NODES_PER_TASK;
+    ThreadPool::shared().parallelFor(tasks, [&](std::size_t task) {
+      const std::size_t begin = 1 + task * NODES_PER_TASK;
+      const std::size_t end = std::min(nodes, begin + NODES_PER_TASK);
+      for (std::size_t node = begin; node < end; ++node) {
+        builder.insert(static_cast<std::uint32_t>(node));
+      }
+    });
+  }
+  if (!builder.write(path, fingerprint)) {
+    error = "não foi possível gravar '" + path + "'";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Mapeia o arquivo em memória e valida o seu conteúdo.
+ * @return true se o arquivo é um índice válido, false caso contrário.
+ */
+bool EmbeddingIndex::map(const std::string& path) {
+#ifndef _WIN32
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(Header))) {
+    ::close(fd);
+    return false;
+  }
+  length = static_cast<std::size_t>(st.st_size);
+  void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) return false;
+  base = static_cast<const char*>(addr);
+  mapped = true;
+#else
+  // Sem mmap: o arquivo é lido de uma vez para um buffer alinhado
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in.is_open()) return false;
+  length = static_cast<std::size_t>(in.tellg());
+  if (length < sizeof(Header)) return false;
+  buffer.resize(length);
+  in.seekg(0);
+  in.read(buffer.data(), static_cast<std::streamsize>(length));
+  if (!in) return false;
+  base = buffer.data();
+#endif
+  return bind();
+}
+
+/**
+ * @brief Valida o cabeçalho e as seções e aponta os campos para elas. As
+ * listas de vizinhos não são percorridas aqui (o arquivo seria lido
+ * inteiro); a busca ignora nós e quantidades fora dos limites.
+ */
+bool EmbeddingIndex::bind() {
+  if (length < sizeof(Header)) return false;
+  Header header;
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version != VERSION || header.byteOrder != BYTE_ORDER_MARK ||
+      header.links != LINKS) {
+    return false;
+  }
+  auto inBounds = [this](std::uint64_t offset, std::uint64_t count,
+                         std::uint64_t size) {
+    return offset % 8 == 0 && offset <= length &&
+           count <= (length - offset) / size;
+  };
+  const std::uint64_t n = header.nodeCount;
+  if (n >= UINT32_MAX || header.dimension == 0 ||
+      (n > 0 && (header.entryPoint >= n || header.maxLevel > MAX_LEVEL)) ||
+      n > length / header.dimension ||
+      !inBounds(header.vectorsOffset, n * header.dimension, sizeof(float)) ||
+      !inBounds(header.isbnOffsetsOffset, n + 1, sizeof(std::uint64_t)) ||
+      !inBounds(header.levelStartsOffset, n + 1, sizeof(std::uint32_t)) ||
+      !inBounds(header.baseLinksOffset, n * (2 * LINKS + 1),
+                sizeof(std::uint32_t)) ||
+      header.upperBlocks > length ||
+      !inBounds(header.upperLinksOffset, header.upperBlocks * (LINKS + 1),
+                sizeof(std::uint32_t)) ||
+      !inBounds(header.poolOffset, header.poolSize, 1)) {
+    return false;
+  }
+
+  fingerprint = header.fingerprint;
+  nodeCount = n;
+  dimensions = header.dimension;
+  maxLevel = header.maxLevel;
+  entryPoint = static_cast<std::uint32_t>(header.entryPoint);
+  upperBlocks = header.upperBlocks;
+  vectors = reinterpret_cast<const float*>(base + header.vectorsOffset);
+  isbnOffsets =
+      reinterpret_cast<const std::uint64_t*>(base + header.isbnOffsetsOffset);
+  levelStarts =
+      reinterpret_cast<const std::uint32_t*>(base + header.levelStartsOffset);
+  baseLinks =
+      reinterpret_cast<const std::uint32_t*>(base + header.baseLinksOffset);
+  upperLinks =
+      reinterpret_cast<const std::uint32_t*>(base + header.upperLinksOffset);
+  pool = base + header.poolOffset;
+
+  // Os ISBNs precisam cair dentro do pool e os blocos de cima, na seção
+  if (isbnOffsets[0] != 0 || isbnOffsets[n] > header.poolSize ||
+      levelStarts[0] != 0 || levelStarts[n] != upperBlocks) {
+    return false;
+  }
+  for (std::size_t node = 0; node < n; ++node) {
+    if (isbnOffsets[node] > isbnOffsets[node + 1] ||
+        levelStarts[node] > levelStarts[node + 1]) {
+      return false;
+    }
+  }
+  return n == 0 || levelStarts[entryPoint + 1] - levelStarts[entryPoint] ==
+                       maxLevel;
+}
+
+std::shared_ptr<const EmbeddingIndex> EmbeddingIndex::open(
+    const std::string& path) {
+  std::shared_ptr<EmbeddingIndex> index(new EmbeddingIndex());
+  if (!index->map(path)) return nullptr;
+  return index;
+}
+
+std::string EmbeddingIndex::sourcePathFor(
+    const DataManager& booksDataManager) {
+  std::filesystem::path path(booksDataManager.getDirectoryPath());
+  path /= "embeddings.jsonl";
+  return path.string();
+}
+
+std::string EmbeddingIndex::pathFor(const DataManager& booksDataManager) {
+  std::filesystem::path path(booksDataManager.getFullPath());
+  path.replace_extension(".hnsw");
+  return path.string();
+}
+
+std::uint64_t EmbeddingIndex::fingerprintOf(const std::string& path) {
+  std::error_code ec;
+  const std::uintmax_t size = std::filesystem::file_size(path, ec);
+  if (ec) return 0;
+  const auto mtime = std::filesystem::last_write_time(path, ec);
+  if (ec) return 0;
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (std::uint64_t value :
+       {static_cast<std::uint64_t>(size),
+        static_cast<std::uint64_t>(mtime.time_since_epoch().count())}) {
+    for (int i = 0; i < 8; ++i) {
+      hash ^= (value >> (i * 8)) & 0xFF;
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+namespace {
+
+/**
+ * @brief Índice aberto de um caminho (books.hnsw).
+ */
+struct CachedIndex {
+  std::shared_ptr<const EmbeddingIndex> index;
+  std::uint64_t failed = 0;  // Impressão digital cuja construção falhou
+  bool rebuilding = false;   // Construção agendada em segundo plano
+};
+
+/**
+ * @brief Índices abertos por caminho, compartilhados por openFor e
+ * refreshFor.
+ */
+struct IndexCache {
+  std::mutex mutex;  // Protege opened
+  std::unordered_map<std::string, CachedIndex> opened;
+  std::mutex buildMutex;  // Uma construção por vez
+};
+
+IndexCache& indexCache() {
+  // Nunca destruído: uma construção em segundo plano pode terminar depois
+  // dos destrutores estáticos
+  static IndexCache* cache = new IndexCache();
+  return *cache;
+}
+
+/**
+ * @brief Deixa o índice de um caminho em dia com o embeddings.jsonl,
+ * construindo-o se preciso, e o publica. A construção roda fora de
+ * cache.mutex: quem chama openFor enquanto isso recebe o índice anterior.
+ * Uma falha é lembrada para não ser repetida enquanto o arquivo não mudar
+ * (e o índice anterior continua valendo).
+ */
+std::shared_ptr<const EmbeddingIndex> refreshIndex(const std::string& source,
+                                                   const std::string& path) {
+  IndexCache& cache = indexCache();
+  std::lock_guard<std::mutex> buildLock(cache.buildMutex);
+  const std::uint64_t current = EmbeddingIndex::fingerprintOf(source);
+  std::shared_ptr<const EmbeddingIndex> previous;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    CachedIndex& cached = cache.opened[path];
+    previous = cached.index;
+    if (previous && (current == 0 || previous->getFingerprint() == current ||
+                     cached.failed == current)) {
+      return previous;
+    }
+    if (!previous && current != 0 && cached.failed == current) {
+      return nullptr;
+    }
+  }
+
+  std::shared_ptr<const EmbeddingIndex> index = EmbeddingIndex::open(path);
+  bool failed = false;
+  if (current != 0 && (!index || index->getFingerprint() != current)) {
+    std::string error;
+    std::shared_ptr<const EmbeddingIndex> built;
+    if (EmbeddingIndex::build(source, path, current, error)) {
+      built = EmbeddingIndex::open(path);
+    }
+    if (!built) {
+      std::cerr << "Erro ao indexar os vetores: "
+                << (error.empty() ? "arquivo inválido" : error) << std::endl;
+      failed = true;
+    }
+    index = built;
+  }
+
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  CachedIndex& cached = cache.opened[path];
+  if (failed) {
+    cached.failed = current;
+  } else {
+    cached.index = index;
+  }
+  return cached.index;
+}
+
+}  // namespace
+
+/**
+ * @brief Devolve o índice aberto sem esperar construções: se o
+ * embeddings.jsonl mudou, agenda a reconstrução em segundo plano
+ * (ThreadPool::background) e devolve o índice anterior. Na primeira chamada,
+ * um books.hnsw antigo também é servido enquanto isso; só sem nenhum
+ * books.hnsw a construção é esperada.
+ */
+std::shared_ptr<const EmbeddingIndex> EmbeddingIndex::openFor(
+    const DataManager& booksDataManager) {
+  const std::string source = sourcePathFor(booksDataManager);
+  const std::string path = pathFor(booksDataManager);
+  const std::uint64_t current = fingerprintOf(source);
+  IndexCache& cache = indexCache();
+
+  std::shared_ptr<const EmbeddingIndex> served;
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    CachedIndex& cached = cache.opened[path];
+    if (!cached.index) cached.index = open(path);  // Só mapeia o arquivo
+    served = cached.index;
+    if (served && current != 0 && served->getFingerprint() != current &&
+        cached.failed != current && !cached.rebuilding) {
+      cached.rebuilding = true;
+      schedule = true;
+    }
+  }
+  if (!served) return refreshIndex(source, path);
+  if (schedule) {
+    // Fora de shared(), para que build() possa usar todas as threads dele
+    ThreadPool::background().submit([source, path] {
+      try {
+        refreshIndex(source, path);
+      } catch (const std::exception& e) {
+        std::cerr << "Erro ao indexar os vetores: " << e.what() << std::endl;
+      }
+      IndexCache& cache = indexCache();
+      std::lock_guard<std::mutex> lock(cache.mutex);
+      cache.opened[path].rebuilding = false;
+    });
+  }
+  return served;
+}
+
+std::shared_ptr<const EmbeddingIndex> EmbeddingIndex::refreshFor(
+    const DataManager& booksDataManager) {
+  return refreshIndex(sourcePathFor(booksDataManager),
+                      pathFor(booksDataManager));
+}
+
+std::size_t EmbeddingIndex::size() const { return nodeCount; }
+std::size_t EmbeddingIndex::dimension() const { return dimensions; }
+std::uint64_t EmbeddingIndex::getFingerprint() const { return fingerprint; }
+std::size_t EmbeddingIndex::levels() const {
+  return nodeCount == 0 ? 0 : maxLevel + 1;
+}
+
+std::optional<std::uint32_t> EmbeddingIndex::find(std::string_view isbn) const {
+  std::uint32_t low = 0;
+  std::uint32_t high = static_cast<std::uint32_t>(nodeCount);
+  while (low < high) {
+    std::uint32_t middle = low + (high - low) / 2;
+    if (this->isbn(middle) < isbn) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low < nodeCount && this->isbn(low) == isbn) return low;
+  return std::nullopt;
+}
+
+std::string_view EmbeddingIndex::isbn(std::uint32_t node) const {
+  return std::string_view(pool + isbnOffsets[node],
+                          isbnOffsets[node + 1] - isbnOffsets[node]);
+}
+
+std::span<const float> EmbeddingIndex::vector(std::uint32_t node) const {
+  return {vectors + std::size_t(node) * dimensions, dimensions};
+}
+
+/**
+ * @brief Visita a lista de um nó em uma camada, ignorando o que estiver fora
+ * dos limites.
+ */
+template <typename Visit>
+void EmbeddingIndex::forEachLink(std::uint32_t node, std::size_t level,
+                                 Visit&& visit) const {
+  const std::uint32_t* block;
+  std::uint32_t capacity;
+  if (level == 0) {
+    block = baseLinks + std::size_t(node) * (2 * LINKS + 1);
+    capacity = 2 * LINKS;
+  } else {
+    if (levelStarts[node] + level > levelStarts[node + 1]) return;
+    block = upperLinks + (std::size_t(levelStarts[node]) + level - 1) *
+                             (LINKS + 1);
+    capacity = LINKS;
+  }
+  const std::uint32_t count = std::min(block[0], capacity);
+  for (std::uint32_t i = 0; i < count; ++i) {
+    if (block[1 + i] < nodeCount) visit(block[1 + i]);
+  }
+}
+
+/**
+ * @brief Busca gulosa em uma camada: troca a entrada pelo vizinho mais
+ * similar à consulta enquanto houver um melhor.
+ */
+template <typename Graph>
+void EmbeddingIndex::descend(const Graph& graph, const float* query,
+                             std::size_t level, Result& entry) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    graph.forEachLink(entry.node, level, [&](std::uint32_t next) {
+      Result candidate{next, dot(query, graph.vector(next).data(),
+                                 graph.dimension())};
+      if (ResultRanking()(candidate, entry)) {
+        entry = candidate;
+        changed = true;
+      }
+    });
+  }
+}
+
+/**
+ * @brief Busca em largura limitada em uma camada: expande sempre o candidato
+ * mais similar ainda não expandido e para quando ele é pior que o pior dos ef
+ * melhores encontrados.
+ * @return Os até ef melhores, do mais para o menos similar.
+ */
+template <typename Graph>
+std::vector<EmbeddingIndex::Result> EmbeddingIndex::searchLayer(
+    const Graph& graph, const float* query, Result entry, std::size_t ef,
+    std::size_t level) {
+  VisitedSet& visited = VisitedSet::next(graph.size());
+  std::priority_queue<Result, std::vector<Result>, ResultRankingReversed>
+      candidates;  // Topo: o melhor
+  std::priority_queue<Result, std::vector<Result>, ResultRanking>
+      best;  // Topo: o pior
+  visited.insert(entry.node);
+  candidates.push(entry);
+  best.push(entry);
+  while (!candidates.empty()) {
+    const Result current = candidates.top();
+    if (best.size() >= ef && ResultRanking()(best.top(), current)) break;
+    candidates.pop();
+    graph.forEachLink(current.node, level, [&](std::uint32_t next) {
+      if (!visited.insert(next)) return;
+      Result candidate{next, dot(query, graph.vector(next).data(),
+                                 graph.dimension())};
+      if (best.size() < ef || ResultRanking()(candidate, best.top())) {
+        candidates.push(candidate);
+        best.push(candidate);
+        if (best.size() > ef) best.pop();
+      }
+    });
+  }
+  std::vector<Result> results(best.size());
+  for (std::size_t i = results.size(); i-- > 0; best.pop()) {
+    results[i] = best.top();
+  }
+  return results;
+}
+
+std::vector<EmbeddingIndex::Result> EmbeddingIndex::search(
+    std::span<const float> query, std::size_t k, std::size_t ef) const {
+  if (nodeCount == 0 || k == 0 || query.size() != dimensions) return {};
+  Result entry{entryPoint,
+               dot(query.data(), vector(entryPoint).data(), dimensions)};
+  for (std::size_t level = maxLevel; level > 0; --level) {
+    descend(*this, query.data(), level, entry);
+  }
+  std::vector<Result> results =
+      searchLayer(*this, query.data(), entry, std::max(ef, k), 0);
+  if (results.size() > k) results.resize(k);
+  return results;
+}
+
+std::vector<EmbeddingIndex::Result> EmbeddingIndex::exact(
+    std::span<const float> query, std::size_t k) const {
+  if (query.size() != dimensions) return {};
+  TopK<Result, ResultRanking> top(k);
+  std::mutex mutex;
+  const std::size_t tasks = (nodeCount + NODES_PER_TASK - 1) / NODES_PER_TASK;
+  ThreadPool::shared().parallelFor(tasks, [&](std::size_t task) {
+    TopK<Result, ResultRanking> local(k);
+    const std::size_t end =
+        std::min(nodeCount, (task + 1) * NODES_PER_TASK);
+    for (std::size_t node = task * NODES_PER_TASK; node < end; ++node) {
+      local.push({static_cast<std::uint32_t>(node),
+                  dot(query.data(), vectors + node * dimensions, dimensions)});
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    top.merge(std::move(local));
+  });
+  return top.take();
+}
@@ -0,0 +1,213 @@
+/**
+ * @file: EmbeddingIndex.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do índice HNSW dos vetores (embeddings) dos livros,
+ * lido via mmap.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef EMBEDDING_INDEX_H
+#define EMBEDDING_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../DataManager/DataManager.h"
+
+/**
+ * @class EmbeddingIndex
+ * @brief Busca aproximada dos vizinhos mais próximos (HNSW) entre os vetores
+ * dos livros, para recomendações semânticas sem comparar a consulta com o
+ * catálogo inteiro.
+ *
+ * Os vetores são gerados fora do BookMatch (ex: um modelo de embeddings de
+ * texto) e gravados em embeddings.jsonl, ao lado do books.json, um livro por
+ * linha: {"isbn": "...", "vector": [0.1, ...]}, todos com a mesma dimensão.
+ * Ao ser lido, cada vetor é normalizado, de forma que a similaridade é o
+ * cosseno (produto escalar, com AVX2/SSE2 quando disponível).
+ *
+ * O grafo tem várias camadas: cada livro entra até uma camada sorteada
+ * (cada camada tem cerca de 1/LINKS dos livros da camada de baixo) e, em cada
+ * uma, fica ligado a até LINKS vizinhos (2 * LINKS na camada 0), escolhidos
+ * pela heurística do HNSW para cobrir direções diferentes. Uma busca desce
+ * de forma gulosa pelas camadas de cima e, na camada 0, mantém os ef
+ * melhores candidatos: um ef maior aumenta a revocação e o custo.
+ *
+ * Os livros são inseridos em paralelo (ThreadPool::shared), com uma trava por
+ * faixa de nós para as listas de vizinhos; com mais de uma thread, o grafo
+ * depende da ordem em que as inserções terminam. O resultado é gravado em
+ * books.hnsw (vetores, ISBNs e listas em seções de tamanho fixo, alinhadas
+ * em 8 bytes), com a impressão digital do embeddings.jsonl, e lido via mmap
+ * sem cópias nas próximas execuções; o arquivo é refeito em segundo plano
+ * (ThreadPool::background) quando o embeddings.jsonl muda.
+ */
+class EmbeddingIndex {
+ public:
+  /**
+   * @brief Um resultado da busca: o nó (ver isbn()) e o cosseno.
+   */
+  struct Result {
+    std::uint32_t node;
+    float score;
+  };
+
+  /**
+   * @brief Vizinhos de cada nó por camada (o dobro na camada 0).
+   */
+  static const std::size_t LINKS = 16;
+
+  /**
+   * @brief Candidatos mantidos ao procurar os vizinhos de um nó inserido.
+   */
+  static const std::size_t EF_CONSTRUCTION = 100;
+
+  /**
+   * @brief Candidatos mantidos por padrão em uma busca.
+   */
+  static const std::size_t DEFAULT_EF = 64;
+
+  ~EmbeddingIndex();
+  EmbeddingIndex(const EmbeddingIndex&) = delete;
+  EmbeddingIndex& operator=(const EmbeddingIndex&) = delete;
+
+  /**
+   * @brief Lê os vetores de um arquivo JSON Lines e grava o índice (tmp +
+   * rename). Linhas vazias e vetores nulos são ignorados; com ISBNs
+   * repetidos, vale a última linha.
+   * @param source O arquivo dos vetores.
+   * @param path O caminho do índice.
+   * @param fingerprint Impressão digital da origem (ver fingerprintOf).
+   * @param error Mensagem de erro (com o número da linha), se falhar.
+   * @return true se o índice foi gravado.
+   */
+  static bool build(const std::string& source, const std::string& path,
+                    std::uint64_t fingerprint, std::string& error);
+
+  /**
+   * @brief Mapeia um índice em memória.
+   * @return O índice, ou nullptr se o arquivo não existe ou é inválido.
+   */
+  static std::shared_ptr<const EmbeddingIndex> open(const std::string& path);
+
+  /**
+   * @brief Abre o índice dos vetores do diretório de um catálogo. Se o
+   * embeddings.jsonl mudou, o índice é reconstruído em segundo plano e o
+   * anterior continua sendo devolvido; só sem nenhum books.hnsw a
+   * construção é esperada. Sem embeddings.jsonl, usa o books.hnsw que
+   * existir.
+   * @return O índice, ou nullptr se não há vetores.
+   */
+  static std::shared_ptr<const EmbeddingIndex> openFor(
+      const DataManager& booksDataManager);
+
+  /**
+   * @brief Como openFor, mas espera a reconstrução quando o
+   * embeddings.jsonl mudou (usado antes da primeira requisição do servidor
+   * e na avaliação).
+   * @return O índice, ou nullptr se não há vetores.
+   */
+  static std::shared_ptr<const EmbeddingIndex> refreshFor(
+      const DataManager& booksDataManager);
+
+  /**
+   * @brief Caminho do arquivo dos vetores (embeddings.jsonl) de um catálogo.
+   */
+  static std::string sourcePathFor(const DataManager& booksDataManager);
+
+  /**
+   * @brief Caminho do índice (books.hnsw) de um catálogo.
+   */
+  static std::string pathFor(const DataManager& booksDataManager);
+
+  /**
+   * @brief Impressão digital (tamanho + mtime) de um arquivo; 0 se ele não
+   * existe.
+   */
+  static std::uint64_t fingerprintOf(const std::string& path);
+
+  std::size_t size() const;
+  std::size_t dimension() const;
+  std::uint64_t getFingerprint() const;
+
+  /**
+   * @brief Quantidade de camadas do grafo.
+   */
+  std::size_t levels() const;
+
+  /**
+   * @brief Procura o nó de um ISBN (os nós estão em ordem de ISBN).
+   */
+  std::optional<std::uint32_t> find(std::string_view isbn) const;
+
+  std::string_view isbn(std::uint32_t node) const;
+
+  /**
+   * @brief O vetor (normalizado) de um nó.
+   */
+  std::span<const float> vector(std::uint32_t node) const;
+
+  /**
+   * @brief Os k nós mais próximos de uma consulta (aproximado).
+   * @param query Vetor com dimension() valores, de norma 1.
+   * @param ef Candidatos mantidos na camada 0 (no mínimo k).
+   * @return Do mais para o menos similar.
+   */
+  std::vector<Result> search(std::span<const float> query, std::size_t k,
+                             std::size_t ef = DEFAULT_EF) const;
+
+  /**
+   * @brief Os k nós mais próximos por força bruta (todos os vetores, em
+   * paralelo), para medir a revocação de search().
+   */
+  std::vector<Result> exact(std::span<const float> query,
+                            std::size_t k) const;
+
+ private:
+  struct Header;
+  struct Builder;
+
+  EmbeddingIndex() = default;
+  bool map(const std::string& path);
+  bool bind();
+
+  template <typename Visit>
+  void forEachLink(std::uint32_t node, std::size_t level,
+                   Visit&& visit) const;
+  template <typename Graph>
+  static void descend(const Graph& graph, const float* query,
+                      std::size_t level, Result& entry);
+  template <typename Graph>
+  static std::vector<Result> searchLayer(const Graph& graph,
+                                         const float* query, Result entry,
+                                         std::size_t ef, std::size_t level);
+
+  const char* base = nullptr;
+  std::size_t length = 0;
+  std::vector<char> buffer;  // Usado quando mmap não está disponível
+  bool mapped = false;
+
+  std::uint64_t fingerprint = 0;
+  std::size_t nodeCount = 0;
+  std::size_t dimensions = 0;
+  std::size_t maxLevel = 0;
+  std::uint32_t entryPoint = 0;
+  std::size_t upperBlocks = 0;
+  const float* vectors = nullptr;
+  const std::uint64_t* isbnOffsets = nullptr;
+  const std::uint32_t* levelStarts = nullptr;  // Nó -> 1º bloco de cima
+  const std::uint32_t* baseLinks = nullptr;    // Camada 0
+  const std::uint32_t* upperLinks = nullptr;   // Camadas 1 em diante
+  const char* pool = nullptr;
+};
+
+#endif  // EMBEDDING_INDEX_H
@@ -0,0 +1,534 @@
+/**
+ * @file: Recommendations.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação das recomendações por usuário.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "Recommendations.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "../History/History.h"
+#include "../Utils/TopK.h"
+
+namespace {
+
+// Livros guardados além dos exibidos, para que a lista continue válida
+// quando os primeiros entram no histórico
+const std::size_t RESERVE = 5;
+// Quantos dos últimos livros do histórico fornecem as tags
+const std::size_t RECENT_HISTORY = 3;
+// Tamanho da lista (global) dos livros mais recentes do catálogo
+const std::size_t RECENT_BOOKS = 64;
+// Quantos dos últimos livros do histórico fornecem os vizinhos
+const std::size_t NEIGHBOR_HISTORY = 10;
+// Quantos dos últimos livros do histórico entram na média dos vetores
+const std::size_t EMBEDDING_HISTORY = 5;
+
+/**
+ * @brief Ordem das recomendações por vizinhos: maior soma das similaridades
+ * primeiro, depois a maior média bayesiana das notas e, por fim, a linha do
+ * catálogo (ordem de ISBN).
+ */
+struct NeighborRanking {
+  bool operator()(const std::tuple<float, double, std::uint32_t>& a,
+                  const std::tuple<float, double, std::uint32_t>& b) const {
+    if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) > std::get<0>(b);
+    if (std::get<1>(a) != std::get<1>(b)) return std::get<1>(a) > std::get<1>(b);
+    return std::get<2>(a) < std::get<2>(b);
+  }
+};
+
+/**
+ * @brief Ordem das recomendações por tags: mais tags em comum primeiro, depois
+ * a maior média bayesiana das notas, createdDate mais recente e, por fim, a
+ * linha do catálogo (ordem de ISBN).
+ */
+struct TagRanking {
+  using Candidate = std::tuple<int, double, std::string_view, std::size_t>;
+  bool operator()(const Candidate& a, const Candidate& b) const {
+    if (std::get<0>(a) != std::get<0>(b)) return std::get<0>(a) > std::get<0>(b);
+    if (std::get<1>(a) != std::get<1>(b)) return std::get<1>(a) > std::get<1>(b);
+    if (std::get<2>(a) != std::get<2>(b)) return std::get<2>(a) > std::get<2>(b);
+    return std::get<3>(a) < std::get<3>(b);
+  }
+};
+
+/**
+ * @brief Ordem das recomendações por novidade: createdDate mais recente
+ * primeiro e, em caso de empate, a linha do catálogo (ordem de ISBN).
+ */
+struct RecencyRanking {
+  bool operator()(const std::pair<std::string_view, std::size_t>& a,
+                  const std::pair<std::string_view, std::size_t>& b) const {
+    if (a.first != b.first) return a.first > b.first;  // Mais recente primeiro
+    return a.second < b.second;
+  }
+};
+
+/**
+ * @brief Os RECENT_BOOKS livros mais recentes do catálogo, do mais novo para
+ * o mais antigo. A lista não depende do usuário, então é calculada uma vez
+ * por versão do catálogo e compartilhada.
+ */
+std::shared_ptr<const std::vector<std::uint32_t>> recentRows(
+    const BinaryCatalog& books) {
+  static std::mutex mutex;
+  static std::uint64_t fingerprint = 0;
+  static std::size_t size = 0;
+  static std::shared_ptr<const std::vector<std::uint32_t>> rows;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (rows && fingerprint == books.getFingerprint() && size == books.size()) {
+    return rows;
+  }
+  TopK<std::pair<std::string_view, std::size_t>, RecencyRanking> top(
+      RECENT_BOOKS);
+  for (std::size_t row = 0; row < books.size(); ++row) {
+    top.push({books.field(BinaryCatalog::CREATED_DATE, row), row});
+  }
+  auto result = std::make_shared<std::vector<std::uint32_t>>();
+  for (const auto& book : top.take()) {
+    result->push_back(static_cast<std::uint32_t>(book.second));
+  }
+  fingerprint = books.getFingerprint();
+  size = books.size();
+  rows = result;
+  return rows;
+}
+
+/**
+ * @brief IDs (ordenados e sem repetição) das tags dos últimos livros do
+ * histórico.
+ */
+std::vector<std::uint32_t> historyTags(const BinaryCatalog& books,
+                                       const std::vector<std::string>& history) {
+  std::vector<std::uint32_t> tags;
+  std::size_t lastN = std::min(history.size(), RECENT_HISTORY);
+  // Coleta tags dos últimos N livros do histórico (mais recentes)
+  for (std::size_t idx = 0; idx < lastN; ++idx) {
+    std::size_t i = history.size() - 1 - idx;
+    std::optional<std::size_t> row = books.find(history[i]);
+    if (!row) continue;
+    std::span<const std::uint32_t> tagSet = books.tagSet(*row);
+    tags.insert(tags.end(), tagSet.begin(), tagSet.end());
+  }
+  std::sort(tags.begin(), tags.end());
+  tags.erase(std::unique(tags.begin(), tags.end()), tags.end());
+  return tags;
+}
+
+/**
+ * @brief Combina os hashes (CoOccurrence::Model::digest) das listas de
+ * vizinhos dos últimos livros do histórico, as únicas que uma lista de
+ * recomendações usa: atualizações do modelo que não tocam nelas não a
+ * invalidam.
+ * @return 0 sem modelo.
+ */
+std::uint64_t neighborsDigest(const BinaryCatalog& books,
+                              const CoOccurrence::Model* neighbors,
+                              std::span<const std::string> history) {
+  if (!neighbors) return 0;
+  std::uint64_t hash = 14695981039346656037ULL;
+  std::size_t lastN = std::min(history.size(), NEIGHBOR_HISTORY);
+  for (std::size_t idx = 0; idx < lastN; ++idx) {
+    std::optional<std::size_t> row =
+        books.find(history[history.size() - 1 - idx]);
+    if (!row) continue;
+    hash = (hash ^ neighbors->digest(*row)) * 1099511628211ULL;
+  }
+  return hash | 1;
+}
+
+/**
+ * @brief Diretório e arquivo das recomendações de um usuário, dentro do
+ * diretório do history.json.
+ */
+DataManager openShard(const DataManager& historyDataManager,
+                      const std::string& username) {
+  auto [directory, file] = History::shardPath(username);
+  std::filesystem::path path(historyDataManager.getDirectoryPath());
+  path /= "recommendations";
+  path /= directory;
+  return DataManager(file, path.string());
+}
+
+}  // namespace
+
+Recommendations::Recommendations(DataManager& booksDataManager,
+                                 const DataManager& historyDataManager,
+                                 const std::string& username)
+    : store(openShard(historyDataManager, username)),
+      booksDataManager(booksDataManager),
+      username(username),
+      coOccurrence(
+          CoOccurrence::forHistory(booksDataManager, historyDataManager)),
+      ratings(Ratings::forBooks(booksDataManager)) {}
+
+json Recommendations::toJson(const Entry& entry) {
+  return {{"catalog", entry.catalog},
+          {"model", entry.model},
+          {"ratings", entry.ratings},
+          {"embeddings", entry.embeddings},
+          {"history", entry.historySize},
+          {"last", entry.lastIsbn},
+          {"byNeighbors", entry.byNeighbors},
+          {"byEmbeddings", entry.byEmbeddings},
+          {"byTags", entry.byTags},
+          {"complete", entry.complete},
+          {"tags", entry.tags},
+          {"isbns", entry.isbns}};
+}
+
+bool Recommendations::fromJson(const json& value, Entry& entry) {
+  if (!value.is_object()) return false;
+  try {
+    entry.catalog = value.at("catalog").get<std::uint64_t>();
+    entry.model = value.at("model").get<std::uint64_t>();
+    entry.ratings = value.at("ratings").get<std::uint64_t>();
+    entry.embeddings = value.at("embeddings").get<std::uint64_t>();
+    entry.historySize = value.at("history").get<std::size_t>();
+    entry.lastIsbn = value.at("last").get<std::string>();
+    entry.byNeighbors = value.at("byNeighbors").get<bool>();
+    entry.byEmbeddings = value.at("byEmbeddings").get<bool>();
+    entry.byTags = value.at("byTags").get<bool>();
+    entry.complete = value.at("complete").get<bool>();
+    entry.tags = value.at("tags").get<std::vector<std::uint32_t>>();
+    entry.isbns = value.at("isbns").get<std::vector<std::string>>();
+  } catch (const json::exception&) {
+    return false;  // Formato desconhecido: a lista é recalculada
+  }
+  return true;
+}
+
+/**
+ * @brief Informa se a lista guardada foi calculada para este catálogo, estes
+ * vizinhos, estes vetores, estas notas e este histórico.
+ */
+bool Recommendations::matches(const Entry& entry, const BinaryCatalog& books,
+                              const CoOccurrence::Model* neighbors,
+                              const EmbeddingIndex* embeddings,
+                              const std::vector<std::string>& history) const {
+  return entry.catalog == books.getFingerprint() &&
+         entry.model == neighborsDigest(books, neighbors, history) &&
+         entry.embeddings == (embeddings ? embeddings->getFingerprint() : 0) &&
+         entry.ratings == ratings.fingerprint(entry.isbns) &&
+         entry.historySize == history.size() &&
+         entry.lastIsbn == (history.empty() ? "" : history.back());
+}
+
+/**
+ * @brief Calcula a lista do zero. Os vizinhos dos últimos livros são somados
+ * por livro; os vetores dos últimos livros viram uma consulta ao índice HNSW
+ * (a média normalizada); as tags dos livros são obtidas pelas listas
+ * (ordenadas por linha) de cada tag do usuário, então só os livros com
+ * alguma tag em comum são visitados.
+ */
+Recommendations::Entry Recommendations::compute(
+    const BinaryCatalog& books, const CoOccurrence::Model* neighbors,
+    const EmbeddingIndex* embeddings, const std::vector<std::string>& history,
+    std::pmr::memory_resource* memory) {
+  Entry entry;
+  entry.catalog = books.getFingerprint();
+  entry.model = neighborsDigest(books, neighbors, history);
+  entry.embeddings = embeddings ? embeddings->getFingerprint() : 0;
+  entry.historySize = history.size();
+  entry.lastIsbn = history.empty() ? "" : history.back();
+  entry.tags = historyTags(books, history);
+  const std::size_t capacity = LIMIT + RESERVE;
+
+  // Linhas dos livros do histórico, que não devem ser recomendados
+  std::pmr::vector<std::uint32_t> seenRows(memory);
+  seenRows.reserve(history.size());
+  for (const std::string& isbn : history) {
+    if (std::optional<std::size_t> row = books.find(isbn)) {
+      seenRows.push_back(static_cast<std::uint32_t>(*row));
+    }
+  }
+  std::sort(seenRows.begin(), seenRows.end());
+  auto seen = [&seenRows](std::uint32_t row) {
+    return std::binary_search(seenRows.begin(), seenRows.end(), row);
+  };
+
+  // Linhas já escolhidas pelos vizinhos
+  std::pmr::vector<std::uint32_t> chosenRows(memory);
+  if (neighbors) {
+    std::pmr::vector<CoOccurrence::Neighbor> similar(memory);
+    std::size_t lastN = std::min(history.size(), NEIGHBOR_HISTORY);
+    for (std::size_t idx = 0; idx < lastN; ++idx) {
+      std::optional<std::size_t> row =
+          books.find(history[history.size() - 1 - idx]);
+      if (!row) continue;
+      for (const CoOccurrence::Neighbor& neighbor :
+           neighbors->neighbors(*row)) {
+        if (!seen(neighbor.row)) similar.push_back(neighbor);
+      }
+    }
+    std::sort(similar.begin(), similar.end(),
+              [](const CoOccurrence::Neighbor& a,
+                 const CoOccurrence::Neighbor& b) { return a.row < b.row; });
+    using NeighborCandidate = std::tuple<float, double, std::uint32_t>;
+    TopK<NeighborCandidate, NeighborRanking,
+         std::pmr::polymorphic_allocator<NeighborCandidate>>
+        best(capacity, NeighborRanking(), memory);
+    for (std::size_t i = 0; i < similar.size();) {
+      std::uint32_t row = similar[i].row;
+      float score = 0;
+      for (; i < similar.size() && similar[i].row == row; ++i) {
+        score += similar[i].score;
+      }
+      best.push({score,
+                 ratings.bayesian(books.field(BinaryCatalog::ISBN, row)), row});
+    }
+    for (const auto& candidate : best.take()) {
+      chosenRows.push_back(std::get<2>(candidate));
+      entry.isbns.emplace_back(books.field(BinaryCatalog::ISBN,
+                                           std::get<2>(candidate)));
+    }
+    entry.byNeighbors = !entry.isbns.empty();
+  }
+
+  // Os mais próximos da média dos vetores dos últimos livros; a busca pede
+  // livros a mais para compensar os já vistos ou já escolhidos
+  if (embeddings && entry.isbns.size() < capacity) {
+    std::pmr::vector<float> query(embeddings->dimension(), 0.0f, memory);
+    bool found = false;
+    std::size_t lastN = std::min(history.size(), EMBEDDING_HISTORY);
+    for (std::size_t idx = 0; idx < lastN; ++idx) {
+      std::optional<std::uint32_t> node =
+          embeddings->find(history[history.size() - 1 - idx]);
+      if (!node) continue;
+      std::span<const float> values = embeddings->vector(*node);
+      for (std::size_t i = 0; i < values.size(); ++i) query[i] += values[i];
+      found = true;
+    }
+    double norm = 0;
+    for (float value : query) norm += double(value) * value;
+    if (found && norm > 0) {
+      const float scale = static_cast<float>(1.0 / std::sqrt(norm));
+      for (float& value : query) value *= scale;
+      const std::size_t k = capacity + seenRows.size() + chosenRows.size();
+      for (const EmbeddingIndex::Result& result : embeddings->search(
+               query, k, std::max(k, EmbeddingIndex::DEFAULT_EF))) {
+        if (entry.isbns.size() == capacity) break;
+        std::string_view isbn = embeddings->isbn(result.node);
+        std::optional<std::size_t> row = books.find(isbn);
+        if (!row) continue;  // Vetor de um livro que não está no catálogo
+        std::uint32_t candidate = static_cast<std::uint32_t>(*row);
+        if (seen(candidate) ||
+            std::find(chosenRows.begin(), chosenRows.end(), candidate) !=
+                chosenRows.end()) {
+          continue;
+        }
+        chosenRows.push_back(candidate);
+        entry.isbns.emplace_back(isbn);
+        entry.byEmbeddings = true;
+      }
+    }
+  }
+
+  // Guarda só os melhores (qtd_tags, média bayesiana, createdDate, linha do
+  // catálogo); os que já vieram dos vizinhos não contam
+  using TagCandidate = TagRanking::Candidate;
+  TopK<TagCandidate, TagRanking, std::pmr::polymorphic_allocator<TagCandidate>>
+      candidates(capacity + chosenRows.size(), TagRanking(), memory);
+  std::size_t candidateCount = 0;
+  // Intercala as listas das tags do usuário: cada linha aparece uma vez por
+  // tag em comum
+  std::pmr::vector<std::span<const std::uint32_t>> postings(memory);
+  postings.reserve(entry.tags.size());
+  for (std::uint32_t tag : entry.tags) {
+    postings.push_back(books.tagPostings(tag));
+  }
+  std::pmr::vector<std::size_t> cursors(postings.size(), 0, memory);
+  using Head = std::pair<std::uint32_t, std::size_t>;  // (próxima linha, lista)
+  std::pmr::vector<Head> headStorage(memory);
+  headStorage.reserve(postings.size());
+  std::priority_queue<Head, std::pmr::vector<Head>, std::greater<Head>> heads(
+      std::greater<Head>(), std::move(headStorage));
+  for (std::size_t list = 0; list < postings.size(); ++list) {
+    if (!postings[list].empty()) heads.push({postings[list][0], list});
+  }
+  while (!heads.empty()) {
+    std::uint32_t row = heads.top().first;
+    int common = 0;
+    while (!heads.empty() && heads.top().first == row) {
+      std::size_t list = heads.top().second;
+      heads.pop();
+      ++common;
+      if (++cursors[list] < postings[list].size()) {
+        heads.push({postings[list][cursors[list]], list});
+      }
+    }
+    if (seen(row)) continue;
+    ++candidateCount;
+    candidates.push({common,
+                     ratings.bayesian(books.field(BinaryCatalog::ISBN, row)),
+                     books.field(BinaryCatalog::CREATED_DATE, row), row});
+  }
+  for (const auto& candidate : candidates.take()) {
+    if (entry.isbns.size() == capacity) break;
+    std::uint32_t row = static_cast<std::uint32_t>(std::get<3>(candidate));
+    if (std::find(chosenRows.begin(), chosenRows.end(), row) !=
+        chosenRows.end()) {
+      continue;
+    }
+    entry.isbns.emplace_back(books.field(BinaryCatalog::ISBN, row));
+    entry.byTags = true;
+  }
+  if (!entry.isbns.empty()) {
+    entry.complete = candidateCount <= capacity;
+    entry.ratings = ratings.fingerprint(entry.isbns);
+    return entry;
+  }
+
+  // Sem recomendações por tags: os mais recentes, primeiro pela lista global
+  // e, se o usuário já viu quase todos eles, percorrendo o catálogo
+  std::shared_ptr<const std::vector<std::uint32_t>> recent = recentRows(books);
+  for (std::uint32_t row : *recent) {
+    if (entry.isbns.size() == capacity) break;
+    if (!seen(row)) entry.isbns.emplace_back(books.field(BinaryCatalog::ISBN, row));
+  }
+  if (entry.isbns.size() == capacity || recent->size() == books.size()) {
+    entry.complete = entry.isbns.size() < capacity;
+    entry.ratings = ratings.fingerprint(entry.isbns);
+    return entry;
+  }
+  entry.isbns.clear();
+  using DateCandidate = std::pair<std::string_view, std::size_t>;
+  TopK<DateCandidate, RecencyRanking,
+       std::pmr::polymorphic_allocator<DateCandidate>>
+      bookDates(capacity, RecencyRanking(), memory);
+  for (std::size_t row = 0; row < books.size(); ++row) {
+    if (seen(static_cast<std::uint32_t>(row))) continue;
+    bookDates.push({books.field(BinaryCatalog::CREATED_DATE, row), row});
+  }
+  for (const auto& bookDate : bookDates.take()) {
+    entry.isbns.emplace_back(books.field(BinaryCatalog::ISBN, bookDate.second));
+  }
+  entry.complete = entry.isbns.size() < capacity;
+  entry.ratings = ratings.fingerprint(entry.isbns);
+  return entry;
+}
+
+/**
+ * @brief Grava a lista em segundo plano (ver DataManager::updateAsync).
+ */
+void Recommendations::save(const Entry& entry) {
+  store.updateAsync(
+      username, [value = toJson(entry)](const json*) -> std::optional<json> {
+        return value;
+      });
+}
+
+std::vector<std::string> Recommendations::get(
+    const std::vector<std::string>& history,
+    std::pmr::memory_resource* memory) {
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+  std::shared_ptr<const CoOccurrence::Model> neighbors =
+      coOccurrence->model(*books);
+  std::shared_ptr<const EmbeddingIndex> embeddings =
+      EmbeddingIndex::openFor(booksDataManager);
+  Entry entry;
+  if (!fromJson(store.load(username), entry) ||
+      !matches(entry, *books, neighbors.get(), embeddings.get(), history)) {
+    entry = compute(*books, neighbors.get(), embeddings.get(), history,
+                    memory);
+    save(entry);
+  }
+  if (entry.isbns.size() > LIMIT) entry.isbns.resize(LIMIT);
+  return entry.isbns;
+}
+
+/**
+ * @brief Se a lista guardada é só por tags, corresponde ao histórico sem o
+ * último livro e nem as tags consideradas mudaram nem o livro novo trouxe
+ * vizinhos nem há vetores entre os últimos livros, o ranking dos demais
+ * livros também não muda: basta retirar o livro novo. Nos outros casos a
+ * lista é recalculada.
+ */
+void Recommendations::added(const std::vector<std::string>& history,
+                            std::pmr::memory_resource* memory) {
+  if (history.empty()) return;
+  coOccurrence->update(username, history);
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+  std::shared_ptr<const CoOccurrence::Model> neighbors =
+      coOccurrence->model(*books);
+  std::shared_ptr<const EmbeddingIndex> embeddings =
+      EmbeddingIndex::openFor(booksDataManager);
+  Entry entry;
+  const bool stored = fromJson(store.load(username), entry);
+  if (stored &&
+      matches(entry, *books, neighbors.get(), embeddings.get(), history)) {
+    return;  // Nada mudou
+  }
+
+  const bool previous =
+      stored && !entry.byNeighbors && !entry.byEmbeddings &&
+      entry.catalog == books->getFingerprint() &&
+      entry.model == neighborsDigest(
+                         *books, neighbors.get(),
+                         std::span(history).first(history.size() - 1)) &&
+      entry.embeddings == (embeddings ? embeddings->getFingerprint() : 0) &&
+      entry.ratings == ratings.fingerprint(entry.isbns) &&
+      entry.historySize + 1 == history.size() &&
+      entry.lastIsbn == (history.size() >= 2 ? history[history.size() - 2]
+                                             : std::string());
+  bool newNeighbors = false;
+  if (previous && neighbors) {
+    if (std::optional<std::size_t> row = books->find(history.back())) {
+      for (const CoOccurrence::Neighbor& neighbor :
+           neighbors->neighbors(*row)) {
+        std::string_view isbn = books->field(BinaryCatalog::ISBN, neighbor.row);
+        if (std::find(history.begin(), history.end(), isbn) == history.end()) {
+          newNeighbors = true;
+          break;
+        }
+      }
+    }
+  }
+  // Com um vetor entre os últimos livros, a busca pelos vetores muda
+  if (previous && embeddings) {
+    std::size_t lastN = std::min(history.size(), EMBEDDING_HISTORY);
+    for (std::size_t idx = 0; idx < lastN && !newNeighbors; ++idx) {
+      newNeighbors = embeddings->find(history[history.size() - 1 - idx])
+                         .has_value();
+    }
+  }
+  if (!previous || newNeighbors ||
+      historyTags(*books, history) != entry.tags) {
+    save(compute(*books, neighbors.get(), embeddings.get(), history, memory));
+    return;
+  }
+
+  std::erase(entry.isbns, history.back());
+  // Com menos de LIMIT livros, a reserva acabou (ou, pelas tags, não sobrou
+  // nenhum candidato e a home page passa a mostrar os mais recentes)
+  if ((entry.isbns.size() < LIMIT && !entry.complete) ||
+      (entry.isbns.empty() && entry.byTags)) {
+    save(compute(*books, neighbors.get(), embeddings.get(), history, memory));
+    return;
+  }
+  entry.model = neighborsDigest(*books, neighbors.get(), history);
+  entry.ratings = ratings.fingerprint(entry.isbns);
+  entry.historySize = history.size();
+  entry.lastIsbn = history.back();
+  save(entry);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file: Recommendations.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição das recomendações por usuário, pré-calculadas e
+ * guardadas ao lado do histórico.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef RECOMMENDATIONS_H
+#define RECOMMENDATIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "../Catalog/BinaryCatalog.h"
+#include "../DataManager/DataManager.h"
+#include "../Ratings/Ratings.h"
+#include "CoOccurrence.h"
+#include "EmbeddingIndex.h"
+
+/**
+ * @class Recommendations
+ * @brief Recomendações da home page de um usuário (sempre sem os livros já
+ * consultados), por estratégia, em ordem:
+ * - vizinhos (CoOccurrence): os livros mais similares, pelos históricos dos
+ *   outros usuários, aos últimos livros consultados;
+ * - vetores (EmbeddingIndex, se houver embeddings.jsonl): os livros mais
+ *   próximos da média dos vetores dos últimos livros consultados, buscados
+ *   no índice HNSW;
+ * - tags: os livros com mais tags em comum com os últimos livros consultados,
+ *   que completam a lista das anteriores ou a substituem se elas não
+ *   acharem nada;
+ * - os mais recentes do catálogo, se nenhuma das anteriores achar nada.
+ * Nos vizinhos e nas tags, os empates são decididos pela média bayesiana das
+ * notas (Ratings::bayesian, uma consulta O(1) por candidato).
+ *
+ * O resultado fica materializado em um arquivo por usuário, ao lado do
+ * histórico (data/recommendations/<xx>/<usuário>.json, ver
+ * History::shardPath), junto com o que foi usado para calculá-lo: a impressão
+ * digital do catálogo, o tamanho e o último ISBN do histórico e as tags
+ * consideradas, os hashes das listas de vizinhos usadas (só as dos últimos
+ * livros do histórico), a impressão digital dos vetores e um hash das notas
+ * dos livros da lista. Assim get() só lê a lista guardada (O(k)) enquanto
+ * nada mudou, e added() atualiza a lista de forma incremental quando um livro
+ * entra no histórico: numa lista só por tags, se as tags consideradas não
+ * mudaram, basta tirar o livro novo da lista (que guarda alguns livros de
+ * reserva); nos outros casos a lista é recalculada.
+ * Uma mudança no catálogo ou nos vetores, nas listas de vizinhos usadas ou
+ * nas notas dos livros da lista invalida a lista, que é recalculada no
+ * próximo acesso. Notas dadas a outros livros só mexem nos desempates e
+ * entram no próximo recálculo.
+ */
+class Recommendations {
+ private:
+  DataManager store;  // Arquivo do usuário
+  DataManager& booksDataManager;
+  std::string username;
+  std::shared_ptr<CoOccurrence> coOccurrence;
+  Ratings ratings;
+
+  /**
+   * @brief Lista materializada (o json guardado no arquivo do usuário).
+   */
+  struct Entry {
+    std::uint64_t catalog = 0;   // Impressão digital do catálogo
+    std::uint64_t model = 0;     // Hash das listas de vizinhos (0: sem)
+    std::uint64_t ratings = 0;   // Hash das notas dos livros da lista
+    std::uint64_t embeddings = 0;  // Impressão digital dos vetores (0: sem)
+    std::size_t historySize = 0;
+    std::string lastIsbn;        // Último ISBN do histórico
+    bool byNeighbors = false;    // Começa pelos vizinhos
+    bool byEmbeddings = false;   // Tem livros vindos dos vetores
+    bool byTags = false;         // false: livros mais recentes
+    bool complete = false;       // A lista tem todos os candidatos
+    std::vector<std::uint32_t> tags;  // IDs das tags consideradas
+    std::vector<std::string> isbns;   // Do melhor para o pior
+  };
+
+  static json toJson(const Entry& entry);
+  static bool fromJson(const json& value, Entry& entry);
+  bool matches(const Entry& entry, const BinaryCatalog& books,
+               const CoOccurrence::Model* neighbors,
+               const EmbeddingIndex* embeddings,
+               const std::vector<std::string>& history) const;
+
+  Entry compute(const BinaryCatalog& books,
+                const CoOccurrence::Model* neighbors,
+                const EmbeddingIndex* embeddings,
+                const std::vector<std::string>& history,
+                std::pmr::memory_resource* memory);
+  void save(const Entry& entry);
+
+ public:
+  /**
+   * @brief Quantidade de recomendações exibidas na home page.
+   */
+  static const std::size_t LIMIT = 3;
+
+  /**
+   * @param booksDataManager Gerenciador do catálogo.
+   * @param historyDataManager Gerenciador do history.json; os arquivos por
+   * usuário ficam no subdiretório "recommendations" do mesmo diretório.
+   * @param username O usuário.
+   */
+  Recommendations(DataManager& booksDataManager,
+                  const DataManager& historyDataManager,
+                  const std::string& username);
+
+  /**
+   * @brief Recomendações atuais, recalculadas só se a lista guardada não
+   * corresponder mais ao histórico ou ao catálogo.
+   * @param history O histórico do usuário.
+   * @param memory Memória para as estruturas temporárias do cálculo.
+   * @return No máximo LIMIT ISBNs, do melhor para o pior.
+   */
+  std::vector<std::string> get(const std::vector<std::string>& history,
+                               std::pmr::memory_resource* memory);
+
+  /**
+   * @brief Atualiza a lista depois que um livro entrou no histórico.
+   * @param history O histórico já com o livro novo no fim.
+   * @param memory Memória para as estruturas temporárias do cálculo.
+   */
+  void added(const std::vector<std::string>& history,
+             std::pmr::memory_resource* memory);
+};
+
+#endif  // RECOMMENDATIONS_H
@@ -0,0 +1,237 @@
+/**
+ * @file: JaroWinkler.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do kernel de similaridade Jaro-Winkler.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "JaroWinkler.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Parte final do cálculo (Jaro + bônus de Winkler), na mesma ordem de
+ * operações da versão original para manter os resultados idênticos.
+ */
+double finish(std::string_view s1, std::string_view s2, int matches, double t) {
+  const std::size_t len1 = s1.size();
+  const std::size_t len2 = s2.size();
+  double m = matches;
+  double jaro = (m / len1 + m / len2 + (m - t) / m) / 3.0;
+  // Winkler boost
+  int prefix = 0;
+  for (std::size_t i = 0; i < std::min({len1, len2, std::size_t(4)}); ++i) {
+    if (s1[i] == s2[i])
+      ++prefix;
+    else
+      break;
+  }
+  return jaro + 0.1 * prefix * (1.0 - jaro);
+}
+
+/**
+ * @brief Versão com bitsets para strings de até 64 * Words bytes.
+ *
+ * positions[c] marca onde o caractere c aparece em s2. Para cada caractere de
+ * s1, o primeiro s2[j] livre e igual dentro da janela é o bit menos
+ * significativo de (positions[c] & janela & ~casados).
+ */
+template <std::size_t Words>
+double bitParallel(std::string_view s1, std::string_view s2,
+                   std::size_t matchDistance) {
+  // Zerada uma única vez por thread; após cada uso só as entradas tocadas
+  // são limpas
+  thread_local std::array<std::array<std::uint64_t, 2>, 256> positions{};
+
+  const std::size_t len1 = s1.size();
+  const std::size_t len2 = s2.size();
+  for (std::size_t j = 0; j < len2; ++j) {
+    positions[static_cast<unsigned char>(s2[j])][j >> 6] |= std::uint64_t(1)
+                                                            << (j & 63);
+  }
+
+  std::array<std::uint64_t, Words> s1Matches{};
+  std::array<std::uint64_t, Words> s2Matches{};
+  int matches = 0;
+  for (std::size_t i = 0; i < len1; ++i) {
+    std::size_t start = (i >= matchDistance) ? i - matchDistance : 0;
+    std::size_t end = std::min(i + matchDistance + 1, len2);
+    const auto& candidatesOf = positions[static_cast<unsigned char>(s1[i])];
+    for (std::size_t w = 0; w < Words; ++w) {
+      std::size_t lo = std::max(start, w * 64);
+      std::size_t hi = std::min(end, w * 64 + 64);
+      if (lo >= hi) continue;
+      std::size_t width = hi - lo;
+      std::uint64_t window =
+          (width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1)
+          << (lo - w * 64);
+      std::uint64_t candidates = candidatesOf[w] & window & ~s2Matches[w];
+      if (candidates == 0) continue;
+      s2Matches[w] |= std::uint64_t(1) << std::countr_zero(candidates);
+      s1Matches[i >> 6] |= std::uint64_t(1) << (i & 63);
+      ++matches;
+      break;
+    }
+  }
+
+  for (std::size_t j = 0; j < len2; ++j) {
+    positions[static_cast<unsigned char>(s2[j])] = {0, 0};
+  }
+  if (matches == 0) return 0.0;
+
+  // Transposições: percorre os casados de s1 e s2 em ordem, lado a lado
+  double t = 0.0;
+  std::size_t w2 = 0;
+  std::uint64_t bits2 = s2Matches[0];
+  for (std::size_t w1 = 0; w1 < Words; ++w1) {
+    std::uint64_t bits1 = s1Matches[w1];
+    while (bits1 != 0) {
+      std::size_t i = w1 * 64 + std::countr_zero(bits1);
+      bits1 &= bits1 - 1;
+      while (bits2 == 0) bits2 = s2Matches[++w2];
+      std::size_t k = w2 * 64 + std::countr_zero(bits2);
+      bits2 &= bits2 - 1;
+      if (s1[i] != s2[k]) t += 0.5;
+    }
+  }
+  return finish(s1, s2, matches, t);
+}
+
+/**
+ * @brief Procura o primeiro j em [start, end) com s2[j] == c e ainda não
+ * casado, comparando 32 (AVX2) ou 16 (SSE2) bytes por vez.
+ * @return O índice encontrado, ou end se não houver.
+ */
+std::size_t findMatch(const char* s2, const unsigned char* matched,
+                      std::size_t start, std::size_t end, char c) {
+  std::size_t j = start;
+#if defined(__AVX2__)
+  const __m256i needle = _mm256_set1_epi8(c);
+  const __m256i zero = _mm256_setzero_si256();
+  for (; j + 32 <= end; j += 32) {
+    __m256i text = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s2 + j));
+    __m256i used =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(matched + j));
+    __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi8(text, needle),
+                                   _mm256_cmpeq_epi8(used, zero));
+    auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(hit));
+    if (mask != 0) return j + std::countr_zero(mask);
+  }
+#elif defined(__SSE2__)
+  const __m128i needle = _mm_set1_epi8(c);
+  const __m128i zero = _mm_setzero_si128();
+  for (; j + 16 <= end; j += 16) {
+    __m128i text = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + j));
+    __m128i used = _mm_loadu_si128(reinterpret_cast<const __m128i*>(matched + j));
+    __m128i hit = _mm_and_si128(_mm_cmpeq_epi8(text, needle),
+                                _mm_cmpeq_epi8(used, zero));
+    auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(hit));
+    if (mask != 0) return j + std::countr_zero(mask);
+  }
+#endif
+  for (; j < end; ++j) {
+    if (!matched[j] && s2[j] == c) return j;
+  }
+  return end;
+}
+
+/**
+ * @brief Versão para strings longas, com buffers reaproveitados por thread.
+ */
+double general(std::string_view s1, std::string_view s2,
+               std::size_t matchDistance) {
+  thread_local std::vector<unsigned char> s1Matches;
+  thread_local std::vector<unsigned char> s2Matches;
+
+  const std::size_t len1 = s1.size();
+  const std::size_t len2 = s2.size();
+  s1Matches.assign(len1, 0);
+  s2Matches.assign(len2, 0);
+  int matches = 0;
+  for (std::size_t i = 0; i < len1; ++i) {
+    std::size_t start = (i >= matchDistance) ? i - matchDistance : 0;
+    std::size_t end = std::min(i + matchDistance + 1, len2);
+    if (start >= end) continue;
+    std::size_t j = findMatch(s2.data(), s2Matches.data(), start, end, s1[i]);
+    if (j == end) continue;
+    s1Matches[i] = 1;
+    s2Matches[j] = 1;
+    ++matches;
+  }
+  if (matches == 0) return 0.0;
+
+  double t = 0.0;
+  std::size_t k = 0;
+  for (std::size_t i = 0; i < len1; ++i) {
+    if (!s1Matches[i]) continue;
+    while (!s2Matches[k]) ++k;
+    if (s1[i] != s2[k]) t += 0.5;
+    ++k;
+  }
+  return finish(s1, s2, matches, t);
+}
+
+}  // namespace
+
+/**
+ * @brief Calcula a similaridade Jaro-Winkler entre duas strings.
+ */
+double JaroWinkler::similarity(std::string_view s1, std::string_view s2) {
+  const std::size_t len1 = s1.size();
+  const std::size_t len2 = s2.size();
+  if (len1 == 0 && len2 == 0) return 1.0;
+  if (len1 == 0 || len2 == 0) return 0.0;
+  // Mesma expressão da versão original (inclusive o caso max == 1, em que a
+  // subtração dá a volta e nenhuma janela é válida)
+  const std::size_t matchDistance = std::max(len1, len2) / 2 - 1;
+  const std::size_t longest = std::max(len1, len2);
+  if (longest <= 64) return bitParallel<1>(s1, s2, matchDistance);
+  if (longest <= 128) return bitParallel<2>(s1, s2, matchDistance);
+  return general(s1, s2, matchDistance);
+}
+
+/**
+ * @brief Limite superior da similaridade. Com m casamentos e t transposições,
+ * Jaro = (m/len1 + m/len2 + (m - t)/m) / 3 cresce com m e cai com t, e m não
+ * passa do tamanho da menor string; o bônus de Winkler só depende do prefixo.
+ * A conta é feita por finish(), então o limite é bit a bit igual ao resultado
+ * exato quando ele é atingido.
+ */
+double JaroWinkler::upperBound(std::string_view s1, std::string_view s2) {
+  const std::size_t len1 = s1.size();
+  const std::size_t len2 = s2.size();
+  if (len1 == 0 && len2 == 0) return 1.0;
+  if (len1 == 0 || len2 == 0) return 0.0;
+  return finish(s1, s2, static_cast<int>(std::min(len1, len2)), 0.0);
+}
+
+/**
+ * @brief Calcula a similaridade de uma consulta contra vários candidatos.
+ */
+void JaroWinkler::similarityBatch(std::string_view query,
+                                  std::span<const std::string_view> candidates,
+                                  std::span<double> scores, double cutoff) {
+  const std::size_t n = std::min(candidates.size(), scores.size());
+  for (std::size_t i = 0; i < n; ++i) {
+    if (cutoff >= 0.0 && upperBound(query, candidates[i]) <= cutoff) {
+      scores[i] = 0.0;
+      continue;
+    }
+    scores[i] = similarity(query, candidates[i]);
+  }
+}
@@ -0,0 +1,68 @@
+/**
+ * @file: JaroWinkler.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do kernel de similaridade Jaro-Winkler usado pela
+ * busca.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef JARO_WINKLER_H
+#define JARO_WINKLER_H
+
+#include <span>
+#include <string_view>
+
+/**
+ * @class JaroWinkler
+ * @brief Similaridade Jaro-Winkler (0.0 a 1.0, quanto maior mais parecido)
+ * sem alocações por comparação.
+ *
+ * - Strings de até 64/128 bytes usam bitsets: as posições de cada caractere
+ *   da segunda string viram máscaras e a procura na janela de casamento é um
+ *   AND + "primeiro bit ligado".
+ * - Strings maiores usam buffers thread_local reaproveitados e varrem a janela
+ *   com SIMD (AVX2 ou SSE2, conforme a compilação) ou de forma escalar.
+ *
+ * Os resultados são bit a bit idênticos à implementação original (casamento
+ * guloso na ordem da primeira string).
+ * Referência: https://www.geeksforgeeks.org/jaro-and-jaro-winkler-similarity/
+ */
+class JaroWinkler {
+ public:
+  /**
+   * @brief Calcula a similaridade entre duas strings.
+   * @param s1 A primeira string (ex: a consulta).
+   * @param s2 A segunda string (ex: o título).
+   * @return A similaridade entre 0.0 e 1.0.
+   */
+  static double similarity(std::string_view s1, std::string_view s2);
+
+  /**
+   * @brief Limite superior barato da similaridade, usando só os tamanhos e o
+   * prefixo comum: é o valor que similarity() daria se todos os caracteres da
+   * string menor casassem sem transposições. Nunca é menor que o resultado
+   * exato.
+   * @param s1 A primeira string.
+   * @param s2 A segunda string.
+   * @return O limite superior entre 0.0 e 1.0.
+   */
+  static double upperBound(std::string_view s1, std::string_view s2);
+
+  /**
+   * @brief Calcula a similaridade de uma consulta contra vários candidatos.
+   * @param query A consulta (primeira string de cada comparação).
+   * @param candidates Os candidatos.
+   * @param scores Saída; precisa ter o mesmo tamanho de candidates.
+   * @param cutoff Candidatos cujo upperBound() não passa de cutoff recebem
+   * 0.0 sem serem pontuados (o padrão pontua todos).
+   */
+  static void similarityBatch(std::string_view query,
+                              std::span<const std::string_view> candidates,
+                              std::span<double> scores, double cutoff = -1.0);
+};
+
+#endif  // JARO_WINKLER_H
@@ -0,0 +1,128 @@
+/**
+ * @file: SearchCache.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do cache LRU dos resultados da busca.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "SearchCache.h"
+
+#include <cstdlib>
+#include <exception>
+
+namespace {
+
+const std::size_t DEFAULT_MAX_ENTRIES = 1024;
+const std::size_t DEFAULT_MAX_MEGABYTES = 16;
+
+/**
+ * @brief Lê um número não negativo de uma variável de ambiente.
+ */
+std::size_t environmentSize(const char* name, std::size_t fallback) {
+  if (const char* env = std::getenv(name)) {
+    try {
+      long long value = std::stoll(env);
+      if (value >= 0) return static_cast<std::size_t>(value);
+    } catch (const std::exception&) {
+      // Valor inválido: usa o padrão
+    }
+  }
+  return fallback;
+}
+
+/**
+ * @brief Memória aproximada de uma entrada (chave, lista e nós).
+ */
+std::size_t entryBytes(std::string_view query, const SearchCache::Hits& hits) {
+  std::size_t total = 128 + query.size();
+  for (const auto& hit : hits) total += sizeof(hit) + hit.second.capacity();
+  return total;
+}
+
+}  // namespace
+
+SearchCache::SearchCache()
+    : SearchCache(configuredLimits().first, configuredLimits().second) {}
+
+SearchCache::SearchCache(std::size_t maxEntries, std::size_t maxBytes)
+    : maxEntries(maxEntries), maxBytes(maxBytes) {
+  counters.maxEntries = maxEntries;
+  counters.maxBytes = maxBytes;
+}
+
+std::pair<std::size_t, std::size_t> SearchCache::configuredLimits() {
+  return {environmentSize("BOOKMATCH_SEARCH_CACHE", DEFAULT_MAX_ENTRIES),
+          environmentSize("BOOKMATCH_SEARCH_CACHE_MB", DEFAULT_MAX_MEGABYTES) *
+              1024 * 1024};
+}
+
+std::shared_ptr<const SearchCache::Hits> SearchCache::find(
+    std::string_view query, std::size_t limit, std::uint64_t generation) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (generation > this->generation) invalidateLocked(generation);
+  auto it = positions.find(Key{query, limit});
+  // Uma busca que leu a geração antes da última mudança não pode usar as
+  // entradas novas (nem descartá-las)
+  if (it == positions.end() || generation < this->generation) {
+    ++counters.misses;
+    return nullptr;
+  }
+  ++counters.hits;
+  entries.splice(entries.begin(), entries, it->second);  // Vira a mais recente
+  return it->second->hits;
+}
+
+void SearchCache::store(std::string_view query, std::size_t limit,
+                        std::uint64_t generation, Hits hits) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (maxEntries == 0) return;
+  // Uma busca que começou antes da última mudança do catálogo pode ter visto
+  // o catálogo antigo
+  if (generation < this->generation) return;
+  if (generation > this->generation) invalidateLocked(generation);
+  const std::size_t size = entryBytes(query, hits);
+  if (size > maxBytes) return;
+
+  auto it = positions.find(Key{query, limit});
+  if (it != positions.end()) {  // Outra thread fez a mesma busca ao mesmo tempo
+    bytes -= it->second->bytes;
+    std::list<Entry>::iterator entry = it->second;
+    positions.erase(it);
+    entries.erase(entry);
+  }
+  entries.push_front(Entry{std::string(query), limit,
+                           std::make_shared<const Hits>(std::move(hits)), size});
+  positions.emplace(Key{entries.front().query, limit}, entries.begin());
+  bytes += size;
+  evictLocked();
+}
+
+SearchCache::Stats SearchCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  Stats stats = counters;
+  stats.entries = entries.size();
+  stats.bytes = bytes;
+  return stats;
+}
+
+void SearchCache::invalidateLocked(std::uint64_t generation) {
+  if (!entries.empty()) ++counters.invalidations;
+  positions.clear();
+  entries.clear();
+  bytes = 0;
+  this->generation = generation;
+}
+
+void SearchCache::evictLocked() {
+  while (!entries.empty() &&
+         (entries.size() > maxEntries || bytes > maxBytes)) {
+    positions.erase(Key{entries.back().query, entries.back().limit});
+    bytes -= entries.back().bytes;
+    entries.pop_back();
+    ++counters.evictions;
+  }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file: SearchCache.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do cache LRU dos resultados da busca.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef SEARCH_CACHE_H
+#define SEARCH_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SearchCache
+ * @brief Cache LRU dos resultados da busca, indexado por (consulta
+ * normalizada, limite). Cada entrada guarda só a lista pontuada de ISBNs;
+ * títulos e autores continuam vindo do catálogo binário.
+ *
+ * O cache inteiro pertence a uma geração do catálogo (ver
+ * DataManager::generation, que muda em Book::save, Book::remove e quando o
+ * arquivo é relido): ao ver uma geração diferente, todas as entradas são
+ * descartadas. Há limite de entradas e de bytes; passando de qualquer um, as
+ * usadas há mais tempo saem primeiro. Pode ser usado por várias threads.
+ */
+class SearchCache {
+ public:
+  /**
+   * @brief Um resultado: (similaridade, ISBN), do melhor para o pior.
+   */
+  using Hits = std::vector<std::pair<double, std::string>>;
+
+  /**
+   * @brief Contadores do cache.
+   */
+  struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;      // Entradas removidas pelos limites
+    std::uint64_t invalidations = 0;  // Vezes que o catálogo mudou
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+    std::size_t maxEntries = 0;
+    std::size_t maxBytes = 0;
+  };
+
+  /**
+   * @brief Cria o cache com os limites de configuredLimits().
+   */
+  SearchCache();
+
+  /**
+   * @brief Cria o cache.
+   * @param maxEntries Quantidade máxima de entradas (0 desativa o cache).
+   * @param maxBytes Memória máxima estimada das entradas.
+   */
+  SearchCache(std::size_t maxEntries, std::size_t maxBytes);
+
+  /**
+   * @brief Procura um resultado.
+   * @param query A consulta já normalizada.
+   * @param limit A quantidade de resultados pedida.
+   * @param generation A geração do catálogo lida antes da busca.
+   * @return O resultado, ou nullptr se não estiver no cache.
+   */
+  std::shared_ptr<const Hits> find(std::string_view query, std::size_t limit,
+                                   std::uint64_t generation);
+
+  /**
+   * @brief Guarda um resultado.
+   * @param generation A geração do catálogo lida antes de a busca começar
+   * (se o catálogo mudou durante a busca, a entrada já nasce descartável).
+   */
+  void store(std::string_view query, std::size_t limit,
+             std::uint64_t generation, Hits hits);
+
+  Stats stats() const;
+
+  /**
+   * @brief Limites configurados pelas variáveis de ambiente
+   * BOOKMATCH_SEARCH_CACHE (entradas, padrão 1024; 0 desativa) e
+   * BOOKMATCH_SEARCH_CACHE_MB (padrão 16).
+   * @return O par (entradas, bytes).
+   */
+  static std::pair<std::size_t, std::size_t> configuredLimits();
+
+ private:
+  /**
+   * @brief Chave do mapa; a consulta aponta para a cópia guardada na entrada
+   * (os nós da lista não mudam de lugar).
+   */
+  struct Key {
+    std::string_view query;
+    std::size_t limit;
+    bool operator==(const Key&) const = default;
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const {
+      return std::hash<std::string_view>()(key.query) ^
+             (key.limit * 0x9E3779B97F4A7C15ULL);
+    }
+  };
+
+  struct Entry {
+    std::string query;
+    std::size_t limit;
+    std::shared_ptr<const Hits> hits;
+    std::size_t bytes;
+  };
+
+  mutable std::mutex mutex;
+  const std::size_t maxEntries;
+  const std::size_t maxBytes;
+  std::uint64_t generation = 0;
+  std::list<Entry> entries;  // Mais recente primeiro
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> positions;
+  std::size_t bytes = 0;
+  Stats counters;
+
+  void invalidateLocked(std::uint64_t generation);
+  void evictLocked();
+};
+
+#endif  // SEARCH_CACHE_H
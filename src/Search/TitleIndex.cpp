@@ -0,0 +1,234 @@
+/**
+ * @file: TitleIndex.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do índice de títulos pré-normalizados.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "TitleIndex.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+
+#include "../Utils/FormatAux.h"
+
+/**
+ * @brief Normaliza um texto para comparação (minúsculas e sem acentos).
+ */
+std::string TitleIndex::normalize(std::string_view text) {
+  std::string normalized;
+  FormatAux().normalizeInto(text, normalized);
+  return normalized;
+}
+
+std::pmr::string TitleIndex::normalize(std::string_view text,
+                                       std::pmr::memory_resource* memory) {
+  std::pmr::string normalized(memory);
+  FormatAux().normalizeInto(text, normalized);
+  return normalized;
+}
+
+/**
+ * @brief Retorna (e mantém sincronizado) o índice de um catálogo.
+ */
+std::shared_ptr<TitleIndex> TitleIndex::forCatalog(
+    DataManager& booksDataManager) {
+  static std::mutex registryMutex;
+  static std::unordered_map<std::string, std::shared_ptr<TitleIndex>> registry;
+
+  std::lock_guard<std::mutex> registryLock(registryMutex);
+  auto& index = registry[booksDataManager.getFullPath()];
+  if (!index) {
+    index = std::make_shared<TitleIndex>();
+    std::weak_ptr<TitleIndex> weak = index;
+    booksDataManager.subscribe([weak](std::uint64_t generation,
+                                      const std::string& isbn,
+                                      const json* book) {
+      if (auto shared = weak.lock()) shared->apply(generation, isbn, book);
+    });
+  }
+
+  // A geração é lida antes do catálogo: se algo mudar no meio, a próxima
+  // chamada percebe a diferença e reconstrói de novo
+  std::uint64_t current = booksDataManager.generation();
+  bool stale;
+  {
+    std::shared_lock<std::shared_mutex> lock(index->mutex);
+    stale = index->generation != current;
+  }
+  if (stale) {
+    std::shared_ptr<const BinaryCatalog> catalog =
+        BinaryCatalog::openFor(booksDataManager);
+    std::filesystem::path trigramPath(booksDataManager.getFullPath());
+    trigramPath.replace_extension(".tri");
+    index->rebuild(*catalog, current, trigramPath.string());
+  }
+  return index;
+}
+
+bool TitleIndex::fullScanRequested() {
+  const char* env = std::getenv("BOOKMATCH_FULL_SCAN");
+  return env && std::string(env) != "0";
+}
+
+/**
+ * @brief Reconstrói o índice inteiro a partir do catálogo binário. Os
+ * trigramas são lidos de trigramPath quando o arquivo corresponde ao catálogo;
+ * senão são recalculados e gravados lá.
+ */
+void TitleIndex::rebuild(const BinaryCatalog& catalog,
+                         std::uint64_t generation,
+                         const std::string& trigramPath) {
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  arena.clear();
+  entries.clear();
+  positions.clear();
+  garbage = 0;
+  entries.reserve(catalog.size());
+  positions.reserve(catalog.size());
+  FormatAux formatAux = FormatAux();
+  std::string normalized;  // Reaproveitado entre as linhas
+  for (std::size_t row = 0; row < catalog.size(); ++row) {
+    std::string isbn(catalog.field(BinaryCatalog::ISBN, row));
+    formatAux.normalizeInto(catalog.field(BinaryCatalog::TITLE, row),
+                            normalized);
+    auto it = positions.find(isbn);
+    if (it != positions.end()) kill(it->second);
+    append(isbn, normalized);
+  }
+
+  const std::uint32_t documents = static_cast<std::uint32_t>(entries.size());
+  if (!trigrams.load(trigramPath, catalog.getFingerprint(), documents)) {
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      if (!entries[i].alive) continue;
+      trigrams.add(static_cast<std::uint32_t>(i),
+                   view(entries[i].titleOffset, entries[i].titleLength));
+    }
+    // Sem o arquivo a busca continua funcionando; só a próxima carga é mais
+    // lenta
+    trigrams.save(trigramPath, catalog.getFingerprint());
+  }
+  this->generation = generation;
+}
+
+/**
+ * @brief Aplica uma mudança notificada pelo DataManager. Se alguma mudança
+ * anterior foi perdida (gerações fora de sequência), o índice é marcado como
+ * desatualizado e será reconstruído no próximo forCatalog().
+ */
+void TitleIndex::apply(std::uint64_t generation, const std::string& isbn,
+                       const json* book) {
+  std::unique_lock<std::shared_mutex> lock(mutex);
+  if (this->generation + 1 != generation) {
+    this->generation = 0;
+    return;
+  }
+  if (book) {
+    std::string title;
+    auto it = book->find("title");
+    if (it != book->end() && it->is_string()) title = it->get<std::string>();
+    upsert(isbn, title);
+  } else {
+    erase(isbn);
+  }
+  this->generation = generation;
+}
+
+/**
+ * @brief Acrescenta uma entrada viva no fim (sem mexer nos trigramas).
+ * @return A posição da nova entrada.
+ */
+std::size_t TitleIndex::append(const std::string& isbn,
+                               std::string_view normalized) {
+  Entry entry;
+  entry.isbnOffset = arena.size();
+  entry.isbnLength = static_cast<std::uint32_t>(isbn.size());
+  arena += isbn;
+  entry.titleOffset = arena.size();
+  entry.titleLength = static_cast<std::uint32_t>(normalized.size());
+  arena.append(normalized);
+  entry.alive = true;
+  positions[isbn] = entries.size();
+  entries.push_back(entry);
+  return entries.size() - 1;
+}
+
+/**
+ * @brief Insere ou substitui o título de um ISBN. A entrada antiga vira lixo,
+ * recolhido por compact() quando passa de metade da arena.
+ */
+void TitleIndex::upsert(const std::string& isbn, std::string_view title) {
+  std::string normalized = normalize(title);
+  auto it = positions.find(isbn);
+  if (it != positions.end()) kill(it->second);
+  std::size_t position = append(isbn, normalized);
+  trigrams.add(static_cast<std::uint32_t>(position), normalized);
+  if (garbage > arena.size() / 2) compact();
+}
+
+/**
+ * @brief Remove um ISBN do índice.
+ */
+void TitleIndex::erase(const std::string& isbn) {
+  auto it = positions.find(isbn);
+  if (it == positions.end()) return;
+  kill(it->second);
+  positions.erase(it);
+  if (garbage > arena.size() / 2) compact();
+}
+
+/**
+ * @brief Marca uma entrada como morta; a posição continua ocupada até o
+ * próximo compact() para não invalidar o índice de trigramas.
+ */
+void TitleIndex::kill(std::size_t position) {
+  Entry& entry = entries[position];
+  if (!entry.alive) return;
+  entry.alive = false;
+  garbage += entry.isbnLength + entry.titleLength;
+}
+
+/**
+ * @brief Descarta as entradas mortas: recopia as strings vivas para uma
+ * arena nova, renumera as posições e refaz os trigramas.
+ */
+void TitleIndex::compact() {
+  std::string compacted;
+  compacted.reserve(arena.size() - garbage);
+  std::vector<Entry> survivors;
+  survivors.reserve(positions.size());
+  trigrams.clear();
+  for (const Entry& old : entries) {
+    if (!old.alive) continue;
+    std::string_view isbn = view(old.isbnOffset, old.isbnLength);
+    std::string_view title = view(old.titleOffset, old.titleLength);
+    Entry entry = old;
+    entry.isbnOffset = compacted.size();
+    compacted += isbn;
+    entry.titleOffset = compacted.size();
+    compacted += title;
+    positions[std::string(isbn)] = survivors.size();
+    trigrams.add(static_cast<std::uint32_t>(survivors.size()), title);
+    survivors.push_back(entry);
+  }
+  arena.swap(compacted);
+  entries.swap(survivors);
+  garbage = 0;
+}
+
+std::string_view TitleIndex::view(std::uint64_t offset,
+                                  std::uint32_t length) const {
+  return std::string_view(arena.data() + offset, length);
+}
+
+std::size_t TitleIndex::size() const {
+  std::shared_lock<std::shared_mutex> lock(mutex);
+  return positions.size();
+}
+
+bool TitleIndex::empty() const { return size() == 0; }
@@ -0,0 +1,262 @@
+/**
+ * @file: TitleIndex.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do índice de títulos pré-normalizados usado pela
+ * busca.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef TITLE_INDEX_H
+#define TITLE_INDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../Catalog/BinaryCatalog.h"
+#include "../DataManager/DataManager.h"
+#include "TrigramIndex.h"
+
+/**
+ * @class TitleIndex
+ * @brief Guarda os títulos já normalizados (minúsculas e sem acentos) e seus
+ * ISBNs em uma única arena contígua, para que a busca só precise normalizar a
+ * consulta.
+ *
+ * O índice é construído uma vez a partir do catálogo e depois atualizado de
+ * forma incremental pelas mudanças notificadas pelo DataManager (Book::save e
+ * Book::remove).
+ *
+ * Junto com os títulos é mantido um índice de trigramas (gravado ao lado do
+ * json, em "<arquivo>.tri"), que permite à busca pontuar só os títulos com
+ * algum trigrama em comum com a consulta. Para os números das entradas
+ * continuarem válidos nesse índice, uma entrada removida ou substituída
+ * apenas é marcada como morta; as mortas são descartadas em compact().
+ */
+class TitleIndex {
+ private:
+  /**
+   * @brief Posição de um livro na arena.
+   */
+  struct Entry {
+    std::uint64_t isbnOffset;
+    std::uint32_t isbnLength;
+    std::uint64_t titleOffset;
+    std::uint32_t titleLength;
+    bool alive;
+  };
+
+  mutable std::shared_mutex mutex;
+  std::string arena;
+  std::vector<Entry> entries;
+  std::unordered_map<std::string, std::size_t> positions;  // ISBN -> entrada
+  std::size_t garbage = 0;  // Bytes da arena que não pertencem a nenhuma entrada
+  std::uint64_t generation = 0;
+  TrigramIndex trigrams;  // Trigrama -> entradas (vivas ou mortas)
+
+  void rebuild(const BinaryCatalog& catalog, std::uint64_t generation,
+               const std::string& trigramPath);
+  std::size_t append(const std::string& isbn, std::string_view normalized);
+  void upsert(const std::string& isbn, std::string_view title);
+  void erase(const std::string& isbn);
+  void kill(std::size_t position);
+  void compact();
+  void apply(std::uint64_t generation, const std::string& isbn,
+             const json* book);
+
+  std::string_view view(std::uint64_t offset, std::uint32_t length) const;
+
+  /**
+   * @brief Percorre em lotes as entradas vivas dadas por next(), sem travar.
+   * Os lotes são reaproveitados por thread (visit não pode percorrer o índice
+   * de novo).
+   * @param next Função que devolve true e a próxima posição, ou false no fim.
+   */
+  template <typename Next, typename Visitor>
+  void visitBatches(Next&& next, std::size_t batchSize, Visitor&& visit) const {
+    static thread_local std::vector<std::string_view> isbns;
+    static thread_local std::vector<std::string_view> titles;
+    isbns.clear();
+    titles.clear();
+    isbns.reserve(batchSize);
+    titles.reserve(batchSize);
+    std::size_t position;
+    while (next(position)) {
+      const Entry& entry = entries[position];
+      if (!entry.alive) continue;
+      isbns.push_back(view(entry.isbnOffset, entry.isbnLength));
+      titles.push_back(view(entry.titleOffset, entry.titleLength));
+      if (titles.size() == batchSize) {
+        visit(std::span<const std::string_view>(isbns),
+              std::span<const std::string_view>(titles));
+        isbns.clear();
+        titles.clear();
+      }
+    }
+    if (!titles.empty()) {
+      visit(std::span<const std::string_view>(isbns),
+            std::span<const std::string_view>(titles));
+    }
+  }
+
+ public:
+  /**
+   * @brief Normaliza um texto para comparação (minúsculas e sem acentos).
+   * @param text O texto original.
+   * @return O texto normalizado.
+   */
+  static std::string normalize(std::string_view text);
+
+  /**
+   * @brief Versão de normalize() que aloca o resultado em um memory_resource
+   * (ex: a arena da requisição).
+   */
+  static std::pmr::string normalize(std::string_view text,
+                                    std::pmr::memory_resource* memory);
+
+  /**
+   * @brief Retorna o índice do catálogo gerenciado por um DataManager,
+   * construindo-o na primeira chamada e reconstruindo-o se o arquivo mudou
+   * por fora (ex: outro processo).
+   * @param booksDataManager Gerenciador de dados dos livros.
+   * @return O índice compartilhado.
+   */
+  static std::shared_ptr<TitleIndex> forCatalog(DataManager& booksDataManager);
+
+  /**
+   * @brief Informa se a busca deve ignorar o índice de trigramas e pontuar
+   * todos os títulos (variável de ambiente BOOKMATCH_FULL_SCAN diferente de
+   * "0"). Útil para validar os resultados da busca indexada.
+   */
+  static bool fullScanRequested();
+
+  /**
+   * @class Reader
+   * @brief Acesso de leitura ao índice sob uma única trava compartilhada,
+   * para que as posições devolvidas por candidates() continuem válidas
+   * enquanto várias threads percorrem os lotes.
+   */
+  class Reader {
+   private:
+    const TitleIndex* index;
+    std::shared_lock<std::shared_mutex> lock;
+
+   public:
+    explicit Reader(const TitleIndex& index)
+        : index(&index), lock(index.mutex) {}
+
+    /**
+     * @brief Quantidade de posições do índice, incluindo entradas mortas
+     * (limite para forEachBatch(begin, end, ...)).
+     */
+    std::size_t slots() const { return index->entries.size(); }
+
+    /**
+     * @brief Posições dos títulos com pelo menos minShared trigramas em comum
+     * com a consulta. Títulos fora dessa lista nunca são pontuados pela busca
+     * indexada, mesmo que a similaridade deles passe do limite.
+     * @param query A consulta já normalizada.
+     * @param minShared Quantidade mínima de trigramas em comum.
+     * @param out Saída em ordem crescente.
+     */
+    void candidates(std::string_view query, std::size_t minShared,
+                    std::pmr::vector<std::uint32_t>& out) const {
+      index->trigrams.candidates(query, minShared, out);
+    }
+
+    /**
+     * @brief Percorre em lotes as entradas vivas nas posições [begin, end).
+     * @param visit Função chamada com (isbns, títulos normalizados) do lote.
+     */
+    template <typename Visitor>
+    void forEachBatch(std::size_t begin, std::size_t end,
+                      std::size_t batchSize, Visitor&& visit) const {
+      end = std::min(end, slots());
+      index->visitBatches(
+          [&begin, end](std::size_t& position) {
+            if (begin >= end) return false;
+            position = begin++;
+            return true;
+          },
+          batchSize, std::forward<Visitor>(visit));
+    }
+
+    /**
+     * @brief Percorre em lotes as entradas vivas das posições dadas (ex: um
+     * pedaço da saída de candidates()).
+     * @param visit Função chamada com (isbns, títulos normalizados) do lote.
+     */
+    template <typename Visitor>
+    void forEachBatch(std::span<const std::uint32_t> positions,
+                      std::size_t batchSize, Visitor&& visit) const {
+      std::size_t i = 0;
+      index->visitBatches(
+          [&i, positions](std::size_t& position) {
+            if (i >= positions.size()) return false;
+            position = positions[i++];
+            return true;
+          },
+          batchSize, std::forward<Visitor>(visit));
+    }
+  };
+
+  /**
+   * @brief Trava o índice para leitura.
+   */
+  Reader read() const { return Reader(*this); }
+
+  std::size_t size() const;
+  bool empty() const;
+
+  /**
+   * @brief Percorre todas as entradas do índice sob trava de leitura.
+   * @param visit Função chamada com (isbn, título normalizado).
+   */
+  template <typename Visitor>
+  void forEach(Visitor&& visit) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (const Entry& entry : entries) {
+      if (!entry.alive) continue;
+      visit(view(entry.isbnOffset, entry.isbnLength),
+            view(entry.titleOffset, entry.titleLength));
+    }
+  }
+
+  /**
+   * @brief Percorre o índice em lotes, para uso com APIs em lote (ex:
+   * JaroWinkler::similarityBatch).
+   * @param batchSize Quantidade máxima de entradas por lote.
+   * @param visit Função chamada com (isbns, títulos normalizados) do lote.
+   */
+  template <typename Visitor>
+  void forEachBatch(std::size_t batchSize, Visitor&& visit) const {
+    read().forEachBatch(0, SIZE_MAX, batchSize, std::forward<Visitor>(visit));
+  }
+
+  /**
+   * @brief Percorre em lotes apenas as posições [begin, end), permitindo
+   * dividir o índice em fatias processadas por threads diferentes.
+   * @param begin Primeira posição.
+   * @param end Fim do intervalo (limitado a Reader::slots()).
+   * @param batchSize Quantidade máxima de entradas por lote.
+   * @param visit Função chamada com (isbns, títulos normalizados) do lote.
+   */
+  template <typename Visitor>
+  void forEachBatch(std::size_t begin, std::size_t end, std::size_t batchSize,
+                    Visitor&& visit) const {
+    read().forEachBatch(begin, end, batchSize, std::forward<Visitor>(visit));
+  }
+};
+
+#endif  // TITLE_INDEX_H
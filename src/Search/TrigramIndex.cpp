@@ -0,0 +1,206 @@
+/**
+ * @file: TrigramIndex.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do índice invertido de trigramas.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "TrigramIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+// A versão muda quando a normalização dos títulos muda (os trigramas
+// gravados deixariam de corresponder aos títulos)
+const char MAGIC[8] = {'B', 'M', 'T', 'R', 'I', 'G', 'M', '2'};
+
+/**
+ * @brief Cabeçalho do arquivo. Depois dele vêm, para cada trigrama, a chave,
+ * o tamanho da lista e os documentos (todos uint32_t).
+ */
+struct Header {
+  char magic[8];
+  std::uint32_t documents;
+  std::uint32_t reserved;
+  std::uint64_t fingerprint;
+  std::uint64_t trigrams;
+};
+
+std::uint32_t pack(unsigned char a, unsigned char b, unsigned char c) {
+  return (std::uint32_t(a) << 16) | (std::uint32_t(b) << 8) | c;
+}
+
+}  // namespace
+
+/**
+ * @brief Extrai os trigramas de "  texto ".
+ */
+void TrigramIndex::trigramsOf(std::string_view text,
+                              std::vector<std::uint32_t>& out) {
+  out.clear();
+  if (text.empty()) return;
+  auto at = [&text](std::size_t i) -> unsigned char {
+    // Posições do texto completado: 0 e 1 são espaços, o resto é deslocado
+    if (i < 2 || i - 2 >= text.size()) return ' ';
+    return static_cast<unsigned char>(text[i - 2]);
+  };
+  const std::size_t padded = text.size() + 3;
+  out.reserve(padded - 2);
+  for (std::size_t i = 0; i + 2 < padded; ++i) {
+    out.push_back(pack(at(i), at(i + 1), at(i + 2)));
+  }
+  std::sort(out.begin(), out.end());
+  out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+void TrigramIndex::add(std::uint32_t document, std::string_view text) {
+  static thread_local std::vector<std::uint32_t> trigrams;
+  trigramsOf(text, trigrams);
+  for (std::uint32_t trigram : trigrams) postings[trigram].push_back(document);
+  documents = std::max(documents, document + 1);
+}
+
+/**
+ * @brief Une as listas dos trigramas da consulta. O custo é proporcional ao
+ * tamanho dessas listas, e não ao catálogo.
+ */
+void TrigramIndex::candidates(std::string_view query, std::size_t minShared,
+                              std::pmr::vector<std::uint32_t>& out) const {
+  out.clear();
+  static thread_local std::vector<std::uint32_t> trigrams;
+  trigramsOf(query, trigrams);
+  // As listas são procuradas duas vezes para que out seja alocado uma vez só
+  // (em uma arena, cada realocação desperdiçaria o bloco anterior)
+  std::size_t total = 0;
+  for (std::uint32_t trigram : trigrams) {
+    auto it = postings.find(trigram);
+    if (it != postings.end()) total += it->second.size();
+  }
+  out.reserve(total);
+  for (std::uint32_t trigram : trigrams) {
+    auto it = postings.find(trigram);
+    if (it != postings.end()) {
+      out.insert(out.end(), it->second.begin(), it->second.end());
+    }
+  }
+  std::sort(out.begin(), out.end());
+  // Cada documento aparece uma vez por trigrama em comum
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < out.size();) {
+    std::size_t j = i;
+    while (j < out.size() && out[j] == out[i]) ++j;
+    if (j - i >= minShared) out[kept++] = out[i];
+    i = j;
+  }
+  out.resize(kept);
+}
+
+void TrigramIndex::clear() {
+  postings.clear();
+  documents = 0;
+}
+
+std::uint32_t TrigramIndex::documentCount() const { return documents; }
+
+bool TrigramIndex::save(const std::string& path,
+                        std::uint64_t fingerprint) const {
+  Header header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.documents = documents;
+  header.fingerprint = fingerprint;
+  header.trigrams = postings.size();
+
+  std::string tempPath = path + ".tmp";
+  {
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& [trigram, list] : postings) {
+      std::uint32_t count = static_cast<std::uint32_t>(list.size());
+      out.write(reinterpret_cast<const char*>(&trigram), sizeof(trigram));
+      out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+      out.write(reinterpret_cast<const char*>(list.data()),
+                static_cast<std::streamsize>(list.size() * sizeof(list[0])));
+    }
+    if (!out) return false;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) {
+    std::cerr << "Erro ao salvar índice de trigramas: " << ec.message()
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TrigramIndex::load(const std::string& path, std::uint64_t fingerprint,
+                        std::uint32_t documents) {
+  clear();
+  std::ifstream in(path, std::ios::binary);
+  if (!in.is_open()) return false;
+  std::vector<char> bytes((std::istreambuf_iterator<char>(in)),
+                          std::istreambuf_iterator<char>());
+
+  Header header;
+  if (bytes.size() < sizeof(header)) return false;
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.fingerprint != fingerprint || header.documents != documents) {
+    return false;
+  }
+
+  std::size_t offset = sizeof(header);
+  auto read = [&bytes, &offset](void* target, std::size_t size) {
+    if (bytes.size() - offset < size) return false;
+    std::memcpy(target, bytes.data() + offset, size);
+    offset += size;
+    return true;
+  };
+  // Cada trigrama ocupa ao menos 8 bytes (trigrama e contagem)
+  if (header.trigrams >
+      (bytes.size() - offset) / (2 * sizeof(std::uint32_t))) {
+    return false;
+  }
+  postings.reserve(header.trigrams);
+  for (std::uint64_t t = 0; t < header.trigrams; ++t) {
+    std::uint32_t trigram, count;
+    if (!read(&trigram, sizeof(trigram)) || !read(&count, sizeof(count))) {
+      clear();
+      return false;
+    }
+    if ((bytes.size() - offset) / sizeof(std::uint32_t) < count) {
+      clear();
+      return false;
+    }
+    std::vector<std::uint32_t>& list = postings[trigram];
+    list.resize(count);
+    if (!read(list.data(), count * sizeof(std::uint32_t))) {
+      clear();
+      return false;
+    }
+    // A busca usa os documentos como posições no TitleIndex sem conferir os
+    // limites: cada lista tem que ser estritamente crescente e menor que
+    // documents
+    std::uint32_t first = 0;  // Menor valor aceito para o próximo documento
+    for (std::uint32_t document : list) {
+      if (document < first || document >= documents) {
+        clear();
+        return false;
+      }
+      first = document + 1;
+    }
+  }
+  this->documents = documents;
+  return true;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file: TrigramIndex.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do índice invertido de trigramas usado para podar os
+ * candidatos da busca.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TrigramIndex
+ * @brief Índice invertido trigrama -> documentos. Cada texto é completado com
+ * dois espaços no início e um no fim (como no pg_trgm), de forma que mesmo
+ * textos de 1 ou 2 caracteres geram trigramas.
+ *
+ * Os documentos são números (ex: a posição no TitleIndex) e precisam ser
+ * adicionados em ordem crescente, o que mantém as listas ordenadas sem
+ * custo extra. Remoções não passam por aqui: quem usa o índice filtra os
+ * documentos mortos e o reconstrói de tempos em tempos.
+ * @note Não é thread-safe; a sincronização fica com o dono (TitleIndex).
+ */
+class TrigramIndex {
+ private:
+  std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings;
+  std::uint32_t documents = 0;  // Maior documento adicionado + 1
+
+ public:
+  /**
+   * @brief Extrai os trigramas distintos de um texto, em ordem crescente.
+   * @param text O texto (já normalizado).
+   * @param out Saída; o conteúdo anterior é descartado.
+   */
+  static void trigramsOf(std::string_view text,
+                         std::vector<std::uint32_t>& out);
+
+  /**
+   * @brief Adiciona um documento.
+   * @param document O número do documento (maior que todos os anteriores).
+   * @param text O texto (já normalizado).
+   */
+  void add(std::uint32_t document, std::string_view text);
+
+  /**
+   * @brief Documentos que compartilham trigramas com a consulta.
+   * @param query A consulta (já normalizada).
+   * @param minShared Quantidade mínima de trigramas em comum.
+   * @param out Saída em ordem crescente e sem repetições (ex: alocada na
+   * arena da requisição).
+   */
+  void candidates(std::string_view query, std::size_t minShared,
+                  std::pmr::vector<std::uint32_t>& out) const;
+
+  void clear();
+  std::uint32_t documentCount() const;
+
+  /**
+   * @brief Grava o índice em disco (arquivo temporário + rename).
+   * @param path O caminho do arquivo.
+   * @param fingerprint Impressão digital do catálogo indexado.
+   * @return true se o arquivo foi gravado.
+   */
+  bool save(const std::string& path, std::uint64_t fingerprint) const;
+
+  /**
+   * @brief Carrega um índice gravado por save().
+   * @param path O caminho do arquivo.
+   * @param fingerprint A impressão digital esperada.
+   * @param documents A quantidade de documentos esperada.
+   * @return true se o arquivo existe, é válido e corresponde ao catálogo; caso
+   * contrário o índice fica vazio.
+   */
+  bool load(const std::string& path, std::uint64_t fingerprint,
+            std::uint32_t documents);
+};
+
+#endif  // TRIGRAM_INDEX_H
@@ -0,0 +1,98 @@
+/**
+ * @file: Client.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do cliente do servidor do BookMatch.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "Client.h"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+#include "../Service/Service.h"
+
+Client::Client(int fd) : fd(fd) {}
+
+#ifdef __linux__
+
+Client::~Client() {
+  if (fd >= 0) close(fd);
+}
+
+std::unique_ptr<Client> Client::connect(const std::string& socketPath) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+    return nullptr;
+  }
+  std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return nullptr;
+  if (::connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                sizeof(address)) != 0) {
+    close(fd);
+    return nullptr;
+  }
+  return std::unique_ptr<Client>(new Client(fd));
+}
+
+json Client::call(const json& request) {
+  const json lost = Service::error("A conexão com o servidor foi perdida.");
+  if (fd < 0) return lost;
+
+  std::string line =
+      request.dump(-1, ' ', false, json::error_handler_t::replace) + '\n';
+  std::size_t sent = 0;
+  while (sent < line.size()) {
+    ssize_t n = send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      close(fd);
+      fd = -1;
+      return lost;
+    }
+    sent += static_cast<std::size_t>(n);
+  }
+
+  std::size_t newline;
+  while ((newline = buffer.find('\n')) == std::string::npos) {
+    char chunk[16384];
+    ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) {
+      close(fd);
+      fd = -1;
+      return lost;
+    }
+    buffer.append(chunk, static_cast<std::size_t>(n));
+  }
+  json response = json::parse(buffer.begin(), buffer.begin() + newline,
+                              nullptr, false);
+  buffer.erase(0, newline + 1);
+  if (response.is_discarded()) return Service::error("Resposta inválida.");
+  return response;
+}
+
+#else
+
+Client::~Client() {}
+
+std::unique_ptr<Client> Client::connect(const std::string&) { return nullptr; }
+
+json Client::call(const json&) {
+  return Service::error("A conexão com o servidor foi perdida.");
+}
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file: Client.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do cliente do servidor do BookMatch.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+
+using json = nlohmann::json;
+
+/**
+ * @class Client
+ * @brief Conexão com um Server: envia requisições do Service e espera as
+ * respostas (uma linha json em cada sentido).
+ * @note Disponível apenas no Linux; nas demais plataformas connect() sempre
+ * devolve nullptr e a interface usa o Service localmente.
+ */
+class Client {
+ private:
+  int fd;
+  std::string buffer;  // Bytes recebidos depois da última resposta
+
+  explicit Client(int fd);
+
+ public:
+  ~Client();
+  Client(const Client&) = delete;
+  Client& operator=(const Client&) = delete;
+
+  /**
+   * @brief Conecta ao servidor.
+   * @param socketPath O caminho do socket Unix.
+   * @return O cliente, ou nullptr se não houver servidor ouvindo.
+   */
+  static std::unique_ptr<Client> connect(const std::string& socketPath);
+
+  /**
+   * @brief Envia uma requisição e espera a resposta.
+   * @param request A requisição.
+   * @return A resposta, ou uma resposta de erro se a conexão caiu.
+   */
+  json call(const json& request);
+};
+
+#endif  // CLIENT_H
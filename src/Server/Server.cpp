@@ -0,0 +1,408 @@
+/**
+ * @file: Server.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do servidor do BookMatch (socket Unix + epoll).
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "Server.h"
+
+#include <cstdlib>
+#include <iostream>
+
+#ifdef __linux__
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../Utils/ThreadPool.h"
+#endif
+
+Server::Server(Service& service, const std::string& socketPath)
+    : service(service), socketPath(socketPath) {}
+
+std::string Server::defaultSocketPath() {
+  if (const char* env = std::getenv("BOOKMATCH_SOCKET")) {
+    if (*env != '\0') return env;
+  }
+  return "data/bookmatch.sock";
+}
+
+#ifdef __linux__
+
+namespace {
+
+// Tamanho máximo de uma linha (requisição) recebida
+const std::size_t MAX_LINE = 1 << 20;
+// Eventos tratados por chamada a epoll_wait
+const int MAX_EVENTS = 64;
+// Identificadores reservados no epoll; as conexões usam os seguintes
+const std::uint64_t LISTENER_ID = 0;
+const std::uint64_t WAKEUP_ID = 1;
+const std::uint64_t SIGNAL_ID = 2;
+const std::uint64_t FIRST_CONNECTION_ID = 3;
+
+/**
+ * @brief Estado de um cliente conectado.
+ */
+struct Connection {
+  int fd = -1;
+  std::string in;   // Bytes recebidos que ainda não formam uma requisição
+  std::string out;  // Respostas ainda não enviadas
+  bool busy = false;      // Há uma requisição sendo executada
+  bool watchingOut = false;  // EPOLLOUT registrado
+  Service::Session session;
+};
+
+/**
+ * @brief Resposta pronta, entregue por um worker ao laço de eventos.
+ */
+struct Completion {
+  std::uint64_t id;
+  std::string line;
+};
+
+/**
+ * @class EventLoop
+ * @brief O laço de eventos do servidor. Só a thread de run() mexe nas
+ * conexões; os workers recebem a linha e a Session da conexão (que fica
+ * reservada enquanto busy) e devolvem a resposta por completions + eventfd.
+ */
+class EventLoop {
+ private:
+  Service& service;
+  int listener;
+  int wakeup;
+  int signals;
+  int epoll;
+  std::uint64_t nextId = FIRST_CONNECTION_ID;
+  std::unordered_map<std::uint64_t, std::unique_ptr<Connection>> connections;
+  std::mutex completionsMutex;
+  std::vector<Completion> completions;
+  // Declarado por último: é destruído (esperando os workers) antes do resto
+  ThreadPool pool;
+
+  bool watch(int fd, std::uint64_t id, std::uint32_t events, int op) {
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = id;
+    return epoll_ctl(epoll, op, fd, &event) == 0;
+  }
+
+  /**
+   * @brief Fecha o socket do cliente. Se houver uma requisição em execução, a
+   * conexão só é descartada quando a resposta chegar.
+   */
+  void close(std::uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+    Connection& connection = *it->second;
+    if (connection.fd >= 0) {
+      epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+      ::close(connection.fd);
+      connection.fd = -1;
+    }
+    if (!connection.busy) connections.erase(it);
+  }
+
+  void accept() {
+    while (true) {
+      int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd < 0) {
+        if (errno == EINTR) continue;
+        return;  // EAGAIN: não há mais conexões pendentes
+      }
+      std::uint64_t id = nextId++;
+      if (!watch(fd, id, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD)) {
+        ::close(fd);
+        continue;
+      }
+      auto connection = std::make_unique<Connection>();
+      connection->fd = fd;
+      connections.emplace(id, std::move(connection));
+    }
+  }
+
+  /**
+   * @brief Envia o que for possível sem bloquear.
+   * @return false se a conexão foi fechada.
+   */
+  bool flush(std::uint64_t id, Connection& connection) {
+    std::size_t sent = 0;
+    while (sent < connection.out.size()) {
+      ssize_t n = send(connection.fd, connection.out.data() + sent,
+                       connection.out.size() - sent, MSG_NOSIGNAL);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        close(id);
+        return false;
+      }
+      sent += static_cast<std::size_t>(n);
+    }
+    connection.out.erase(0, sent);
+
+    // Só pede EPOLLOUT enquanto houver algo pendente
+    bool wantOut = !connection.out.empty();
+    if (wantOut != connection.watchingOut) {
+      std::uint32_t events = EPOLLIN | EPOLLRDHUP;
+      if (wantOut) events |= EPOLLOUT;
+      if (!watch(connection.fd, id, events, EPOLL_CTL_MOD)) {
+        close(id);
+        return false;
+      }
+      connection.watchingOut = wantOut;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Envia a próxima requisição completa da conexão para o pool, se
+   * nenhuma estiver em execução.
+   */
+  void dispatch(std::uint64_t id, Connection& connection) {
+    while (!connection.busy) {
+      std::size_t newline = connection.in.find('\n');
+      if (newline == std::string::npos) return;
+      std::string line = connection.in.substr(0, newline);
+      connection.in.erase(0, newline + 1);
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      if (line.empty()) continue;
+
+      connection.busy = true;
+      Service::Session* session = &connection.session;
+      pool.submit([this, id, session, line = std::move(line)] {
+        json request = json::parse(line, nullptr, false);
+        json response = request.is_discarded()
+                            ? Service::error("Requisição inválida.")
+                            : service.handle(request, *session);
+        std::string reply =
+            response.dump(-1, ' ', false, json::error_handler_t::replace);
+        reply += '\n';
+        {
+          std::lock_guard<std::mutex> lock(completionsMutex);
+          completions.push_back({id, std::move(reply)});
+        }
+        std::uint64_t one = 1;
+        ssize_t written = write(wakeup, &one, sizeof(one));
+        (void)written;  // O eventfd só falharia se o contador estourasse
+      });
+    }
+  }
+
+  void receive(std::uint64_t id, std::uint32_t events) {
+    auto it = connections.find(id);
+    if (it == connections.end() || it->second->fd < 0) return;
+    Connection& connection = *it->second;
+
+    if (events & EPOLLOUT) {
+      if (!flush(id, connection)) return;
+    }
+    if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+      char buffer[16384];
+      while (true) {
+        ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+          connection.in.append(buffer, static_cast<std::size_t>(n));
+          continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        close(id);  // Cliente desconectou (ou erro)
+        return;
+      }
+      // Uma linha maior que o limite nunca vai ser aceita
+      if (connection.in.size() > MAX_LINE &&
+          connection.in.find('\n') == std::string::npos) {
+        close(id);
+        return;
+      }
+    }
+    dispatch(id, connection);
+  }
+
+  void complete() {
+    std::uint64_t count;
+    ssize_t n = read(wakeup, &count, sizeof(count));
+    (void)n;
+    std::vector<Completion> ready;
+    {
+      std::lock_guard<std::mutex> lock(completionsMutex);
+      ready.swap(completions);
+    }
+    for (Completion& completion : ready) {
+      auto it = connections.find(completion.id);
+      if (it == connections.end()) continue;
+      Connection& connection = *it->second;
+      connection.busy = false;
+      if (connection.fd < 0) {  // Fechada enquanto a requisição executava
+        connections.erase(it);
+        continue;
+      }
+      connection.out += completion.line;
+      if (!flush(completion.id, connection)) continue;
+      dispatch(completion.id, connection);
+    }
+  }
+
+ public:
+  EventLoop(Service& service, int listener, int wakeup, int signals, int epoll)
+      : service(service),
+        listener(listener),
+        wakeup(wakeup),
+        signals(signals),
+        epoll(epoll),
+        // A thread do laço não executa requisições, então o pool tem uma
+        // thread a mais que o configurado (e pelo menos um worker)
+        pool(ThreadPool::configuredThreads() + 1) {}
+
+  ~EventLoop() {
+    for (auto& [id, connection] : connections) {
+      if (connection->fd >= 0) ::close(connection->fd);
+    }
+  }
+
+  bool run() {
+    if (!watch(listener, LISTENER_ID, EPOLLIN, EPOLL_CTL_ADD) ||
+        !watch(wakeup, WAKEUP_ID, EPOLLIN, EPOLL_CTL_ADD) ||
+        !watch(signals, SIGNAL_ID, EPOLLIN, EPOLL_CTL_ADD)) {
+      return false;
+    }
+    epoll_event events[MAX_EVENTS];
+    while (true) {
+      int n = epoll_wait(epoll, events, MAX_EVENTS, -1);
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        return false;
+      }
+      for (int i = 0; i < n; ++i) {
+        std::uint64_t id = events[i].data.u64;
+        if (id == SIGNAL_ID) {
+          return true;  // SIGINT ou SIGTERM
+        } else if (id == LISTENER_ID) {
+          accept();
+        } else if (id == WAKEUP_ID) {
+          complete();
+        } else {
+          receive(id, events[i].events);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * @brief Verifica se já há um servidor ouvindo no caminho.
+ */
+bool serverRunning(const sockaddr_un& address) {
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  bool running = connect(fd, reinterpret_cast<const sockaddr*>(&address),
+                         sizeof(address)) == 0;
+  close(fd);
+  return running;
+}
+
+}  // namespace
+
+int Server::run() {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Caminho de socket inválido: '" << socketPath << "'."
+              << std::endl;
+    return 1;
+  }
+  std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+  // Um socket que sobrou de um servidor encerrado à força é removido; um
+  // servidor que ainda responde não é substituído
+  struct stat status;
+  if (lstat(socketPath.c_str(), &status) == 0) {
+    if (!S_ISSOCK(status.st_mode)) {
+      std::cerr << "'" << socketPath << "' existe e não é um socket."
+                << std::endl;
+      return 1;
+    }
+    if (serverRunning(address)) {
+      std::cerr << "Já existe um servidor ouvindo em '" << socketPath << "'."
+                << std::endl;
+      return 1;
+    }
+    unlink(socketPath.c_str());
+  }
+
+  // Os sinais são bloqueados antes de qualquer thread ser criada (todas herdam
+  // a máscara) e tratados só pelo signalfd
+  sigset_t mask;
+  sigemptyset(&mask);
+  sigaddset(&mask, SIGINT);
+  sigaddset(&mask, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+
+  std::cout << "Carregando o catálogo..." << std::endl;
+  service.preload();
+
+  int listener =
+      socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listener < 0 ||
+      bind(listener, reinterpret_cast<const sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listener, SOMAXCONN) != 0) {
+    std::cerr << "Não foi possível abrir o socket '" << socketPath
+              << "': " << std::strerror(errno) << std::endl;
+    if (listener >= 0) close(listener);
+    return 1;
+  }
+  int wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  int signals = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  int epoll = epoll_create1(EPOLL_CLOEXEC);
+
+  bool ok = false;
+  if (wakeup >= 0 && signals >= 0 && epoll >= 0) {
+    std::cout << "Servidor do BookMatch ouvindo em '" << socketPath << "'."
+              << std::endl;
+    EventLoop loop(service, listener, wakeup, signals, epoll);
+    ok = loop.run();
+    // O destrutor espera as requisições em execução terminarem
+  }
+  if (!ok) {
+    std::cerr << "Erro no servidor: " << std::strerror(errno) << std::endl;
+  }
+
+  DataManager::flushAll();
+  close(listener);
+  unlink(socketPath.c_str());
+  for (int fd : {wakeup, signals, epoll}) {
+    if (fd >= 0) close(fd);
+  }
+  std::cout << "Servidor encerrado." << std::endl;
+  return ok ? 0 : 1;
+}
+
+#else
+
+int Server::run() {
+  std::cerr << "O modo servidor só está disponível no Linux." << std::endl;
+  return 1;
+}
+
+#endif
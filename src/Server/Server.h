@@ -0,0 +1,61 @@
+/**
+ * @file: Server.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição do servidor do BookMatch, que mantém os índices em
+ * memória e atende vários clientes por um socket local.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <string>
+
+#include "../Service/Service.h"
+
+/**
+ * @class Server
+ * @brief Servidor de longa duração: carrega o catálogo e os índices uma vez e
+ * responde às requisições do Service vindas de vários clientes ao mesmo tempo.
+ *
+ * Protocolo: um socket Unix (stream) em que cada linha é um json. O cliente
+ * envia uma requisição por linha e recebe uma resposta por linha, na mesma
+ * ordem. Cada conexão tem a sua Session.
+ *
+ * Uma única thread aceita as conexões e faz toda a entrada e saída (epoll);
+ * as requisições são executadas por um pool de threads, no máximo uma por
+ * conexão de cada vez. SIGINT e SIGTERM encerram o servidor e removem o
+ * socket.
+ * @note Disponível apenas no Linux; nas demais plataformas run() falha.
+ */
+class Server {
+ private:
+  Service& service;
+  std::string socketPath;
+
+ public:
+  /**
+   * @brief Cria o servidor (o socket só é aberto em run()).
+   * @param service O serviço que executa as requisições.
+   * @param socketPath O caminho do socket Unix.
+   */
+  Server(Service& service, const std::string& socketPath);
+
+  /**
+   * @brief Atende os clientes até receber SIGINT ou SIGTERM.
+   * @return 0 ao encerrar normalmente, 1 em caso de erro.
+   */
+  int run();
+
+  /**
+   * @brief Caminho padrão do socket: a variável de ambiente BOOKMATCH_SOCKET,
+   * ou "data/bookmatch.sock".
+   */
+  static std::string defaultSocketPath();
+};
+
+#endif  // SERVER_H
@@ -0,0 +1,503 @@
+/**
+ * @file: Service.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação da camada de serviço do BookMatch.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "Service.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../Book/Book.h"
+#include "../Catalog/BinaryCatalog.h"
+#include "../History/History.h"
+#include "../Ratings/Ratings.h"
+#include "../Recommendations/CoOccurrence.h"
+#include "../Recommendations/ContentSimilarity.h"
+#include "../Recommendations/EmbeddingIndex.h"
+#include "../Recommendations/Recommendations.h"
+#include "../Search/JaroWinkler.h"
+#include "../Search/TitleIndex.h"
+#include "../User/User.h"
+#include "../Utils/RequestArena.h"
+#include "../Utils/ThreadPool.h"
+#include "../Utils/TopK.h"
+
+namespace {
+
+// Mínimo de títulos por fatia da busca paralela (abaixo disso o custo de
+// distribuir o trabalho supera o ganho)
+const std::size_t MIN_TITLES_PER_SHARD = 8192;
+// Similaridade mínima (exclusiva) para um título aparecer na busca
+const double SIMILARITY_THRESHOLD = 0.67;
+// Consultas mais curtas que isso (em bytes, já normalizadas) varrem o índice
+// inteiro em vez de usar os trigramas
+const std::size_t MIN_INDEXED_QUERY_LENGTH = 3;
+// Trigramas em comum com a consulta para um título ser pontuado. Nenhum
+// valor é exato: Jaro-Winkler tolera transposições, e "bacd" e "abdc" têm
+// similaridade ~0.83 sem nenhum trigrama em comum. Valores maiores podam
+// mais, mas perdem mais títulos acima do limite
+const std::size_t MIN_SHARED_TRIGRAMS = 1;
+// Quantidade padrão de resultados da busca
+const std::size_t DEFAULT_SEARCH_LIMIT = 10;
+// Maior quantidade de resultados que uma requisição pode pedir (a busca
+// reserva um heap desse tamanho por fatia)
+const std::size_t MAX_RESULT_LIMIT = 100;
+// Títulos pontuados por chamada de JaroWinkler::similarityBatch
+const std::size_t SEARCH_BATCH_SIZE = 256;
+// Livros parecidos exibidos junto com os detalhes de um livro
+const std::size_t INFO_SIMILAR_LIMIT = 3;
+
+/**
+ * @brief Ordem dos resultados da busca: maior similaridade primeiro e, em
+ * caso de empate, menor ISBN. Por ser uma ordem total, o resultado não
+ * depende da quantidade de threads.
+ */
+struct SearchRanking {
+  template <typename A, typename B>
+  bool operator()(const A& a, const B& b) const {
+    if (a.first != b.first) return a.first > b.first;
+    return a.second < b.second;
+  }
+};
+
+/**
+ * @brief Lê um campo de texto da requisição (vazio se ausente).
+ */
+std::string textField(const json& request, const char* key) {
+  auto it = request.find(key);
+  if (it == request.end() || !it->is_string()) return {};
+  return it->get<std::string>();
+}
+
+/**
+ * @brief Lê o limite de resultados da requisição: o padrão se ausente, e no
+ * máximo MAX_RESULT_LIMIT.
+ * @return std::nullopt se o limite não é um inteiro positivo.
+ */
+std::optional<std::size_t> limitField(const json& request,
+                                      std::size_t fallback) {
+  auto it = request.find("limit");
+  if (it == request.end()) return fallback;
+  if (!it->is_number_integer()) return std::nullopt;
+  // Valores sem sinal acima de INT64_MAX viram negativos e são recusados
+  std::int64_t limit = it->get<std::int64_t>();
+  if (limit <= 0) return std::nullopt;
+  return std::min(static_cast<std::size_t>(limit), MAX_RESULT_LIMIT);
+}
+
+}  // namespace
+
+Service::Service(const std::string& directory)
+    : userDataManager("users.json", directory),
+      booksDataManager("books.json", directory),
+      historyDataManager("history.json", directory),
+      ratingsDataManager("ratings.json", directory) {}
+
+void Service::preload() {
+  BinaryCatalog::openFor(booksDataManager);
+  TitleIndex::forCatalog(booksDataManager);
+  ContentSimilarity::forCatalog(booksDataManager)->refresh();
+  EmbeddingIndex::refreshFor(booksDataManager);
+}
+
+json Service::error(const std::string& message) {
+  return {{"ok", false}, {"error", message}};
+}
+
+/**
+ * @brief Despacha a requisição para o comando correspondente. As alocações
+ * temporárias da busca e das recomendações ficam na arena da requisição.
+ */
+json Service::handle(const json& request, Session& session) {
+  if (!request.is_object()) return error("Requisição inválida.");
+  const std::string command = textField(request, "cmd");
+  RequestArena arena;
+  try {
+    if (command == "usuario") {
+      return userExists(textField(request, "user"));
+    } else if (command == "cadastro") {
+      return registerUser(textField(request, "user"),
+                          textField(request, "password"), session);
+    } else if (command == "login") {
+      return login(textField(request, "user"), textField(request, "password"),
+                   session);
+    } else if (command == "busca") {
+      std::optional<std::size_t> limit =
+          limitField(request, DEFAULT_SEARCH_LIMIT);
+      if (!limit) return error("O limite deve ser um inteiro positivo.");
+      return search(textField(request, "query"), *limit, &arena);
+    } else if (command == "similares") {
+      std::optional<std::size_t> limit =
+          limitField(request, ContentSimilarity::NEIGHBORS);
+      if (!limit) return error("O limite deve ser um inteiro positivo.");
+      return similar(textField(request, "isbn"), *limit);
+    } else if (command == "estatisticas") {
+      return statistics();
+    }
+
+    if (!session.loggedIn) return error("Faça login primeiro.");
+    if (command == "info") {
+      return info(textField(request, "isbn"), session, &arena);
+    } else if (command == "historico") {
+      return history(session);
+    } else if (command == "homepage") {
+      return homePage(session, &arena);
+    } else if (command == "avaliar") {
+      auto score = request.find("nota");
+      if (score == request.end() || !score->is_number_integer()) {
+        return error("A nota deve ser um número inteiro.");
+      }
+      // Em 64 bits, porque get<int>() truncaria 4294967299 para 3 (valores
+      // sem sinal acima de INT64_MAX viram negativos e são recusados)
+      return rate(textField(request, "isbn"), score->get<std::int64_t>(),
+                  session);
+    }
+  } catch (const std::exception& e) {
+    return error(std::string("Erro interno: ") + e.what());
+  }
+  return error("Comando '" + command + "' desconhecido.");
+}
+
+json Service::userExists(const std::string& username) {
+  User user(userDataManager);
+  user.setUsername(username);
+  return {{"ok", true}, {"exists", user.exists()}};
+}
+
+json Service::registerUser(const std::string& username,
+                           const std::string& password, Session& session) {
+  if (username.empty()) return error("Nome de usuário inválido.");
+  User user(userDataManager);
+  user.setUsername(username);
+  user.hashPassword(password);
+  if (!user.create()) {
+    if (user.exists()) return error("O usuário '" + username + "' já existe.");
+    return error("Ocorreu um erro crítico ao salvar o usuário.");
+  }
+  session.username = username;
+  session.loggedIn = true;
+  return {{"ok", true}};
+}
+
+json Service::login(const std::string& username, const std::string& password,
+                    Session& session) {
+  User user(userDataManager);
+  user.setUsername(username);
+  if (!user.exists()) return error("Usuário não cadastrado.");
+  user.load();
+
+  User validator(userDataManager);  // Usado apenas para validar a senha
+  validator.hashPassword(password);
+  if (validator.getPasswordHash() != user.getPasswordHash()) {
+    return error("Senha incorreta, tente novamente.");
+  }
+  session.username = username;
+  session.loggedIn = true;
+  return {{"ok", true}};
+}
+
+json Service::statistics() {
+  RequestArena::Stats arena = RequestArena::stats();
+  SearchCache::Stats cache = searchCache.stats();
+  CoOccurrence::Stats neighbors =
+      CoOccurrence::forHistory(booksDataManager, historyDataManager)->stats();
+  ContentSimilarity::Stats content =
+      ContentSimilarity::forCatalog(booksDataManager)->stats();
+  return {{"ok", true},
+          {"arena",
+           {{"requests", arena.requests},
+            {"allocations", arena.allocations},
+            {"bytes", arena.bytes},
+            {"upstreamAllocations", arena.upstreamAllocations},
+            {"upstreamBytes", arena.upstreamBytes},
+            {"bufferBytes", arena.bufferBytes}}},
+          {"searchCache",
+           {{"hits", cache.hits},
+            {"misses", cache.misses},
+            {"evictions", cache.evictions},
+            {"invalidations", cache.invalidations},
+            {"entries", cache.entries},
+            {"bytes", cache.bytes},
+            {"maxEntries", cache.maxEntries},
+            {"maxBytes", cache.maxBytes}}},
+          {"neighbors",
+           {{"users", neighbors.users},
+            {"entries", neighbors.entries},
+            {"books", neighbors.books},
+            {"neighbors", neighbors.neighbors},
+            {"pendingUsers", neighbors.pendingUsers},
+            {"version", neighbors.version},
+            {"refreshes", neighbors.refreshes},
+            {"lastDirtyBooks", neighbors.lastDirtyBooks},
+            {"lastRefreshMs", neighbors.lastRefreshMs}}},
+          {"similar",
+           {{"books", content.books},
+            {"terms", content.terms},
+            {"entries", content.entries},
+            {"neighbors", content.neighbors},
+            {"builds", content.builds},
+            {"refreshes", content.refreshes},
+            {"loaded", content.loaded},
+            {"lastDirtyBooks", content.lastDirtyBooks},
+            {"lastBuildMs", content.lastBuildMs}}}};
+}
+
+/**
+ * @brief Busca livros pelo título usando similaridade Jaro-Winkler. Buscas
+ * repetidas (mesma consulta normalizada e limite) vêm do SearchCache enquanto
+ * o catálogo não mudar.
+ */
+json Service::search(const std::string& query, std::size_t limit,
+                     std::pmr::memory_resource* memory) {
+  // Lida antes de tudo: se o catálogo mudar durante a busca, o resultado é
+  // guardado com a geração antiga e não será reaproveitado
+  const std::uint64_t generation = booksDataManager.generation();
+  // Títulos já normalizados; só a consulta precisa ser normalizada
+  std::shared_ptr<TitleIndex> index = TitleIndex::forCatalog(booksDataManager);
+  json response = {{"ok", true},
+                   {"total", index->size()},
+                   {"results", json::array()}};
+  if (index->empty()) return response;
+  // Títulos e autores vêm do catálogo binário (aberto antes de travar o
+  // índice, que fica travado até o fim)
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+  auto addResult = [&books, &response](std::string_view isbn,
+                                       double similarity) {
+    std::optional<std::size_t> row = books->find(isbn);
+    json item = {{"isbn", isbn},
+                 {"title", ""},
+                 {"author", ""},
+                 {"similarity", similarity}};
+    if (row) {
+      item["title"] = books->field(BinaryCatalog::TITLE, *row);
+      item["author"] = books->field(BinaryCatalog::AUTHOR, *row);
+    }
+    response["results"].push_back(std::move(item));
+  };
+
+  // Similaridade Jaro-Winkler
+  std::pmr::string queryNorm = TitleIndex::normalize(query, memory);
+  if (std::shared_ptr<const SearchCache::Hits> cached =
+          searchCache.find(queryNorm, limit, generation)) {
+    for (const auto& [similarity, isbn] : *cached) addResult(isbn, similarity);
+    return response;
+  }
+
+  // Só são pontuados os títulos com algum trigrama em comum com a consulta
+  // (busca aproximada, ver MIN_SHARED_TRIGRAMS), a não ser que a varredura
+  // completa tenha sido pedida (para validação) ou que a consulta seja curta
+  // demais para os trigramas discriminarem algo
+  TitleIndex::Reader reader = index->read();
+  const bool fullScan = TitleIndex::fullScanRequested() ||
+                        queryNorm.size() < MIN_INDEXED_QUERY_LENGTH;
+  std::pmr::vector<std::uint32_t> candidates(memory);
+  if (!fullScan) {
+    reader.candidates(queryNorm, MIN_SHARED_TRIGRAMS, candidates);
+  }
+
+  // Os candidatos são divididos em fatias pontuadas em paralelo; cada fatia
+  // guarda só os seus limit melhores, e os heaps são unidos no final
+  ThreadPool& pool = ThreadPool::shared();
+  const std::size_t titles = fullScan ? reader.slots() : candidates.size();
+  const std::size_t shards = std::max<std::size_t>(
+      1, std::min(pool.size() * 4,
+                  (titles + MIN_TITLES_PER_SHARD - 1) / MIN_TITLES_PER_SHARD));
+  const std::size_t shardSize = (titles + shards - 1) / shards;
+
+  // Os ISBNs apontam para o índice (válidos enquanto reader existir). A arena
+  // não é thread-safe, então tudo o que as fatias usam é alocado aqui antes
+  using Result = std::pair<double, std::string_view>;  // (similaridade, ISBN)
+  using Top =
+      TopK<Result, SearchRanking, std::pmr::polymorphic_allocator<Result>>;
+  std::pmr::vector<Top> shardResults(memory);
+  shardResults.reserve(shards);
+  for (std::size_t shard = 0; shard < shards; ++shard) {
+    shardResults.emplace_back(limit, SearchRanking(), memory);
+  }
+  std::pmr::vector<double> shardScores(shards * SEARCH_BATCH_SIZE, memory);
+  pool.parallelFor(shards, [&](std::size_t shard) {
+    Top& top = shardResults[shard];
+    std::span<double> scores = std::span<double>(shardScores).subspan(
+        shard * SEARCH_BATCH_SIZE, SEARCH_BATCH_SIZE);
+    auto score = [&](std::span<const std::string_view> isbns,
+                     std::span<const std::string_view> titles) {
+      // Limite de similaridade: títulos que nem no melhor caso passariam
+      // dele não chegam a ser pontuados
+      JaroWinkler::similarityBatch(queryNorm, titles,
+                                   scores.first(titles.size()),
+                                   SIMILARITY_THRESHOLD);
+      for (std::size_t i = 0; i < titles.size(); ++i) {
+        if (scores[i] <= SIMILARITY_THRESHOLD) continue;
+        top.push(Result(scores[i], isbns[i]));
+      }
+    };
+    const std::size_t begin = std::min(titles, shard * shardSize);
+    const std::size_t end = std::min(titles, begin + shardSize);
+    if (fullScan) {
+      reader.forEachBatch(begin, end, SEARCH_BATCH_SIZE, score);
+    } else {
+      reader.forEachBatch(
+          std::span<const std::uint32_t>(candidates).subspan(begin, end - begin),
+          SEARCH_BATCH_SIZE, score);
+    }
+  });
+
+  Top best(limit, SearchRanking(), memory);
+  for (auto& top : shardResults) best.merge(std::move(top));
+
+  SearchCache::Hits hits;
+  for (const Result& result : best.take()) {
+    addResult(result.second, result.first);
+    hits.emplace_back(result.first, std::string(result.second));
+  }
+  searchCache.store(queryNorm, limit, generation, std::move(hits));
+  return response;
+}
+
+/**
+ * @brief Detalhes de um livro; a consulta entra no histórico do usuário.
+ */
+json Service::info(const std::string& isbn, Session& session,
+                   std::pmr::memory_resource* memory) {
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+  std::optional<std::size_t> row = books->find(isbn);
+  if (!row) {
+    return error("O livro com o ISBN '" + isbn + "' não foi encontrado.");
+  }
+  Book book(books->at(*row), booksDataManager);
+  User user(userDataManager);
+  user.setUsername(session.username);
+  History userHistory(historyDataManager, user);
+  std::string added = isbn;
+  userHistory.add(added);
+  Recommendations(booksDataManager, historyDataManager, session.username)
+      .added(userHistory.get(), memory);
+
+  Ratings ratings(ratingsDataManager);
+  Ratings::Summary summary = ratings.summary(isbn);
+  json bookJson = book.toJson();
+  bookJson["isbn"] = isbn;
+  bookJson["rating"] = summary.average();
+  bookJson["ratings"] = summary.count;
+  if (std::optional<int> score = ratings.userScore(session.username, isbn)) {
+    bookJson["userRating"] = *score;
+  }
+  json similarBooks = similar(isbn, INFO_SIMILAR_LIMIT)["results"];
+  return {{"ok", true}, {"book", bookJson}, {"similar", similarBooks}};
+}
+
+/**
+ * @brief Livros com a descrição mais parecida com a de um livro ("mais como
+ * este"), lidos dos vizinhos pré-calculados (ver ContentSimilarity).
+ */
+json Service::similar(const std::string& isbn, std::size_t limit) {
+  std::shared_ptr<const ContentSimilarity::Model> model =
+      ContentSimilarity::forCatalog(booksDataManager)->model();
+  const BinaryCatalog& books = model->getCatalog();
+  std::optional<std::size_t> row = books.find(isbn);
+  json results = json::array();
+  if (!row) {
+    // Livro novo, ainda fora do modelo servido enquanto ele é atualizado
+    if (BinaryCatalog::openFor(booksDataManager)->find(isbn)) {
+      return {{"ok", true}, {"results", results}};
+    }
+    return error("O livro com o ISBN '" + isbn + "' não foi encontrado.");
+  }
+  for (const ContentSimilarity::Neighbor& neighbor : model->neighbors(*row)) {
+    if (results.size() == limit) break;
+    results.push_back(
+        {{"isbn", books.field(BinaryCatalog::ISBN, neighbor.row)},
+         {"title", books.field(BinaryCatalog::TITLE, neighbor.row)},
+         {"author", books.field(BinaryCatalog::AUTHOR, neighbor.row)},
+         {"similarity", neighbor.score}});
+  }
+  return {{"ok", true}, {"results", results}};
+}
+
+/**
+ * @brief Grava a nota do usuário para um livro e devolve o agregado novo.
+ */
+json Service::rate(const std::string& isbn, std::int64_t score,
+                   Session& session) {
+  if (score < Ratings::MIN_SCORE || score > Ratings::MAX_SCORE) {
+    return error("A nota deve ser de " + std::to_string(Ratings::MIN_SCORE) +
+                 " a " + std::to_string(Ratings::MAX_SCORE) + ".");
+  }
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+  if (!books->find(isbn)) {
+    return error("O livro com o ISBN '" + isbn + "' não foi encontrado.");
+  }
+  Ratings ratings(ratingsDataManager);
+  if (!ratings.rate(session.username, isbn, static_cast<int>(score))) {
+    return error("Não foi possível gravar a avaliação.");
+  }
+  Ratings::Summary summary = ratings.summary(isbn);
+  return {{"ok", true},
+          {"rating", summary.average()},
+          {"ratings", summary.count}};
+}
+
+/**
+ * @brief Histórico do usuário, com os títulos lidos do catálogo binário (sem
+ * carregar o books.json em memória).
+ */
+json Service::history(Session& session) {
+  User user(userDataManager);
+  user.setUsername(session.username);
+  History userHistory(historyDataManager, user);
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+
+  json items = json::array();
+  for (const std::string& isbn : userHistory.get()) {
+    std::optional<std::size_t> row = books->find(isbn);
+    items.push_back(
+        {{"isbn", isbn},
+         {"title", row ? books->field(BinaryCatalog::TITLE, *row) : ""}});
+  }
+  return {{"ok", true}, {"items", items}};
+}
+
+/**
+ * @brief Recomendações do usuário (ver Recommendations), com os títulos lidos
+ * do catálogo binário.
+ */
+json Service::homePage(Session& session, std::pmr::memory_resource* memory) {
+  User user(userDataManager);
+  user.setUsername(session.username);
+  History history(historyDataManager, user);
+  Recommendations userRecommendations(booksDataManager, historyDataManager,
+                                      session.username);
+  std::vector<std::string> isbns =
+      userRecommendations.get(history.get(), memory);
+  std::shared_ptr<const BinaryCatalog> books =
+      BinaryCatalog::openFor(booksDataManager);
+
+  json recommendations = json::array();
+  for (const std::string& isbn : isbns) {
+    std::optional<std::size_t> row = books->find(isbn);
+    recommendations.push_back(
+        {{"isbn", isbn},
+         {"title", row ? books->field(BinaryCatalog::TITLE, *row) : ""}});
+  }
+  return {{"ok", true}, {"recommendations", recommendations}};
+}
@@ -0,0 +1,122 @@
+/**
+ * @file: Service.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição da camada de serviço do BookMatch, que executa os
+ * comandos e devolve os resultados em json.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef SERVICE_H
+#define SERVICE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <nlohmann/json.hpp>
+#include <string>
+
+#include "../DataManager/DataManager.h"
+#include "../Search/SearchCache.h"
+
+using json = nlohmann::json;
+
+/**
+ * @class Service
+ * @brief Executa os comandos do BookMatch (busca, info, histórico e
+ * recomendações) sem nenhuma saída no terminal: cada requisição e cada
+ * resposta é um json, de forma que o mesmo código atende a interface local e
+ * o servidor (ver Server).
+ *
+ * Requisições: {"cmd": "...", ...}. Respostas: {"ok": true, ...} ou
+ * {"ok": false, "error": "mensagem"}.
+ * - {"cmd": "usuario", "user"} -> {"exists"}
+ * - {"cmd": "cadastro", "user", "password"} -> cadastra e inicia a sessão
+ * - {"cmd": "login", "user", "password"} -> inicia a sessão
+ * - {"cmd": "busca", "query", "limit"?} -> {"total", "results": [{"isbn",
+ *   "title", "author", "similarity"}]}. A busca é aproximada: com consultas
+ *   de 3 bytes ou mais (normalizadas), só são pontuados os títulos com algum
+ *   trigrama em comum com a consulta, e um título com similaridade acima do
+ *   limite mas sem trigrama em comum (ex: letras trocadas de lugar) fica de
+ *   fora. BOOKMATCH_FULL_SCAN=1 pontua todos os títulos.
+ * - {"cmd": "info", "isbn"} -> {"book"} (e adiciona ao histórico); o livro
+ *   traz "rating" (média), "ratings" (quantidade de notas) e "userRating" (a
+ *   nota do usuário, se ele já avaliou), mais "similar" (como em similares)
+ * - {"cmd": "similares", "isbn", "limit"?} -> {"results": [{"isbn", "title",
+ *   "author", "similarity"}]} (livros com a descrição mais parecida, ver
+ *   ContentSimilarity)
+ * - {"cmd": "historico"} -> {"items": [{"isbn", "title"}]}
+ * - {"cmd": "homepage"} -> {"recommendations": [{"isbn", "title"}]}
+ * - {"cmd": "avaliar", "isbn", "nota"} -> {"rating", "ratings"} (grava a nota
+ *   de 0 a 5 do usuário e devolve a média e a quantidade de notas do livro)
+ * - {"cmd": "estatisticas"} -> {"arena", "searchCache", "neighbors",
+ *   "similar"} (contadores da RequestArena, do SearchCache, do CoOccurrence
+ *   e do ContentSimilarity)
+ *
+ * "limit" é opcional e deve ser um inteiro positivo; valores acima de 100
+ * são reduzidos a 100. info, historico, homepage e avaliar exigem sessão.
+ * Pode ser usado por várias threads ao mesmo tempo, desde que cada uma use a
+ * sua Session.
+ */
+class Service {
+ public:
+  /**
+   * @brief Estado de uma conexão (ou da interface local).
+   */
+  struct Session {
+    std::string username;
+    bool loggedIn = false;
+  };
+
+  /**
+   * @brief Cria o serviço sobre os arquivos de um diretório de dados.
+   * @param directory O diretório (padrão "data").
+   */
+  explicit Service(const std::string& directory = "data");
+
+  /**
+   * @brief Carrega o catálogo, o índice de títulos, os livros parecidos e o
+   * índice dos vetores antes da primeira requisição (usado pelo servidor).
+   */
+  void preload();
+
+  /**
+   * @brief Executa uma requisição.
+   * @param request A requisição.
+   * @param session A sessão de quem fez a requisição.
+   * @return A resposta (erros também são respostas, nunca exceções).
+   */
+  json handle(const json& request, Session& session);
+
+  /**
+   * @brief Monta uma resposta de erro.
+   */
+  static json error(const std::string& message);
+
+ private:
+  DataManager userDataManager;
+  DataManager booksDataManager;
+  DataManager historyDataManager;
+  DataManager ratingsDataManager;
+  SearchCache searchCache;
+
+  json userExists(const std::string& username);
+  json registerUser(const std::string& username, const std::string& password,
+                    Session& session);
+  json login(const std::string& username, const std::string& password,
+             Session& session);
+  json statistics();
+  json search(const std::string& query, std::size_t limit,
+              std::pmr::memory_resource* memory);
+  json info(const std::string& isbn, Session& session,
+            std::pmr::memory_resource* memory);
+  json history(Session& session);
+  json homePage(Session& session, std::pmr::memory_resource* memory);
+  json rate(const std::string& isbn, std::int64_t score, Session& session);
+  json similar(const std::string& isbn, std::size_t limit);
+};
+
+#endif  // SERVICE_H
@@ -19,6 +19,7 @@
 #include <iomanip>
 #include <iostream>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -86,8 +87,22 @@ bool User::load() {
  * @return true se a operação foi bem-sucedida, false caso contrário.
  */
 bool User::save() {
-  json userJson;
-  userJson[getUsername()] = {{"password", getPasswordHash()}};
+  json userJson = {{"password", getPasswordHash()}};
 
-  return dataManager.save(userJson);
+  return dataManager.put(getUsername(), userJson);
+}
+
+/**
+ * @brief Cadastra o usuário se o nome ainda estiver livre.
+ * @return true se o usuário foi cadastrado, false caso contrário.
+ */
+bool User::create() {
+  bool created = false;
+  bool ok = dataManager.update(
+      getUsername(), [&](const json* current) -> std::optional<json> {
+        created = current == nullptr;
+        if (!created) return std::nullopt;
+        return json{{"password", getPasswordHash()}};
+      });
+  return ok && created;
 }
@@ -48,6 +48,14 @@ public:
      */
     bool save();
 
+    /**
+     * @brief Cadastra o usuário apenas se ele ainda não existir. A verificação
+     * e a gravação são atômicas mesmo entre processos.
+     * @return true se o usuário foi cadastrado, false se já existia ou em
+     * caso de erro.
+     */
+    bool create();
+
     /**
      * @brief Carrega os dados do usuário do arquivo para este objeto.
      * @return true se o usuário foi encontrado e carregado, false caso contrário.
@@ -1,39 +1,293 @@
 #include "FormatAux.h"
 
+#include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
 using namespace std;
 
-FormatAux::FormatAux() {}
+namespace {
+
+// Letras de U+00C0 a U+024F (Latin-1, Latin Extended-A e B) em minúsculas e
+// sem acentos, 2 bytes por letra: "a " para À, "ae" para Æ. "* " mantém o
+// caractere como está (símbolos e letras sem equivalente em ASCII)
+const char LATIN_FOLD[] =
+    "a a a a a a aec "  // U+00C0 ÀÁÂÃÄÅÆÇ
+    "e e e e i i i i "  // U+00C8 ÈÉÊËÌÍÎÏ
+    "d n o o o o o * "  // U+00D0 ÐÑÒÓÔÕÖ·
+    "o u u u u y thss"  // U+00D8 ØÙÚÛÜÝÞß
+    "a a a a a a aec "  // U+00E0 àáâãäåæç
+    "e e e e i i i i "  // U+00E8 èéêëìíîï
+    "d n o o o o o * "  // U+00F0 ðñòóôõö·
+    "o u u u u y thy "  // U+00F8 øùúûüýþÿ
+    "a a a a a a c c "  // U+0100 ĀāĂăĄąĆć
+    "c c c c c c d d "  // U+0108 ĈĉĊċČčĎď
+    "d d e e e e e e "  // U+0110 ĐđĒēĔĕĖė
+    "e e e e g g g g "  // U+0118 ĘęĚěĜĝĞğ
+    "g g g g h h h h "  // U+0120 ĠġĢģĤĥĦħ
+    "i i i i i i i i "  // U+0128 ĨĩĪīĬĭĮį
+    "i i ijijj j k k "  // U+0130 İıĲĳĴĵĶķ
+    "k l l l l l l l "  // U+0138 ĸĹĺĻļĽľĿ
+    "l l l n n n n n "  // U+0140 ŀŁłŃńŅņŇ
+    "n n n n o o o o "  // U+0148 ňŉŊŋŌōŎŏ
+    "o o oeoer r r r "  // U+0150 ŐőŒœŔŕŖŗ
+    "r r s s s s s s "  // U+0158 ŘřŚśŜŝŞş
+    "s s t t t t t t "  // U+0160 ŠšŢţŤťŦŧ
+    "u u u u u u u u "  // U+0168 ŨũŪūŬŭŮů
+    "u u u u w w y y "  // U+0170 ŰűŲųŴŵŶŷ
+    "y z z z z z z s "  // U+0178 ŸŹźŻżŽžſ
+    "b b b b * * * c "  // U+0180 ƀƁƂƃƄƅƆƇ
+    "c d d d d * * * "  // U+0188 ƈƉƊƋƌƍƎƏ
+    "* f f g * * * i "  // U+0190 ƐƑƒƓƔƕƖƗ
+    "k k l * * n n * "  // U+0198 ƘƙƚƛƜƝƞƟ
+    "o o * * p p * * "  // U+01A0 ƠơƢƣƤƥƦƧ
+    "* * * t t t t u "  // U+01A8 ƨƩƪƫƬƭƮƯ
+    "u * v y y z z * "  // U+01B0 ưƱƲƳƴƵƶƷ
+    "* * * * * * * * "  // U+01B8 ƸƹƺƻƼƽƾƿ
+    "* * * * dzdzdzlj"  // U+01C0 ǀǁǂǃǄǅǆǇ
+    "ljljnjnjnja a i "  // U+01C8 ǈǉǊǋǌǍǎǏ
+    "i o o u u u u u "  // U+01D0 ǐǑǒǓǔǕǖǗ
+    "u u u u u * a a "  // U+01D8 ǘǙǚǛǜǝǞǟ
+    "a a aeaeg g g g "  // U+01E0 ǠǡǢǣǤǥǦǧ
+    "k k o o o o * * "  // U+01E8 ǨǩǪǫǬǭǮǯ
+    "j dzdzdzg g * * "  // U+01F0 ǰǱǲǳǴǵǶǷ
+    "n n a a aeaeo o "  // U+01F8 ǸǹǺǻǼǽǾǿ
+    "a a a a e e e e "  // U+0200 ȀȁȂȃȄȅȆȇ
+    "i i i i o o o o "  // U+0208 ȈȉȊȋȌȍȎȏ
+    "r r r r u u u u "  // U+0210 ȐȑȒȓȔȕȖȗ
+    "s s t t * * h h "  // U+0218 ȘșȚțȜȝȞȟ
+    "* d * * z z a a "  // U+0220 ȠȡȢȣȤȥȦȧ
+    "e e o o o o o o "  // U+0228 ȨȩȪȫȬȭȮȯ
+    "o o y y l n t j "  // U+0230 ȰȱȲȳȴȵȶȷ
+    "* * a c c l t s "  // U+0238 ȸȹȺȻȼȽȾȿ
+    "z * * b u * e e "  // U+0240 ɀɁɂɃɄɅɆɇ
+    "j j q q r r y y ";  // U+0248 ɈɉɊɋɌɍɎɏ
+
+// O mesmo para o Latin Extended Additional (U+1E00 a U+1EFF, ex: vietnamita)
+const char LATIN_ADDITIONAL_FOLD[] =
+    "a a b b b b b b "  // U+1E00 ḀḁḂḃḄḅḆḇ
+    "c c d d d d d d "  // U+1E08 ḈḉḊḋḌḍḎḏ
+    "d d d d e e e e "  // U+1E10 ḐḑḒḓḔḕḖḗ
+    "e e e e e e f f "  // U+1E18 ḘḙḚḛḜḝḞḟ
+    "g g h h h h h h "  // U+1E20 ḠḡḢḣḤḥḦḧ
+    "h h h h i i i i "  // U+1E28 ḨḩḪḫḬḭḮḯ
+    "k k k k k k l l "  // U+1E30 ḰḱḲḳḴḵḶḷ
+    "l l l l l l m m "  // U+1E38 ḸḹḺḻḼḽḾḿ
+    "m m m m n n n n "  // U+1E40 ṀṁṂṃṄṅṆṇ
+    "n n n n o o o o "  // U+1E48 ṈṉṊṋṌṍṎṏ
+    "o o o o p p p p "  // U+1E50 ṐṑṒṓṔṕṖṗ
+    "r r r r r r r r "  // U+1E58 ṘṙṚṛṜṝṞṟ
+    "s s s s s s s s "  // U+1E60 ṠṡṢṣṤṥṦṧ
+    "s s t t t t t t "  // U+1E68 ṨṩṪṫṬṭṮṯ
+    "t t u u u u u u "  // U+1E70 ṰṱṲṳṴṵṶṷ
+    "u u u u v v v v "  // U+1E78 ṸṹṺṻṼṽṾṿ
+    "w w w w w w w w "  // U+1E80 ẀẁẂẃẄẅẆẇ
+    "w w x x x x y y "  // U+1E88 ẈẉẊẋẌẍẎẏ
+    "z z z z z z h t "  // U+1E90 ẐẑẒẓẔẕẖẗ
+    "w y a s s s ss* "  // U+1E98 ẘẙẚẛẜẝẞẟ
+    "a a a a a a a a "  // U+1EA0 ẠạẢảẤấẦầ
+    "a a a a a a a a "  // U+1EA8 ẨẩẪẫẬậẮắ
+    "a a a a a a a a "  // U+1EB0 ẰằẲẳẴẵẶặ
+    "e e e e e e e e "  // U+1EB8 ẸẹẺẻẼẽẾế
+    "e e e e e e e e "  // U+1EC0 ỀềỂểỄễỆệ
+    "i i i i o o o o "  // U+1EC8 ỈỉỊịỌọỎỏ
+    "o o o o o o o o "  // U+1ED0 ỐốỒồỔổỖỗ
+    "o o o o o o o o "  // U+1ED8 ỘộỚớỜờỞở
+    "o o o o u u u u "  // U+1EE0 ỠỡỢợỤụỦủ
+    "u u u u u u u u "  // U+1EE8 ỨứỪừỬửỮữ
+    "u u y y y y y y "  // U+1EF0 ỰựỲỳỴỵỶỷ
+    "y y * * * * * * ";  // U+1EF8 ỸỹỺỻỼỽỾỿ
+
+/**
+ * @brief Minúscula sem tonos nem dialítica de um caractere grego
+ * (U+0370..U+03FF); ς vira σ, como no case folding do Unicode.
+ */
+char32_t foldGreek(char32_t cp) {
+  switch (cp) {
+    case 0x0386:
+    case 0x03AC:  // Ά, ά
+      return 0x03B1;
+    case 0x0388:
+    case 0x03AD:  // Έ, έ
+      return 0x03B5;
+    case 0x0389:
+    case 0x03AE:  // Ή, ή
+      return 0x03B7;
+    case 0x038A:
+    case 0x03AF:
+    case 0x0390:
+    case 0x03AA:
+    case 0x03CA:  // Ί, ί, ΐ, Ϊ, ϊ
+      return 0x03B9;
+    case 0x038C:
+    case 0x03CC:  // Ό, ό
+      return 0x03BF;
+    case 0x038E:
+    case 0x03CD:
+    case 0x03B0:
+    case 0x03AB:
+    case 0x03CB:  // Ύ, ύ, ΰ, Ϋ, ϋ
+      return 0x03C5;
+    case 0x038F:
+    case 0x03CE:  // Ώ, ώ
+      return 0x03C9;
+    case 0x03C2:  // ς
+      return 0x03C3;
+    default:
+      break;
+  }
+  if (cp >= 0x0391 && cp <= 0x03A9) return cp + 0x20;  // Α..Ω
+  return cp;
+}
+
+/**
+ * @brief Minúscula de um caractere cirílico (U+0400..U+04FF); ё vira е.
+ */
+char32_t foldCyrillic(char32_t cp) {
+  if (cp == 0x0401 || cp == 0x0451) return 0x0435;     // Ё, ё
+  if (cp >= 0x0410 && cp <= 0x042F) return cp + 0x20;  // А..Я
+  if (cp >= 0x0400 && cp <= 0x040F) return cp + 0x50;  // Ѐ..Џ
+  // Nos blocos seguintes maiúsculas e minúsculas se alternam
+  if ((cp >= 0x0460 && cp <= 0x0481) || (cp >= 0x048A && cp <= 0x04BF) ||
+      (cp >= 0x04D0 && cp <= 0x04FF)) {
+    return cp | 1;
+  }
+  if (cp >= 0x04C1 && cp <= 0x04CE) return (cp & 1) ? cp + 1 : cp;
+  if (cp == 0x04C0) return 0x04CF;  // Ӏ
+  return cp;
+}
+
+/**
+ * @brief Converte para minúsculas um trecho ASCII, parando no primeiro byte
+ * que não é ASCII. Com SSE2/AVX2 são 16/32 bytes por vez.
+ * @return A quantidade de bytes convertidos (gravados em out).
+ */
+std::size_t lowerAscii(const char* in, std::size_t size, char* out) {
+  std::size_t i = 0;
+  // 'A'..'Z' + (0x80 - 'A') cai em [-128, -103] (com sinal); os demais
+  // bytes ASCII ficam acima disso
+#if defined(__AVX2__)
+  const __m256i offset32 = _mm256_set1_epi8(static_cast<char>(0x80 - 'A'));
+  const __m256i bound32 = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+  const __m256i bit32 = _mm256_set1_epi8(0x20);
+  for (; i + 32 <= size; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+    if (_mm256_movemask_epi8(v) != 0) break;
+    __m256i upper = _mm256_cmpgt_epi8(bound32, _mm256_add_epi8(v, offset32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm256_or_si256(v, _mm256_and_si256(upper, bit32)));
+  }
+#endif
+#if defined(__SSE2__)
+  const __m128i offset = _mm_set1_epi8(static_cast<char>(0x80 - 'A'));
+  const __m128i bound = _mm_set1_epi8(static_cast<char>(-128 + 26));
+  const __m128i bit = _mm_set1_epi8(0x20);
+  for (; i + 16 <= size; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+    if (_mm_movemask_epi8(v) != 0) break;
+    __m128i upper = _mm_cmplt_epi8(_mm_add_epi8(v, offset), bound);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                     _mm_or_si128(v, _mm_and_si128(upper, bit)));
+  }
+#endif
+  for (; i < size; ++i) {
+    unsigned char c = in[i];
+    if (c >= 0x80) break;
+    out[i] = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+  }
+  return i;
+}
+
+bool isContinuation(unsigned char c) { return (c & 0xC0) == 0x80; }
+
+/**
+ * @brief Grava o resultado de uma célula das tabelas LATIN_*_FOLD, ou o
+ * caractere original (length bytes em source) se a célula for "* ".
+ */
+void writeCell(const char* cell, const char* source, std::size_t length,
+               char* out, std::size_t& w) {
+  if (cell[0] == '*') {
+    for (std::size_t k = 0; k < length; ++k) out[w++] = source[k];
+    return;
+  }
+  out[w++] = cell[0];
+  if (cell[1] != ' ') out[w++] = cell[1];
+}
 
-string FormatAux::toLower(const string& str) {
-  string lower_str;
-  lower_str.reserve(str.length());
-  for (size_t i = 0; i < str.length(); ++i) {
-    unsigned char c1 = str[i];
-    if (c1 >= 'A' && c1 <= 'Z') {
-      lower_str += c1 + ('a' - 'A');
-    } else if (c1 == 0xC3 &&
-               i + 1 < str.length()) {  // Caracteres acentuados maiúsculos em
-                                        // UTF-8 (2 bytes)
-      unsigned char c2 = str[i + 1];
-      if (c2 >= 0x80 && c2 <= 0x9C) {  // Á, À, Â, Ã, Ä, ... , Ü
-        lower_str += c1;
-        lower_str += c2 + 0x20;  // Converte para o correspondente minúsculo
-        i++;
+/**
+ * @brief Normaliza in[0, size) em out e retorna o tamanho do resultado.
+ * Cada caractere é gravado depois de lido e nunca ocupa mais bytes que o
+ * original, então out pode ser o próprio in.
+ */
+std::size_t foldUtf8(const char* in, std::size_t size, char* out) {
+  std::size_t r = 0, w = 0;
+  while (r < size) {
+    unsigned char c = in[r];
+    if (c < 0x80) {
+      std::size_t n = lowerAscii(in + r, size - r, out + w);
+      r += n;
+      w += n;
+      continue;
+    }
+
+    // Sequência de 2 bytes (U+0080..U+07FF)
+    if (c >= 0xC2 && c <= 0xDF && r + 1 < size &&
+        isContinuation(in[r + 1])) {
+      const char* source = in + r;
+      char32_t cp = (char32_t(c & 0x1F) << 6) | (in[r + 1] & 0x3F);
+      r += 2;
+      if (cp >= 0x00C0 && cp <= 0x024F) {
+        writeCell(LATIN_FOLD + 2 * (cp - 0x00C0), source, 2, out, w);
+        continue;
+      }
+      if (cp >= 0x0300 && cp <= 0x036F) continue;  // Acento combinante
+      if (cp == 0x00A0) {                            // Espaço não separável
+        out[w++] = ' ';
+        continue;
+      }
+      if (cp >= 0x0370 && cp <= 0x03FF) {
+        cp = foldGreek(cp);
+      } else if (cp >= 0x0400 && cp <= 0x04FF) {
+        cp = foldCyrillic(cp);
+      }
+      out[w++] = static_cast<char>(0xC0 | (cp >> 6));
+      out[w++] = static_cast<char>(0x80 | (cp & 0x3F));
+      continue;
+    }
+
+    // Sequência de 3 bytes: só o Latin Extended Additional é convertido
+    if (c == 0xE1 && r + 2 < size && isContinuation(in[r + 1]) &&
+        isContinuation(in[r + 2])) {
+      const char* source = in + r;
+      char32_t cp = (char32_t(c & 0x0F) << 12) |
+                    (char32_t(in[r + 1] & 0x3F) << 6) | (in[r + 2] & 0x3F);
+      r += 3;
+      if (cp >= 0x1E00 && cp <= 0x1EFF) {
+        writeCell(LATIN_ADDITIONAL_FOLD + 2 * (cp - 0x1E00), source, 3, out,
+                  w);
       } else {
-        lower_str += c1;
+        for (std::size_t k = 0; k < 3; ++k) out[w++] = source[k];
       }
-    } else {
-      lower_str += c1;
+      continue;
     }
+
+    // Qualquer outro byte (outras sequências ou UTF-8 inválido) é copiado
+    out[w++] = in[r++];
   }
-  return lower_str;
+  return w;
 }
 
+}  // namespace
+
+FormatAux::FormatAux() {}
+
 string FormatAux::join(const vector<string>& vec, const string& sep) {
   ostringstream oss;
   for (size_t i = 0; i < vec.size(); ++i) {
@@ -43,90 +297,16 @@ string FormatAux::join(const vector<string>& vec, const string& sep) {
   return oss.str();
 }
 
-string FormatAux::removeAccents(const string& str) {
-  string result;
-  result.reserve(str.length());
-  for (size_t i = 0; i < str.length(); ++i) {
-    unsigned char c1 = str[i];
-    if (c1 == 0xC3 &&
-        i + 1 < str.length()) {  // Início de um caractere de 2 bytes em UTF-8
-      unsigned char c2 = str[i + 1];
-      switch (c2) {
-        case 0xA0:
-        case 0xA1:
-        case 0xA2:
-        case 0xA3:
-        case 0xA4:
-        case 0xA5:  // à,á,â,ã,ä,å
-        case 0x80:
-        case 0x81:
-        case 0x82:
-        case 0x83:
-        case 0x84:
-        case 0x85:  // À,Á,Â,Ã,Ä,Å
-          result += 'a';
-          break;
-        case 0xA8:
-        case 0xA9:
-        case 0xAA:
-        case 0xAB:  // è,é,ê,ë
-        case 0x88:
-        case 0x89:
-        case 0x8A:
-        case 0x8B:  // È,É,Ê,Ë
-          result += 'e';
-          break;
-        case 0xAC:
-        case 0xAD:
-        case 0xAE:
-        case 0xAF:  // ì,í,î,ï
-        case 0x8C:
-        case 0x8D:
-        case 0x8E:
-        case 0x8F:  // Ì,Í,Î,Ï
-          result += 'i';
-          break;
-        case 0xB2:
-        case 0xB3:
-        case 0xB4:
-        case 0xB5:
-        case 0xB6:
-        case 0xB8:  // ò,ó,ô,õ,ö,ø
-        case 0x92:
-        case 0x93:
-        case 0x94:
-        case 0x95:
-        case 0x96:
-        case 0x98:  // Ò,Ó,Ô,Õ,Ö,Ø
-          result += 'o';
-          break;
-        case 0xB9:
-        case 0xBA:
-        case 0xBB:
-        case 0xBC:  // ù,ú,û,ü
-        case 0x99:
-        case 0x9A:
-        case 0x9B:
-        case 0x9C:  // Ù,Ú,Û,Ü
-          result += 'u';
-          break;
-        case 0xA7:
-        case 0x87:  // ç, Ç
-          result += 'c';
-          break;
-        case 0xB1:
-        case 0x91:  // ñ, Ñ
-          result += 'n';
-          break;
-        default:
-          result += c1;
-          result += c2;
-          break;
-      }
-      i++;  // Pula o segundo byte do caractere UTF-8
-    } else {
-      result += c1;
-    }
-  }
-  return result;
+void FormatAux::normalizeInto(string_view in, string& out) {
+  out.resize(in.size());
+  out.resize(foldUtf8(in.data(), in.size(), out.data()));
+}
+
+void FormatAux::normalizeInto(string_view in, pmr::string& out) {
+  out.resize(in.size());
+  out.resize(foldUtf8(in.data(), in.size(), out.data()));
+}
+
+void FormatAux::normalizeInPlace(string& str) {
+  str.resize(foldUtf8(str.data(), str.size(), str.data()));
 }
@@ -1,7 +1,9 @@
 #ifndef FORMAT_AUX_H
 #define FORMAT_AUX_H
 
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using namespace std;
@@ -10,22 +12,35 @@ class FormatAux {
  private:
  public:
   FormatAux();
+  string join(const vector<string>& vec, const string& sep = ", ");
+
   /**
-   * @brief Remove acentos de uma string, tratando caracteres UTF-8 (pt-br).
-   * @param str A string de entrada (idealmente já em minúsculas).
-   * @return A string sem acentos.
+   * @brief Normaliza um texto para comparação em uma única passada:
+   * minúsculas e sem acentos, sem strings intermediárias.
+   *
+   * Cobre o ASCII, o Latin-1, o Latin Extended-A/B e o Latin Extended
+   * Additional (ex: "Łódź" -> "lodz", "Ő" -> "o", "Æ" -> "ae", "ß" -> "ss"),
+   * além de passar o grego e o cirílico para minúsculas. Marcas de acento
+   * combinantes (U+0300..U+036F) são descartadas e o espaço não separável
+   * vira espaço. O resto é copiado como está. O resultado nunca é maior que
+   * a entrada.
+   * @param in O texto em UTF-8.
+   * @param out A saída; o conteúdo anterior é descartado (não pode ser a
+   * mesma memória de in; para isso use normalizeInPlace()).
    */
-  string removeAccents(const string& str);
+  void normalizeInto(string_view in, string& out);
 
-  string join(const vector<string>& vec, const string& sep = ", ");
+  /**
+   * @brief Versão de normalizeInto() para strings em um memory_resource (ex:
+   * a arena da requisição).
+   */
+  void normalizeInto(string_view in, pmr::string& out);
 
   /**
-   * @brief Converte uma string para minúsculas, tratando caracteres UTF-8
-   * (pt-br).
-   * @param str A string de entrada.
-   * @return A string convertida para minúsculas.
+   * @brief Normaliza um texto no próprio buffer, como normalizeInto().
+   * @param str O texto, substituído pela versão normalizada.
    */
-  string toLower(const string& str);
+  void normalizeInPlace(string& str);
 };
 
 #endif
@@ -0,0 +1,131 @@
+/**
+ * @file: RequestArena.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação da arena de memória das requisições.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "RequestArena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <memory>
+
+namespace {
+
+// Tamanho inicial do buffer de cada thread
+const std::size_t INITIAL_BUFFER_SIZE = 64 * 1024;
+// Limite de crescimento do buffer; requisições maiores que isso sempre usam
+// o heap global para o excedente
+const std::size_t MAX_BUFFER_SIZE = 32 * 1024 * 1024;
+
+/**
+ * @brief Buffer reaproveitado pelas arenas de uma thread.
+ */
+struct ThreadBuffer {
+  std::unique_ptr<unsigned char[]> data;
+  std::size_t size = 0;
+  bool inUse = false;
+};
+
+thread_local ThreadBuffer threadBuffer;
+
+std::atomic<std::uint64_t> totalRequests{0};
+std::atomic<std::uint64_t> totalAllocations{0};
+std::atomic<std::uint64_t> totalBytes{0};
+std::atomic<std::uint64_t> totalUpstreamAllocations{0};
+std::atomic<std::uint64_t> totalUpstreamBytes{0};
+std::atomic<std::uint64_t> totalBufferBytes{0};
+
+/**
+ * @brief Troca o buffer da thread por um de outro tamanho.
+ */
+void resizeBuffer(ThreadBuffer& buffer, std::size_t size) {
+  totalBufferBytes -= buffer.size;
+  buffer.data.reset();
+  buffer.data = std::make_unique<unsigned char[]>(size);
+  buffer.size = size;
+  totalBufferBytes += size;
+}
+
+}  // namespace
+
+void* RequestArena::Upstream::do_allocate(std::size_t bytes,
+                                          std::size_t alignment) {
+  ++allocations;
+  this->bytes += bytes;
+  return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void RequestArena::Upstream::do_deallocate(void* pointer, std::size_t bytes,
+                                           std::size_t alignment) {
+  std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+}
+
+bool RequestArena::Upstream::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+RequestArena::RequestArena() {
+  if (threadBuffer.inUse) {
+    monotonic.emplace(&upstream);
+    return;
+  }
+  if (!threadBuffer.data) resizeBuffer(threadBuffer, INITIAL_BUFFER_SIZE);
+  threadBuffer.inUse = true;
+  ownsBuffer = true;
+  monotonic.emplace(threadBuffer.data.get(), threadBuffer.size, &upstream);
+}
+
+/**
+ * @brief Libera tudo de uma vez e, se o buffer da thread não bastou, faz ele
+ * crescer para a próxima requisição.
+ */
+RequestArena::~RequestArena() {
+  totalRequests += 1;
+  totalAllocations += allocationCount;
+  totalBytes += allocatedBytes;
+  totalUpstreamAllocations += upstream.allocations;
+  totalUpstreamBytes += upstream.bytes;
+
+  monotonic.reset();  // Devolve ao heap os blocos excedentes
+  if (!ownsBuffer) return;
+  if (upstream.bytes > 0 && threadBuffer.size < MAX_BUFFER_SIZE) {
+    resizeBuffer(threadBuffer,
+                 std::min(MAX_BUFFER_SIZE,
+                          std::bit_ceil(threadBuffer.size + upstream.bytes)));
+  }
+  threadBuffer.inUse = false;
+}
+
+void* RequestArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  ++allocationCount;
+  allocatedBytes += bytes;
+  return monotonic->allocate(bytes, alignment);
+}
+
+void RequestArena::do_deallocate(void*, std::size_t, std::size_t) {
+  // Nada a fazer: a memória só volta quando a arena é destruída
+}
+
+bool RequestArena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+RequestArena::Stats RequestArena::stats() {
+  Stats stats;
+  stats.requests = totalRequests;
+  stats.allocations = totalAllocations;
+  stats.bytes = totalBytes;
+  stats.upstreamAllocations = totalUpstreamAllocations;
+  stats.upstreamBytes = totalUpstreamBytes;
+  stats.bufferBytes = totalBufferBytes;
+  return stats;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file: RequestArena.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição da arena de memória usada pelas alocações
+ * temporárias de uma requisição.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * @class RequestArena
+ * @brief Arena monotônica (std::pmr) que vive enquanto uma requisição é
+ * executada: as estruturas temporárias (consulta normalizada, candidatos,
+ * heaps, listas) são alocadas em sequência em um buffer da thread e liberadas
+ * todas de uma vez quando a arena é destruída.
+ *
+ * O buffer é reaproveitado entre as requisições da mesma thread. Se uma
+ * requisição não couber nele, o excedente vem do heap global (e conta em
+ * Stats::upstreamAllocations) e o buffer cresce para a próxima; depois que o
+ * buffer de cada thread alcança o tamanho das maiores requisições, o que
+ * passa pela arena deixa de pedir memória ao heap global. O resto da
+ * requisição continua usando o heap global normalmente (o json da resposta,
+ * os livros lidos do DataManager, as strings de cada campo), e isso não
+ * aparece nos contadores.
+ * @note Não é thread-safe: a arena só deve ser usada pela thread que a criou.
+ * Uma arena criada enquanto outra da mesma thread está ativa não usa o buffer
+ * (tudo vem do heap global).
+ */
+class RequestArena : public std::pmr::memory_resource {
+ public:
+  /**
+   * @brief Contadores acumulados de todas as arenas do processo.
+   */
+  struct Stats {
+    std::uint64_t requests = 0;             // Arenas já destruídas
+    std::uint64_t allocations = 0;          // Alocações feitas nas arenas
+    std::uint64_t bytes = 0;                // Bytes pedidos às arenas
+    std::uint64_t upstreamAllocations = 0;  // Blocos pedidos ao heap global
+    std::uint64_t upstreamBytes = 0;
+    std::uint64_t bufferBytes = 0;  // Soma dos buffers das threads
+  };
+
+  RequestArena();
+  ~RequestArena() override;
+  RequestArena(const RequestArena&) = delete;
+  RequestArena& operator=(const RequestArena&) = delete;
+
+  /**
+   * @brief Quantidade de alocações feitas nesta arena até agora.
+   */
+  std::size_t allocations() const { return allocationCount; }
+
+  /**
+   * @brief Blocos pedidos ao heap global por esta arena até agora (0 quando
+   * tudo coube no buffer da thread).
+   */
+  std::size_t upstreamAllocations() const { return upstream.allocations; }
+
+  /**
+   * @brief Contadores de todas as arenas.
+   */
+  static Stats stats();
+
+ private:
+  /**
+   * @brief Repassa ao heap global os blocos que não cabem no buffer,
+   * contando-os.
+   */
+  class Upstream : public std::pmr::memory_resource {
+   public:
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+
+   private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void* pointer, std::size_t bytes,
+                       std::size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override;
+  };
+
+  Upstream upstream;
+  std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+  bool ownsBuffer = false;  // Usa (e devolve no fim) o buffer da thread
+  std::size_t allocationCount = 0;
+  std::size_t allocatedBytes = 0;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* pointer, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override;
+};
+
+#endif  // REQUEST_ARENA_H
@@ -0,0 +1,151 @@
+/**
+ * @file: ThreadPool.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Implementação do pool de threads.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Pool a que pertence a thread atual (nullptr fora das threads auxiliares)
+thread_local const ThreadPool* currentPool = nullptr;
+
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t threads) {
+  // A thread que chama parallelFor também trabalha
+  for (std::size_t i = 1; i < threads; ++i) {
+    workers.emplace_back([this] { work(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  available.notify_all();
+  // std::jthread faz join automaticamente
+}
+
+std::size_t ThreadPool::size() const { return workers.size() + 1; }
+
+void ThreadPool::enqueue(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(std::move(job));
+  }
+  available.notify_one();
+}
+
+void ThreadPool::work() {
+  currentPool = this;
+  while (true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      available.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (stopping && queue.empty()) return;
+      job = std::move(queue.front());
+      queue.pop_front();
+    }
+    job();
+  }
+}
+
+/**
+ * @brief Executa as tarefas em paralelo. Cada thread pega o próximo índice de
+ * um contador atômico até acabarem as tarefas.
+ */
+void ThreadPool::parallelFor(std::size_t tasks,
+                             const std::function<void(std::size_t)>& body) {
+  if (tasks == 0) return;
+  if (tasks == 1 || workers.empty() || currentPool == this) {
+    for (std::size_t i = 0; i < tasks; ++i) body(i);
+    return;
+  }
+
+  struct State {
+    std::atomic<std::size_t> next{0};
+    std::size_t pendingHelpers = 0;
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<State>();
+
+  auto run = [state, tasks, &body] {
+    std::size_t i;
+    while ((i = state->next.fetch_add(1)) < tasks) {
+      try {
+        body(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->error) state->error = std::current_exception();
+        state->next = tasks;  // Interrompe as demais tarefas
+      }
+    }
+  };
+
+  std::size_t helpers = std::min(workers.size(), tasks - 1);
+  state->pendingHelpers = helpers;
+  for (std::size_t h = 0; h < helpers; ++h) {
+    enqueue([state, run] {
+      run();
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (--state->pendingHelpers == 0) state->finished.notify_one();
+    });
+  }
+  run();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->finished.wait(lock, [&state] { return state->pendingHelpers == 0; });
+  if (state->error) std::rethrow_exception(state->error);
+}
+
+void ThreadPool::submit(std::function<void()> job) {
+  if (workers.empty()) {
+    job();
+    return;
+  }
+  enqueue(std::move(job));
+}
+
+std::size_t ThreadPool::configuredThreads() {
+  if (const char* env = std::getenv("BOOKMATCH_THREADS")) {
+    try {
+      long threads = std::stol(env);
+      if (threads > 0) return static_cast<std::size_t>(threads);
+    } catch (const std::exception&) {
+      // Valor inválido: usa o padrão
+    }
+  }
+  unsigned int cores = std::thread::hardware_concurrency();
+  return cores == 0 ? 1 : cores;
+}
+
+ThreadPool& ThreadPool::shared() {
+  static ThreadPool pool(configuredThreads());
+  return pool;
+}
+
+ThreadPool& ThreadPool::background() {
+  // shared() é criado antes e, portanto, destruído depois deste pool, que
+  // ainda pode estar usando-o ao terminar as tarefas pendentes
+  shared();
+  static ThreadPool pool(2);
+  return pool;
+}
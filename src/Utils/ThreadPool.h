@@ -0,0 +1,94 @@
+/**
+ * @file: ThreadPool.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Definição de um pool de threads simples para laços paralelos.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Pool de threads fixo. O uso principal é parallelFor(), em que as
+ * threads (incluindo a que chamou) pegam as tarefas dinamicamente de um
+ * contador compartilhado, de forma que nenhuma fica ociosa enquanto houver
+ * trabalho.
+ */
+class ThreadPool {
+ private:
+  std::mutex mutex;
+  std::condition_variable available;
+  std::deque<std::function<void()>> queue;
+  bool stopping = false;
+  std::vector<std::jthread> workers;
+
+  void enqueue(std::function<void()> job);
+  void work();
+
+ public:
+  /**
+   * @brief Cria o pool.
+   * @param threads Total de threads que executam um parallelFor, contando a
+   * thread que chama (1 = tudo roda na thread atual).
+   */
+  explicit ThreadPool(std::size_t threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * @brief Quantidade de threads que executam um parallelFor.
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Executa body(0) ... body(tasks - 1) em paralelo e espera todas
+   * terminarem. Uma exceção lançada por body é relançada aqui. Chamado de uma
+   * thread do próprio pool, executa tudo na thread atual (esperar as outras
+   * threads poderia nunca terminar, se todas estivessem ocupadas esperando).
+   * @param tasks A quantidade de tarefas.
+   * @param body A função executada para cada tarefa.
+   */
+  void parallelFor(std::size_t tasks,
+                   const std::function<void(std::size_t)>& body);
+
+  /**
+   * @brief Executa uma tarefa em segundo plano, sem esperar o resultado. Sem
+   * threads auxiliares (size() == 1), a tarefa roda na thread atual.
+   * @param job A tarefa (não deve lançar exceções).
+   */
+  void submit(std::function<void()> job);
+
+  /**
+   * @brief Quantidade de threads configurada: a variável de ambiente
+   * BOOKMATCH_THREADS, ou o número de núcleos da máquina.
+   */
+  static std::size_t configuredThreads();
+
+  /**
+   * @brief Pool compartilhado pela aplicação, criado com configuredThreads().
+   */
+  static ThreadPool& shared();
+
+  /**
+   * @brief Pool com uma única thread auxiliar, para tarefas longas em segundo
+   * plano (ex: reconstruir um índice). As tarefas rodam uma de cada vez e
+   * podem usar shared().parallelFor sem ocupar as threads de shared().
+   */
+  static ThreadPool& background();
+};
+
+#endif  // THREAD_POOL_H
@@ -0,0 +1,97 @@
+/**
+ * @file: TopK.h
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Seleção dos k melhores elementos com memória O(k).
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @class TopK
+ * @brief Mantém apenas os k melhores elementos vistos, segundo um comparador
+ * "ranksBefore(a, b)" (true se a deve aparecer antes de b no resultado).
+ *
+ * Internamente é um heap de capacidade fixa cujo topo é o pior elemento
+ * guardado; cada push custa O(log k) e a memória fica em O(k).
+ * O alocador permite guardar o heap em uma arena (ex: std::pmr com a
+ * RequestArena da requisição).
+ * @note Para o resultado não depender da ordem de inserção (ex: em buscas
+ * paralelas), o comparador deve ser uma ordem total (com desempate).
+ */
+template <typename T, typename RanksBefore,
+          typename Allocator = std::allocator<T>>
+class TopK {
+ private:
+  std::size_t capacity;
+  RanksBefore ranksBefore;
+  std::vector<T, Allocator> heap;
+
+ public:
+  explicit TopK(std::size_t capacity, RanksBefore ranksBefore = RanksBefore(),
+                const Allocator& allocator = Allocator())
+      : capacity(capacity),
+        ranksBefore(std::move(ranksBefore)),
+        heap(allocator) {
+    heap.reserve(capacity);
+  }
+
+  /**
+   * @brief Oferece um elemento; ele só é guardado se estiver entre os k
+   * melhores até agora.
+   */
+  void push(T value) {
+    if (capacity == 0) return;
+    if (heap.size() < capacity) {
+      heap.push_back(std::move(value));
+      std::push_heap(heap.begin(), heap.end(), ranksBefore);
+    } else if (ranksBefore(value, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), ranksBefore);
+      heap.back() = std::move(value);
+      std::push_heap(heap.begin(), heap.end(), ranksBefore);
+    }
+  }
+
+  /**
+   * @brief Informa se um elemento seria guardado por push(), sem construí-lo
+   * (útil quando o elemento final é caro de criar, ex: copiar uma string).
+   */
+  template <typename U>
+  bool accepts(const U& value) const {
+    if (capacity == 0) return false;
+    return heap.size() < capacity || ranksBefore(value, heap.front());
+  }
+
+  /**
+   * @brief Incorpora os elementos de outro TopK (ex: de outra thread).
+   */
+  void merge(TopK&& other) {
+    for (T& value : other.heap) push(std::move(value));
+    other.heap.clear();
+  }
+
+  std::size_t size() const { return heap.size(); }
+  bool empty() const { return heap.empty(); }
+
+  /**
+   * @brief Retorna os elementos guardados, do melhor para o pior, esvaziando
+   * o TopK.
+   */
+  std::vector<T, Allocator> take() {
+    std::sort_heap(heap.begin(), heap.end(), ranksBefore);
+    return std::move(heap);
+  }
+};
+
+#endif  // TOP_K_H
@@ -0,0 +1,154 @@
+/**
+ * @file: ContentSimilarityTest.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Testes da atualização incremental dos livros parecidos
+ * quando livros saem do catálogo.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include <unistd.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "Catalog/BinaryCatalog.h"
+#include "DataManager/DataManager.h"
+#include "Recommendations/ContentSimilarity.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                              \
+  do {                                                                \
+    if (!(condition)) {                                               \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": falhou: "        \
+                << #condition << std::endl;                           \
+      ++failures;                                                     \
+    }                                                                 \
+  } while (false)
+
+/**
+ * @brief Diretório vazio para um teste.
+ */
+std::string freshDirectory(const std::string& name) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() /
+      ("bookmatch-test-" + std::to_string(getpid()) + "-" + name);
+  std::filesystem::remove_all(path);
+  std::filesystem::create_directories(path);
+  return path.string();
+}
+
+/**
+ * @brief ISBN de teste: o prefixo seguido de i com três dígitos.
+ */
+std::string numbered(const std::string& prefix, std::size_t i) {
+  std::string digits = std::to_string(i);
+  return prefix + std::string(3 - digits.size(), '0') + digits;
+}
+
+/**
+ * @brief Posição de um ISBN entre os vizinhos de outro no modelo.
+ */
+std::optional<std::size_t> neighborPosition(
+    const ContentSimilarity::Model& model, const std::string& isbn,
+    const std::string& neighbor) {
+  const BinaryCatalog& books = model.getCatalog();
+  std::optional<std::size_t> row = books.find(isbn);
+  if (!row) return std::nullopt;
+  std::size_t position = 0;
+  for (const ContentSimilarity::Neighbor& entry : model.neighbors(*row)) {
+    if (books.field(BinaryCatalog::ISBN, entry.row) == neighbor) {
+      return position;
+    }
+    ++position;
+  }
+  return std::nullopt;
+}
+
+/**
+ * @brief Texto com uma palavra repetida.
+ */
+std::string repeated(const std::string& word, std::size_t times) {
+  std::string text;
+  for (std::size_t i = 0; i < times; ++i) text += word + " ";
+  return text;
+}
+
+/**
+ * @brief Um livro que sai do catálogo abre uma vaga nas listas invertidas
+ * (truncadas em MAX_POSTING) dos seus termos, e o próximo livro de cada uma
+ * passa a ser pontuado por quem as sonda, mesmo que o livro que saiu não
+ * estivesse entre os vizinhos de ninguém.
+ *
+ * A lista de "alpha" está cheia com MAX_POSTING livros só com esse termo
+ * (peso 1). "z" e "y" têm "alpha" e "charlie"; "y" fica de fora da lista de
+ * "alpha" e só é achado por "z" pela de "charlie", com uma pontuação parcial
+ * menor que a de todos os livros de "alpha", e não chega ao cosseno exato.
+ * Sem um livro de "alpha", "y" entra na lista e passa a ser um vizinho de
+ * "z" (cosseno ~0.96, contra ~0.71 dos livros de "alpha").
+ */
+void removalOpensPosting() {
+  std::string directory = freshDirectory("removal");
+  DataManager catalog("books.json", directory);
+  json books = json::object();
+  auto add = [&books](const std::string& isbn, const std::string& text) {
+    books[isbn] = {{"title", isbn}, {"description", text}};
+  };
+  for (std::size_t i = 0; i < ContentSimilarity::MAX_POSTING; ++i) {
+    add(numbered("a", i), "alpha");
+  }
+  add("y", repeated("alpha", 100) + "charlie");
+  add("z", repeated("alpha", 8) + "charlie");
+  add("c0", "charlie");
+  add("c1", "charlie");
+  // Livros sem relação com os outros, para dar peso (IDF) a "alpha"
+  for (std::size_t i = 0; i < 1740; ++i) {
+    add(numbered("d", i % 1000) + std::to_string(i / 1000),
+        i % 2 ? "delta" : "echo");
+  }
+  CHECK(catalog.save(books));
+
+  auto similarity = std::make_shared<ContentSimilarity>(catalog);
+  std::shared_ptr<const ContentSimilarity::Model> before = similarity->model();
+  CHECK(!neighborPosition(*before, "z", "y"));
+
+  // Um livro de "alpha" que não está entre os vizinhos de "z"
+  std::string removed;
+  for (std::size_t i = 0; i < ContentSimilarity::MAX_POSTING; ++i) {
+    if (!neighborPosition(*before, "z", numbered("a", i))) {
+      removed = numbered("a", i);
+      break;
+    }
+  }
+  CHECK(!removed.empty());
+  CHECK(catalog.erase(removed));
+
+  // Enquanto a atualização não termina, o modelo anterior é servido
+  CHECK(similarity->model() == before);
+  similarity->refresh();
+  std::shared_ptr<const ContentSimilarity::Model> after = similarity->model();
+  CHECK(after != before);
+  CHECK(after->getCatalog().size() + 1 == before->getCatalog().size());
+  CHECK(similarity->stats().refreshes == 1);
+  CHECK(neighborPosition(*after, "z", "y") == std::optional<std::size_t>(0));
+
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace
+
+int main() {
+  removalOpensPosting();
+  if (failures == 0) std::cout << "OK" << std::endl;
+  return failures == 0 ? 0 : 1;
+}
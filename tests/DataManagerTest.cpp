@@ -0,0 +1,239 @@
+/**
+ * @file: DataManagerTest.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Testes do DataManager em caso de queda do processo e de
+ * escritas concorrentes de vários processos.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "DataManager/DataManager.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                              \
+  do {                                                                \
+    if (!(condition)) {                                               \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": falhou: "        \
+                << #condition << std::endl;                           \
+      ++failures;                                                     \
+    }                                                                 \
+  } while (false)
+
+/**
+ * @brief Diretório vazio para um teste.
+ */
+std::string freshDirectory(const std::string& name) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() /
+      ("bookmatch-test-" + std::to_string(getpid()) + "-" + name);
+  std::filesystem::remove_all(path);
+  std::filesystem::create_directories(path);
+  return path.string();
+}
+
+/**
+ * @brief Executa body em um processo filho e espera ele terminar.
+ * @return O status devolvido por waitpid.
+ */
+template <typename Body>
+int inChild(Body body) {
+  pid_t pid = fork();
+  if (pid == 0) {
+    body();
+    std::exit(0);  // Fim normal: os destrutores gravam o que está pendente
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return status;
+}
+
+/**
+ * @brief Acrescenta um item à lista de uma chave, como History::add.
+ */
+DataManager::Modifier append(const std::string& item) {
+  return [item](const json* current) -> std::optional<json> {
+    json list = current && current->is_array() ? *current : json::array();
+    list.push_back(item);
+    return list;
+  };
+}
+
+/**
+ * @brief Um processo morto (SIGKILL) antes da gravação em segundo plano: o
+ * que foi gravado com put sobrevive, o que estava só na memória se perde, e
+ * os arquivos continuam legíveis.
+ */
+void killedBeforeFlush() {
+  const std::string directory = freshDirectory("kill");
+  int status = inChild([&] {
+    DataManager data("data.json", directory);
+    data.put("sync", 1);
+    data.updateAsync("async", append("a"));
+    data.updateAsync("sync", append("b"));
+    raise(SIGKILL);
+  });
+  CHECK(WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+  json all = DataManager::read("data.json", directory);
+  CHECK(all.is_object());
+  CHECK(all.value("sync", json()) == json(1));
+  CHECK(!all.contains("async"));
+
+  // Uma escrita nova depois da queda continua funcionando
+  DataManager data("data.json", directory);
+  CHECK(data.put("after", true));
+  CHECK(DataManager::read("data.json", directory).value("after", false));
+  std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief Um processo que termina normalmente grava o que estava pendente.
+ */
+void flushedOnExit() {
+  const std::string directory = freshDirectory("exit");
+  inChild([&] {
+    DataManager data("data.json", directory);
+    data.updateAsync("list", append("a"));
+  });
+  json all = DataManager::read("data.json", directory);
+  CHECK(all.value("list", json()) == json::array({"a"}));
+  std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief Dois processos acrescentando à mesma chave em segundo plano: nenhum
+ * item se perde, porque as modificações são refeitas sobre o que o outro
+ * processo gravou.
+ */
+void concurrentAppends() {
+  const std::string directory = freshDirectory("append");
+  const int items = 50;
+  pid_t children[2];
+  for (int child = 0; child < 2; ++child) {
+    children[child] = fork();
+    if (children[child] == 0) {
+      DataManager data("data.json", directory);
+      for (int i = 0; i < items; ++i) {
+        data.updateAsync("list", append(std::to_string(child) + "-" +
+                                        std::to_string(i)));
+        if (i % 3 == child) data.flush();
+      }
+      std::exit(0);
+    }
+  }
+  for (pid_t child : children) waitpid(child, nullptr, 0);
+
+  json list = DataManager::read("data.json", directory).value("list", json());
+  CHECK(list.is_array() && list.size() == 2 * items);
+  std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief Uma queda no meio de uma escrita deixa uma linha incompleta no fim
+ * do journal: ela é ignorada na leitura e cortada antes da próxima escrita,
+ * de forma que os registros seguintes não se perdem.
+ */
+void tornJournalTail() {
+  const std::string directory = freshDirectory("torn");
+  {
+    std::ofstream journal(directory + "/data.json.log", std::ios::binary);
+    journal << R"({"key":"a","op":"put","value":1})" << '\n'
+            << R"({"key":"b","op":"put","val)";
+  }
+  json all = DataManager::read("data.json", directory);
+  CHECK(all.value("a", json()) == json(1));
+  CHECK(!all.contains("b"));
+
+  inChild([&] {
+    DataManager data("data.json", directory);
+    data.put("c", 3);
+    data.updateAsync("d", append("x"));
+  });
+  all = DataManager::read("data.json", directory);
+  CHECK(all.value("a", json()) == json(1));
+  CHECK(all.value("c", json()) == json(3));
+  CHECK(all.value("d", json()) == json::array({"x"}));
+  std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief Uma linha ilegível no meio do journal (ex: emendada por uma versão
+ * antiga) ou com uma chave que não é texto não descarta os registros que vêm
+ * depois dela.
+ */
+void corruptJournalLine() {
+  const std::string directory = freshDirectory("corrupt");
+  {
+    std::ofstream journal(directory + "/data.json.log", std::ios::binary);
+    journal << R"({"key":"a","op":"put","value":1})" << '\n'
+            << R"({"key":"b","op":"pu{"key":"c","op":"put","value":3})"
+            << '\n'
+            << R"({"key":"d","op":"put","value":4})" << '\n'
+            << R"({"key":5,"op":"put","value":5})" << '\n'
+            << R"({"key":"e","op":"put","value":6})" << '\n';
+  }
+  json all = DataManager::read("data.json", directory);
+  CHECK(all.value("a", json()) == json(1));
+  CHECK(all.value("d", json()) == json(4));
+  CHECK(all.value("e", json()) == json(6));
+
+  // A leitura em streaming (catálogo binário) vê os mesmos registros
+  DataManager data("data.json", directory);
+  auto changes = data.readStreaming([](std::istream&) {});
+  CHECK(changes.size() == 3 && changes.count("e") == 1);
+  std::filesystem::remove_all(directory);
+}
+
+/**
+ * @brief Os caches dos arquivos que nenhuma instância usa mais são
+ * descartados depois de MAX_CACHED_FILES (cada um guarda o json e a trava
+ * aberta), e um cache recriado não repete a geração do descartado.
+ */
+void evictedCaches() {
+  const std::string directory = freshDirectory("evicted");
+  std::uint64_t generation = 0;
+  {
+    DataManager first("first.json", directory);
+    CHECK(first.put("key", 1));
+    generation = first.generation();
+  }
+  for (std::size_t i = 0; i < 2 * DataManager::MAX_CACHED_FILES; ++i) {
+    DataManager other("other" + std::to_string(i) + ".json", directory);
+    other.load("key");
+  }
+  DataManager first("first.json", directory);
+  CHECK(first.generation() > generation);
+  CHECK(first.load("key") == json(1));
+  std::filesystem::remove_all(directory);
+}
+
+}  // namespace
+
+int main() {
+  killedBeforeFlush();
+  tornJournalTail();
+  corruptJournalLine();
+  flushedOnExit();
+  concurrentAppends();
+  evictedCaches();
+  if (failures == 0) std::cout << "OK" << std::endl;
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
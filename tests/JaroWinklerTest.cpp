@@ -0,0 +1,256 @@
+/**
+ * @file: JaroWinklerTest.cpp
+ * @author: Rodrigo Andrade
+ * @date: 17 Oct 2026
+ * @description: Testes do kernel de Jaro-Winkler contra a implementação
+ * original da busca.
+ * @version: 1.0
+ * @license: MIT
+ * @language: C++
+ * @github: https://github.com/RodrigoCAndrade/BookMatch
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Search/JaroWinkler.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition)                                              \
+  do {                                                                \
+    if (!(condition)) {                                               \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": falhou: "        \
+                << #condition << std::endl;                           \
+      ++failures;                                                     \
+    }                                                                 \
+  } while (false)
+
+/**
+ * @brief Cópia da jaroWinkler() original do Main.cpp, inclusive o
+ * "max / 2 - 1" que dá a volta para strings de 1 byte. O kernel tem que dar
+ * exatamente o mesmo double.
+ */
+double baseline(const std::string& s1, const std::string& s2) {
+  const size_t len1 = s1.size();
+  const size_t len2 = s2.size();
+  if (len1 == 0 && len2 == 0) return 1.0;
+  if (len1 == 0 || len2 == 0) return 0.0;
+  const size_t match_distance = std::max(len1, len2) / 2 - 1;
+  std::vector<bool> s1_matches(len1, false);
+  std::vector<bool> s2_matches(len2, false);
+  int matches = 0;
+  for (size_t i = 0; i < len1; ++i) {
+    size_t start = (i >= match_distance) ? i - match_distance : 0;
+    size_t end = std::min(i + match_distance + 1, len2);
+    for (size_t j = start; j < end; ++j) {
+      if (s2_matches[j]) continue;
+      if (s1[i] != s2[j]) continue;
+      s1_matches[i] = true;
+      s2_matches[j] = true;
+      ++matches;
+      break;
+    }
+  }
+  if (matches == 0) return 0.0;
+  double t = 0.0;
+  int k = 0;
+  for (size_t i = 0; i < len1; ++i) {
+    if (!s1_matches[i]) continue;
+    while (!s2_matches[k]) ++k;
+    if (s1[i] != s2[k]) t += 0.5;
+    ++k;
+  }
+  double m = matches;
+  double jaro = (m / len1 + m / len2 + (m - t) / m) / 3.0;
+  // Winkler boost
+  int prefix = 0;
+  for (size_t i = 0; i < std::min({len1, len2, size_t(4)}); ++i) {
+    if (s1[i] == s2[i])
+      ++prefix;
+    else
+      break;
+  }
+  return jaro + 0.1 * prefix * (1.0 - jaro);
+}
+
+/**
+ * @brief Compara o kernel com a implementação original nas duas ordens e
+ * confere que upperBound() nunca fica abaixo do valor exato.
+ */
+void checkPair(const std::string& s1, const std::string& s2) {
+  for (int order = 0; order < 2; ++order) {
+    const std::string& a = order == 0 ? s1 : s2;
+    const std::string& b = order == 0 ? s2 : s1;
+    const double exact = JaroWinkler::similarity(a, b);
+    if (exact != baseline(a, b)) {
+      std::cerr << "diferente para tamanhos " << a.size() << " e " << b.size()
+                << ": " << exact << " != " << baseline(a, b) << std::endl;
+      ++failures;
+    }
+    CHECK(JaroWinkler::upperBound(a, b) >= exact);
+  }
+}
+
+/**
+ * @brief String aleatória de um alfabeto pequeno (para haver casamentos e
+ * transposições).
+ */
+std::string randomText(std::mt19937& random, std::size_t size,
+                       std::string_view alphabet) {
+  std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+  std::string text(size, ' ');
+  for (char& c : text) c = alphabet[pick(random)];
+  return text;
+}
+
+/**
+ * @brief Cópia de uma string com alguns bytes trocados, removidos ou
+ * inseridos.
+ */
+std::string mutated(std::mt19937& random, std::string text,
+                    std::string_view alphabet) {
+  std::uniform_int_distribution<int> edits(0, 4);
+  for (int n = edits(random); n > 0; --n) {
+    std::uniform_int_distribution<std::size_t> where(0, text.size());
+    std::size_t position = where(random);
+    std::string c = randomText(random, 1, alphabet);
+    switch (random() % 3) {
+      case 0:
+        if (position < text.size()) text[position] = c[0];
+        break;
+      case 1:
+        if (position < text.size()) text.erase(position, 1);
+        break;
+      default:
+        text.insert(position, c);
+    }
+  }
+  return text;
+}
+
+/**
+ * @brief Strings vazias e de 1 byte, onde a janela original dá a volta.
+ */
+void shortStrings() {
+  const std::vector<std::string> texts = {"", "a", "b", "ab", "ba", "aa",
+                                          "abc"};
+  for (const std::string& a : texts) {
+    for (const std::string& b : texts) checkPair(a, b);
+  }
+  CHECK(JaroWinkler::similarity("", "") == 1.0);
+  CHECK(JaroWinkler::similarity("", "a") == 0.0);
+}
+
+/**
+ * @brief Tamanhos em volta dos limites dos bitsets de 64 e 128 bytes e do
+ * caminho com buffers.
+ */
+void sizeBoundaries() {
+  std::mt19937 random(64);
+  const std::string_view alphabet = "abcde ";
+  const std::size_t sizes[] = {31, 32, 33, 63, 64, 65, 127, 128, 129, 200};
+  for (std::size_t size1 : sizes) {
+    for (std::size_t size2 : sizes) {
+      for (int round = 0; round < 20; ++round) {
+        std::string a = randomText(random, size1, alphabet);
+        checkPair(a, randomText(random, size2, alphabet));
+        // Quase iguais, para casamentos longos e transposições
+        std::string b = mutated(random, a, alphabet);
+        b.resize(size2, 'e');
+        checkPair(a, b);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Bytes não ASCII (UTF-8 e bytes soltos acima de 0x7f), que viram
+ * índices negativos se forem tratados como char com sinal.
+ */
+void nonAscii() {
+  checkPair("ação", "acao");
+  checkPair("programação em c++", "programacao em c");
+  checkPair("\xff\xfe\x80", "\x80\xfe\xff");
+  std::mt19937 random(128);
+  const std::string_view alphabet = "a\x80\xc3\xa7\xff";
+  for (int round = 0; round < 2000; ++round) {
+    std::uniform_int_distribution<std::size_t> size(0, 140);
+    std::string a = randomText(random, size(random), alphabet);
+    checkPair(a, mutated(random, a, alphabet));
+    checkPair(a, randomText(random, size(random), alphabet));
+  }
+}
+
+/**
+ * @brief Pares aleatórios de todos os tamanhos até 300 bytes.
+ */
+void randomPairs() {
+  std::mt19937 random(2026);
+  const std::string_view alphabet = "abcdefghij ";
+  for (int round = 0; round < 20000; ++round) {
+    std::uniform_int_distribution<std::size_t> size(0, 300);
+    std::string a = randomText(random, size(random), alphabet);
+    if (round % 2) {
+      checkPair(a, mutated(random, a, alphabet));
+    } else {
+      checkPair(a, randomText(random, size(random), alphabet));
+    }
+  }
+}
+
+/**
+ * @brief similarityBatch dá o mesmo valor que similarity() para quem passa do
+ * corte (ou para todos, sem corte) e 0.0 para quem tem upperBound() abaixo
+ * dele.
+ */
+void batchWithCutoff() {
+  std::mt19937 random(7);
+  const std::string_view alphabet = "abcdef ";
+  const std::string query = "abc def";
+  std::vector<std::string> texts = {"", "a", "abc def", "abc", "fed cba"};
+  for (int i = 0; i < 500; ++i) {
+    std::uniform_int_distribution<std::size_t> size(1, 90);
+    texts.push_back(randomText(random, size(random), alphabet));
+  }
+  std::vector<std::string_view> candidates(texts.begin(), texts.end());
+  std::vector<double> scores(candidates.size());
+
+  JaroWinkler::similarityBatch(query, candidates, scores);
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    CHECK(scores[i] == JaroWinkler::similarity(query, candidates[i]));
+  }
+
+  const double cutoff = 0.67;
+  JaroWinkler::similarityBatch(query, candidates, scores, cutoff);
+  std::size_t pruned = 0;
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    if (JaroWinkler::upperBound(query, candidates[i]) <= cutoff) {
+      CHECK(scores[i] == 0.0);
+      ++pruned;
+    } else {
+      CHECK(scores[i] == JaroWinkler::similarity(query, candidates[i]));
+    }
+  }
+  CHECK(pruned > 0 && pruned < candidates.size());
+}
+
+}  // namespace
+
+int main() {
+  shortStrings();
+  sizeBoundaries();
+  nonAscii();
+  randomPairs();
+  batchWithCutoff();
+  if (failures == 0) std::cout << "OK" << std::endl;
+  return failures == 0 ? 0 : 1;
+}